@@ -388,12 +388,258 @@ static RectangleInfo GetEdgeBoundingBox(const Image *image,
   return(bounds);
 }
 
+static inline MagickBooleanType IsBoundingBoxBackground(const Image *image,
+  const Quantum *magick_restrict p,const PixelInfo *magick_restrict target)
+{
+  PixelInfo
+    pixel;
+
+  /*
+    An exact match is always fuzzy equivalent, so skip the distance metric.
+  */
+  if (((double) GetPixelRed(image,p) == target->red) &&
+      ((double) GetPixelGreen(image,p) == target->green) &&
+      ((double) GetPixelBlue(image,p) == target->blue) &&
+      ((double) GetPixelBlack(image,p) == target->black) &&
+      ((double) GetPixelAlpha(image,p) == target->alpha))
+    return(MagickTrue);
+  GetPixelInfoPixel(image,p,&pixel);
+  return(IsFuzzyEquivalencePixelInfo(&pixel,target));
+}
+
+static inline ssize_t GetBoundingBoxEdge(const Image *image,
+  const Quantum *magick_restrict pixels,const ssize_t start,const ssize_t end,
+  const PixelInfo *magick_restrict target)
+{
+  const Quantum
+    *magick_restrict p;
+
+  ssize_t
+    x;
+
+  /*
+    Return the first column from start towards end (exclusive) that is not
+    the background, or -1 if there is none.
+  */
+  p=pixels+start*(ssize_t) GetPixelChannels(image);
+  if (start <= end)
+    {
+      for (x=start; x < end; x++)
+      {
+        if (IsBoundingBoxBackground(image,p,target) == MagickFalse)
+          return(x);
+        p+=(ptrdiff_t) GetPixelChannels(image);
+      }
+      return(-1);
+    }
+  for (x=start; x > end; x--)
+  {
+    if (IsBoundingBoxBackground(image,p,target) == MagickFalse)
+      return(x);
+    p-=(ptrdiff_t) GetPixelChannels(image);
+  }
+  return(-1);
+}
+
+static inline MagickBooleanType IsBoundingBoxTarget(const PixelInfo *p,
+  const PixelInfo *q)
+{
+  if ((p->red == q->red) && (p->green == q->green) && (p->blue == q->blue) &&
+      (p->black == q->black) && (p->alpha == q->alpha))
+    return(MagickTrue);
+  return(MagickFalse);
+}
+
+static MagickBooleanType GetEdgeInwardBoundingBox(const Image *image,
+  CacheView *image_view,const PixelInfo *target,RectangleInfo *bounds,
+  ExceptionInfo *exception)
+{
+  MagickBooleanType
+    status;
+
+  ssize_t
+    rows,
+    y;
+
+  /*
+    Search down from the top edge for the first row that differs from the
+    north-west corner.  Rows above it need not be visited again.
+  */
+  status=MagickTrue;
+  rows=bounds->y;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(static) shared(bounds,status) \
+    magick_number_threads(image,image,(size_t) rows,2)
+#endif
+  for (y=0; y < rows; y++)
+  {
+    const Quantum
+      *magick_restrict p;
+
+    ssize_t
+      top,
+      x;
+
+    if (status == MagickFalse)
+      continue;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+#  pragma omp critical (MagickCore_GetImageBoundingBox)
+#endif
+    top=bounds->y;
+    if (y >= top)
+      continue;
+    p=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
+    if (p == (const Quantum *) NULL)
+      {
+        status=MagickFalse;
+        continue;
+      }
+    x=GetBoundingBoxEdge(image,p,0,(ssize_t) image->columns,&target[0]);
+    if (x < 0)
+      continue;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+#  pragma omp critical (MagickCore_GetImageBoundingBox)
+#endif
+    {
+      if (y < bounds->y)
+        bounds->y=y;
+      if (x < bounds->x)
+        bounds->x=x;
+    }
+  }
+  /*
+    Search up from the bottom edge for the last row that differs from the
+    south-west corner.
+  */
+  rows=(ssize_t) image->rows-(ssize_t) bounds->height-1;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(static) shared(bounds,status) \
+    magick_number_threads(image,image,(size_t) MagickMax(rows,0),2)
+#endif
+  for (y=0; y < rows; y++)
+  {
+    const Quantum
+      *magick_restrict p;
+
+    ssize_t
+      bottom,
+      row;
+
+    if (status == MagickFalse)
+      continue;
+    row=(ssize_t) image->rows-y-1;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+#  pragma omp critical (MagickCore_GetImageBoundingBox)
+#endif
+    bottom=(ssize_t) bounds->height;
+    if (row <= bottom)
+      continue;
+    p=GetCacheViewVirtualPixels(image_view,0,row,image->columns,1,exception);
+    if (p == (const Quantum *) NULL)
+      {
+        status=MagickFalse;
+        continue;
+      }
+    if (GetBoundingBoxEdge(image,p,0,(ssize_t) image->columns,&target[2]) < 0)
+      continue;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+#  pragma omp critical (MagickCore_GetImageBoundingBox)
+#endif
+    if (row > (ssize_t) bounds->height)
+      bounds->height=(size_t) row;
+  }
+  if (status == MagickFalse)
+    return(status);
+  /*
+    Search the remaining rows inward from the left and right edges.
+  */
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(static) shared(bounds,status) \
+    magick_number_threads(image,image,image->rows,2)
+#endif
+  for (y=0; y < (ssize_t) image->rows; y++)
+  {
+    const Quantum
+      *magick_restrict p;
+
+    MagickBooleanType
+      left,
+      right;
+
+    RectangleInfo
+      bounding_box;
+
+    ssize_t
+      x;
+
+    if (status == MagickFalse)
+      continue;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+#  pragma omp critical (MagickCore_GetImageBoundingBox)
+#endif
+    bounding_box=(*bounds);
+    left=MagickTrue;
+    right=MagickTrue;
+    if (y < bounding_box.y)
+      {
+        left=MagickFalse;
+        if (IsBoundingBoxTarget(&target[0],&target[1]) != MagickFalse)
+          right=MagickFalse;
+      }
+    if (y > (ssize_t) bounding_box.height)
+      {
+        if (IsBoundingBoxTarget(&target[2],&target[0]) != MagickFalse)
+          left=MagickFalse;
+        if (IsBoundingBoxTarget(&target[2],&target[1]) != MagickFalse)
+          right=MagickFalse;
+      }
+    if (bounding_box.x <= 0)
+      left=MagickFalse;
+    if ((ssize_t) bounding_box.width >= ((ssize_t) image->columns-1))
+      right=MagickFalse;
+    if ((left == MagickFalse) && (right == MagickFalse))
+      continue;
+    p=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
+    if (p == (const Quantum *) NULL)
+      {
+        status=MagickFalse;
+        continue;
+      }
+    if (left != MagickFalse)
+      {
+        x=GetBoundingBoxEdge(image,p,0,bounding_box.x,&target[0]);
+        if (x >= 0)
+          bounding_box.x=x;
+      }
+    if (right != MagickFalse)
+      {
+        x=GetBoundingBoxEdge(image,p,(ssize_t) image->columns-1,(ssize_t)
+          bounding_box.width,&target[1]);
+        if (x >= 0)
+          bounding_box.width=(size_t) x;
+      }
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+#  pragma omp critical (MagickCore_GetImageBoundingBox)
+#endif
+    {
+      if (bounding_box.x < bounds->x)
+        bounds->x=bounding_box.x;
+      if (bounding_box.width > bounds->width)
+        bounds->width=bounding_box.width;
+    }
+  }
+  return(status);
+}
+
 MagickExport RectangleInfo GetImageBoundingBox(const Image *image,
   ExceptionInfo *exception)
 {
   CacheView
     *image_view;
 
+  char
+    key[MagickPathExtent];
+
   const char
     *artifact;
 
@@ -421,6 +667,16 @@ MagickExport RectangleInfo GetImageBoundingBox(const Image *image,
   if (artifact != (const char *) NULL)
     return(GetEdgeBoundingBox(image,exception));
   artifact=GetImageArtifact(image,"trim:edges");
+  (void) FormatLocaleString(key,MagickPathExtent,
+    "attribute:bounding-box:%.20g:%s",image->fuzz,artifact ==
+    (const char *) NULL ? "" : artifact);
+  if (GetPixelCacheMemo(image,key,&bounds,sizeof(bounds)) != MagickFalse)
+    {
+      if ((bounds.width == 0) || (bounds.height == 0))
+        (void) ThrowMagickException(exception,GetMagickModule(),OptionWarning,
+          "GeometryDoesNotContainImage","`%s'",image->filename);
+      return(bounds);
+    }
   if (artifact == (const char *) NULL)
     {
       bounds.width=(size_t) (image->columns == 1 ? 1 : 0);
@@ -478,77 +734,86 @@ MagickExport RectangleInfo GetImageBoundingBox(const Image *image,
     image->rows-1,1,1,exception);
   if (p != (const Quantum *) NULL)
     GetPixelInfoPixel(image,p,&target[3]);
-  status=MagickTrue;
-  GetPixelInfo(image,&zero);
+  if (IsBoundingBoxTarget(&target[2],&target[3]) != MagickFalse)
+    status=GetEdgeInwardBoundingBox(image,image_view,target,&bounds,exception);
+  else
+    {
+      /*
+        The south-east corner differs from the south-west one, visit every
+        pixel.
+      */
+      status=MagickTrue;
+      GetPixelInfo(image,&zero);
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
-  #pragma omp parallel for schedule(static) shared(status) \
-    magick_number_threads(image,image,image->rows,2)
+      #pragma omp parallel for schedule(static) shared(status) \
+        magick_number_threads(image,image,image->rows,2)
 #endif
-  for (y=0; y < (ssize_t) image->rows; y++)
-  {
-    const Quantum
-      *magick_restrict q;
+      for (y=0; y < (ssize_t) image->rows; y++)
+      {
+        const Quantum
+          *magick_restrict q;
 
-    PixelInfo
-      pixel;
+        PixelInfo
+          pixel;
 
-    RectangleInfo
-      bounding_box;
+        RectangleInfo
+          bounding_box;
 
-    ssize_t
-      x;
+        ssize_t
+          x;
 
-    if (status == MagickFalse)
-      continue;
+        if (status == MagickFalse)
+          continue;
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
 #  pragma omp critical (MagickCore_GetImageBoundingBox)
 #endif
-    bounding_box=bounds;
-    q=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
-    if (q == (const Quantum *) NULL)
-      {
-        status=MagickFalse;
-        continue;
-      }
-    pixel=zero;
-    for (x=0; x < (ssize_t) image->columns; x++)
-    {
-      GetPixelInfoPixel(image,q,&pixel);
-      if ((x < bounding_box.x) &&
-          (IsFuzzyEquivalencePixelInfo(&pixel,&target[0]) == MagickFalse))
-        bounding_box.x=x;
-      if ((x > (ssize_t) bounding_box.width) &&
-          (IsFuzzyEquivalencePixelInfo(&pixel,&target[1]) == MagickFalse))
-        bounding_box.width=(size_t) x;
-      if ((y < bounding_box.y) &&
-          (IsFuzzyEquivalencePixelInfo(&pixel,&target[0]) == MagickFalse))
-        bounding_box.y=y;
-      if ((y > (ssize_t) bounding_box.height) &&
-          (IsFuzzyEquivalencePixelInfo(&pixel,&target[2]) == MagickFalse))
-        bounding_box.height=(size_t) y;
-      if ((x < (ssize_t) bounding_box.width) &&
-          (y > (ssize_t) bounding_box.height) &&
-          (IsFuzzyEquivalencePixelInfo(&pixel,&target[3]) == MagickFalse))
+        bounding_box=bounds;
+        q=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
+        if (q == (const Quantum *) NULL)
+          {
+            status=MagickFalse;
+            continue;
+          }
+        pixel=zero;
+        for (x=0; x < (ssize_t) image->columns; x++)
         {
-          bounding_box.width=(size_t) x;
-          bounding_box.height=(size_t) y;
+          GetPixelInfoPixel(image,q,&pixel);
+          if ((x < bounding_box.x) &&
+              (IsFuzzyEquivalencePixelInfo(&pixel,&target[0]) == MagickFalse))
+            bounding_box.x=x;
+          if ((x > (ssize_t) bounding_box.width) &&
+              (IsFuzzyEquivalencePixelInfo(&pixel,&target[1]) == MagickFalse))
+            bounding_box.width=(size_t) x;
+          if ((y < bounding_box.y) &&
+              (IsFuzzyEquivalencePixelInfo(&pixel,&target[0]) == MagickFalse))
+            bounding_box.y=y;
+          if ((y > (ssize_t) bounding_box.height) &&
+              (IsFuzzyEquivalencePixelInfo(&pixel,&target[2]) == MagickFalse))
+            bounding_box.height=(size_t) y;
+          if ((x < (ssize_t) bounding_box.width) &&
+              (y > (ssize_t) bounding_box.height) &&
+              (IsFuzzyEquivalencePixelInfo(&pixel,&target[3]) == MagickFalse))
+            {
+              bounding_box.width=(size_t) x;
+              bounding_box.height=(size_t) y;
+            }
+          q+=(ptrdiff_t) GetPixelChannels(image);
         }
-      q+=(ptrdiff_t) GetPixelChannels(image);
-    }
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
 #  pragma omp critical (MagickCore_GetImageBoundingBox)
 #endif
-    {
-      if (bounding_box.x < bounds.x)
-        bounds.x=bounding_box.x;
-      if (bounding_box.y < bounds.y)
-        bounds.y=bounding_box.y;
-      if (bounding_box.width > bounds.width)
-        bounds.width=bounding_box.width;
-      if (bounding_box.height > bounds.height)
-        bounds.height=bounding_box.height;
+        {
+          if (bounding_box.x < bounds.x)
+            bounds.x=bounding_box.x;
+          if (bounding_box.y < bounds.y)
+            bounds.y=bounding_box.y;
+          if (bounding_box.width > bounds.width)
+            bounds.width=bounding_box.width;
+          if (bounding_box.height > bounds.height)
+            bounds.height=bounding_box.height;
+        }
+      }
     }
-  }
   image_view=DestroyCacheView(image_view);
   if ((bounds.width == 0) || (bounds.height == 0))
     (void) ThrowMagickException(exception,GetMagickModule(),OptionWarning,
@@ -558,6 +823,8 @@ MagickExport RectangleInfo GetImageBoundingBox(const Image *image,
       bounds.width-=(size_t) (bounds.x-1);
       bounds.height-=(size_t) (bounds.y-1);
     }
+  if (status != MagickFalse)
+    (void) SetPixelCacheMemo(image,key,&bounds,sizeof(bounds));
   return(bounds);
 }
 
@@ -1571,6 +1838,8 @@ MagickExport ImageType IdentifyImageGray(const Image *image,
     type = BilevelType;
 
   MagickBooleanType
+    gray = MagickTrue,
+    monochrome,
     status = MagickTrue;
 
   ssize_t
@@ -1584,9 +1853,15 @@ MagickExport ImageType IdentifyImageGray(const Image *image,
     return(image->type);
   if (IssRGBCompatibleColorspace(image->colorspace) == MagickFalse)
     return(UndefinedType);
+  if (GetPixelCacheMemo(image,"attribute:gray",&type,sizeof(type)) !=
+      MagickFalse)
+    return(type);
+  if ((GetPixelCacheMemo(image,"attribute:monochrome",&monochrome,
+       sizeof(monochrome)) != MagickFalse) && (monochrome != MagickFalse))
+    return(BilevelType);
   image_view=AcquireVirtualCacheView(image,exception);
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
-  #pragma omp parallel for schedule(static) shared(status,type) \
+  #pragma omp parallel for schedule(static) shared(gray,status,type) \
     magick_number_threads(image,image,image->rows,2)
 #endif
   for (y=0; y < (ssize_t) image->rows; y++)
@@ -1597,7 +1872,7 @@ MagickExport ImageType IdentifyImageGray(const Image *image,
     ssize_t
       x;
 
-    if (status == MagickFalse)
+    if ((status == MagickFalse) || (gray == MagickFalse))
       continue;
     p=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
     if (p == (const Quantum *) NULL)
@@ -1605,23 +1880,38 @@ MagickExport ImageType IdentifyImageGray(const Image *image,
         status=MagickFalse;
         continue;
       }
-    for (x=0; x < (ssize_t) image->columns; x++)
+    x=0;
+    if (type == BilevelType)
+      for ( ; x < (ssize_t) image->columns; x++)
+      {
+        if (IsPixelMonochrome(image,p) == MagickFalse)
+          {
+            type=GrayscaleType;
+            break;
+          }
+        p+=(ptrdiff_t) GetPixelChannels(image);
+      }
+    for ( ; x < (ssize_t) image->columns; x++)
     {
       if (IsPixelGray(image,p) == MagickFalse)
         {
-          status=MagickFalse;
+          gray=MagickFalse;
           break;
         }
-      if ((type == BilevelType) && (IsPixelMonochrome(image,p) == MagickFalse))
-        type=GrayscaleType;
       p+=(ptrdiff_t) GetPixelChannels(image);
     }
   }
   image_view=DestroyCacheView(image_view);
-  if ((type == GrayscaleType) && (image->alpha_trait != UndefinedPixelTrait))
-    type=GrayscaleAlphaType;
   if (status == MagickFalse)
     return(UndefinedType);
+  if (gray == MagickFalse)
+    type=UndefinedType;
+  if ((type == GrayscaleType) && (image->alpha_trait != UndefinedPixelTrait))
+    type=GrayscaleAlphaType;
+  monochrome=type == BilevelType ? MagickTrue : MagickFalse;
+  (void) SetPixelCacheMemo(image,"attribute:gray",&type,sizeof(type));
+  (void) SetPixelCacheMemo(image,"attribute:monochrome",&monochrome,
+    sizeof(monochrome));
   return(type);
 }
 
@@ -1659,7 +1949,11 @@ MagickExport MagickBooleanType IdentifyImageMonochrome(const Image *image,
     *image_view;
 
   ImageType
-    type = BilevelType;
+    type;
+
+  MagickBooleanType
+    monochrome = MagickTrue,
+    status = MagickTrue;
 
   ssize_t
     y;
@@ -1672,9 +1966,12 @@ MagickExport MagickBooleanType IdentifyImageMonochrome(const Image *image,
     return(MagickTrue);
   if (IssRGBCompatibleColorspace(image->colorspace) == MagickFalse)
     return(MagickFalse);
+  if (GetPixelCacheMemo(image,"attribute:monochrome",&monochrome,
+        sizeof(monochrome)) != MagickFalse)
+    return(monochrome);
   image_view=AcquireVirtualCacheView(image,exception);
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
-  #pragma omp parallel for schedule(static) shared(type) \
+  #pragma omp parallel for schedule(static) shared(monochrome,status) \
     magick_number_threads(image,image,image->rows,2)
 #endif
   for (y=0; y < (ssize_t) image->rows; y++)
@@ -1685,26 +1982,35 @@ MagickExport MagickBooleanType IdentifyImageMonochrome(const Image *image,
     ssize_t
       x;
 
-    if (type == UndefinedType)
+    if ((status == MagickFalse) || (monochrome == MagickFalse))
       continue;
     p=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
     if (p == (const Quantum *) NULL)
       {
-        type=UndefinedType;
+        status=MagickFalse;
         continue;
       }
     for (x=0; x < (ssize_t) image->columns; x++)
     {
       if (IsPixelMonochrome(image,p) == MagickFalse)
         {
-          type=UndefinedType;
+          monochrome=MagickFalse;
           break;
         }
       p+=(ptrdiff_t) GetPixelChannels(image);
     }
   }
   image_view=DestroyCacheView(image_view);
-  return(type == BilevelType ? MagickTrue : MagickFalse);
+  if (status == MagickFalse)
+    return(MagickFalse);
+  (void) SetPixelCacheMemo(image,"attribute:monochrome",&monochrome,
+    sizeof(monochrome));
+  if (monochrome != MagickFalse)
+    {
+      type=BilevelType;
+      (void) SetPixelCacheMemo(image,"attribute:gray",&type,sizeof(type));
+    }
+  return(monochrome);
 }
 
 /*
@@ -1867,9 +2173,11 @@ MagickExport MagickBooleanType IsImageOpaque(const Image *image,
     *image_view;
 
   MagickBooleanType
-    opaque = MagickTrue;
+    opaque = MagickTrue,
+    status = MagickTrue;
 
   ssize_t
+    offset,
     y;
 
   /*
@@ -1881,9 +2189,15 @@ MagickExport MagickBooleanType IsImageOpaque(const Image *image,
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",image->filename);
   if ((image->alpha_trait & BlendPixelTrait) == 0)
     return(MagickTrue);
+  if (image->channel_map[AlphaPixelChannel].traits == UndefinedPixelTrait)
+    return(MagickTrue);
+  if (GetPixelCacheMemo(image,"attribute:opaque",&opaque,sizeof(opaque)) !=
+      MagickFalse)
+    return(opaque);
+  offset=image->channel_map[AlphaPixelChannel].offset;
   image_view=AcquireVirtualCacheView(image,exception);
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
-  #pragma omp parallel for schedule(static) shared(opaque) \
+  #pragma omp parallel for schedule(static) shared(opaque,status) \
     magick_number_threads(image,image,image->rows,2)
 #endif
   for (y=0; y < (ssize_t) image->rows; y++)
@@ -1894,17 +2208,17 @@ MagickExport MagickBooleanType IsImageOpaque(const Image *image,
     ssize_t
       x;
 
-    if (opaque == MagickFalse)
+    if ((status == MagickFalse) || (opaque == MagickFalse))
       continue;
     p=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
     if (p == (const Quantum *) NULL)
       {
-        opaque=MagickFalse;
+        status=MagickFalse;
         continue;
       }
     for (x=0; x < (ssize_t) image->columns; x++)
     {
-      if (GetPixelAlpha(image,p) != OpaqueAlpha)
+      if (p[offset] != OpaqueAlpha)
         {
           opaque=MagickFalse;
           break;
@@ -1913,6 +2227,9 @@ MagickExport MagickBooleanType IsImageOpaque(const Image *image,
     }
   }
   image_view=DestroyCacheView(image_view);
+  if (status == MagickFalse)
+    return(MagickFalse);
+  (void) SetPixelCacheMemo(image,"attribute:opaque",&opaque,sizeof(opaque));
   return(opaque);
 }
 
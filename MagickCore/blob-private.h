@@ -92,6 +92,9 @@ extern MagickExport MagickBooleanType
   SetBlobExtent(Image *,const MagickSizeType),
   UnmapBlob(void *,const size_t);
 
+extern MagickPrivate MagickBooleanType
+  IsBlobCompressed(const Image *) magick_attribute((__pure__));
+
 extern MagickExport MagickOffsetType
   SeekBlob(Image *,const MagickOffsetType,const int),
   TellBlob(const Image *);
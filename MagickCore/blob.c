@@ -68,6 +68,7 @@
 #include "MagickCore/semaphore.h"
 #include "MagickCore/string_.h"
 #include "MagickCore/string-private.h"
+#include "MagickCore/thread-private.h"
 #include "MagickCore/timer-private.h"
 #include "MagickCore/token.h"
 #include "MagickCore/utility.h"
@@ -83,6 +84,9 @@
   Define declarations.
 */
 #define MagickMaxBlobExtent  (8*8192)
+#define MagickMaxReaderBuffers  4
+#define MagickZipBlockExtent  (128*1024)
+#define MagickZipWindowExtent  (32*1024)
 #if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
 # define MAP_ANONYMOUS  MAP_ANON
 #endif
@@ -132,6 +136,72 @@ typedef union FileInfo
 #endif
 } FileInfo;
 
+typedef struct _BlobReaderInfo
+{
+  StreamType
+    type;
+
+  FileInfo
+    file_info;
+
+  unsigned char
+    *buffers[MagickMaxReaderBuffers],
+    *data;
+
+  ssize_t
+    lengths[MagickMaxReaderBuffers],
+    length;
+
+  size_t
+    head,
+    count,
+    offset;
+
+  MagickOffsetType
+    position;
+
+  MagickBooleanType
+    eof,
+    terminate;
+
+  int
+    status;
+
+#if defined(MAGICKCORE_THREAD_SUPPORT)
+  pthread_t
+    thread;
+
+  pthread_mutex_t
+    mutex;
+
+  pthread_cond_t
+    consumed,
+    produced;
+#endif
+} BlobReaderInfo;
+
+typedef struct _BlobCompressorInfo
+{
+  unsigned char
+    *data,
+    *dictionary,
+    **blocks;
+
+  size_t
+    number_blocks,
+    length,
+    extent,
+    dictionary_length,
+    *block_lengths;
+
+  unsigned long
+    crc,
+    *block_crcs;
+
+  MagickSizeType
+    size;
+} BlobCompressorInfo;
+
 struct _BlobInfo
 {
   size_t
@@ -170,6 +240,12 @@ struct _BlobInfo
   FileInfo
     file_info;
 
+  BlobReaderInfo
+    *reader;
+
+  BlobCompressorInfo
+    *compressor;
+
   struct stat
     properties;
 
@@ -219,6 +295,488 @@ struct _CustomStreamInfo
 */
 static int
   SyncBlob(const Image *);
+
+#if defined(MAGICKCORE_ZLIB_DELEGATE)
+/*
+  Deflate blocks of a gzip stream in parallel.  Each block is primed with the
+  trailing window of its predecessor and ends on a byte boundary with a sync
+  flush, so the concatenated blocks form one standard gzip member.
+*/
+static BlobCompressorInfo *DestroyBlobCompressor(
+  BlobCompressorInfo *compressor)
+{
+  ssize_t
+    i;
+
+  if (compressor->blocks != (unsigned char **) NULL)
+    {
+      for (i=0; i < (ssize_t) compressor->number_blocks; i++)
+        if (compressor->blocks[i] != (unsigned char *) NULL)
+          compressor->blocks[i]=(unsigned char *)
+            RelinquishMagickMemory(compressor->blocks[i]);
+      compressor->blocks=(unsigned char **) RelinquishMagickMemory(
+        compressor->blocks);
+    }
+  if (compressor->block_crcs != (unsigned long *) NULL)
+    compressor->block_crcs=(unsigned long *) RelinquishMagickMemory(
+      compressor->block_crcs);
+  if (compressor->block_lengths != (size_t *) NULL)
+    compressor->block_lengths=(size_t *) RelinquishMagickMemory(
+      compressor->block_lengths);
+  if (compressor->dictionary != (unsigned char *) NULL)
+    compressor->dictionary=(unsigned char *) RelinquishMagickMemory(
+      compressor->dictionary);
+  if (compressor->data != (unsigned char *) NULL)
+    compressor->data=(unsigned char *) RelinquishMagickMemory(
+      compressor->data);
+  compressor=(BlobCompressorInfo *) RelinquishMagickMemory(compressor);
+  return(compressor);
+}
+
+static BlobCompressorInfo *AcquireBlobCompressor(const size_t number_threads)
+{
+  BlobCompressorInfo
+    *compressor;
+
+  ssize_t
+    i;
+
+  compressor=(BlobCompressorInfo *) AcquireMagickMemory(sizeof(*compressor));
+  if (compressor == (BlobCompressorInfo *) NULL)
+    return(compressor);
+  (void) memset(compressor,0,sizeof(*compressor));
+  compressor->number_blocks=number_threads;
+  compressor->extent=(size_t) compressBound(MagickZipBlockExtent)+16;
+  compressor->crc=crc32(0L,Z_NULL,0);
+  compressor->data=(unsigned char *) AcquireQuantumMemory(number_threads,
+    MagickZipBlockExtent*sizeof(*compressor->data));
+  compressor->dictionary=(unsigned char *) AcquireQuantumMemory(
+    MagickZipWindowExtent,sizeof(*compressor->dictionary));
+  compressor->blocks=(unsigned char **) AcquireQuantumMemory(number_threads,
+    sizeof(*compressor->blocks));
+  compressor->block_crcs=(unsigned long *) AcquireQuantumMemory(
+    number_threads,sizeof(*compressor->block_crcs));
+  compressor->block_lengths=(size_t *) AcquireQuantumMemory(number_threads,
+    sizeof(*compressor->block_lengths));
+  if ((compressor->data == (unsigned char *) NULL) ||
+      (compressor->dictionary == (unsigned char *) NULL) ||
+      (compressor->blocks == (unsigned char **) NULL) ||
+      (compressor->block_crcs == (unsigned long *) NULL) ||
+      (compressor->block_lengths == (size_t *) NULL))
+    return(DestroyBlobCompressor(compressor));
+  (void) memset(compressor->blocks,0,number_threads*
+    sizeof(*compressor->blocks));
+  for (i=0; i < (ssize_t) number_threads; i++)
+  {
+    compressor->blocks[i]=(unsigned char *) AcquireQuantumMemory(
+      compressor->extent,sizeof(**compressor->blocks));
+    if (compressor->blocks[i] == (unsigned char *) NULL)
+      return(DestroyBlobCompressor(compressor));
+  }
+  return(compressor);
+}
+
+static MagickBooleanType FlushBlobCompressor(BlobInfo *blob_info,
+  const MagickBooleanType finish)
+{
+  BlobCompressorInfo
+    *compressor;
+
+  MagickBooleanType
+    status;
+
+  size_t
+    number_blocks;
+
+  ssize_t
+    i;
+
+  compressor=blob_info->compressor;
+  number_blocks=(compressor->length+MagickZipBlockExtent-1)/
+    MagickZipBlockExtent;
+  if ((number_blocks == 0) && (finish != MagickFalse))
+    number_blocks=1;
+  if (number_blocks == 0)
+    return(MagickTrue);
+  status=MagickTrue;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(static) shared(status) \
+    num_threads((int) number_blocks)
+#endif
+  for (i=0; i < (ssize_t) number_blocks; i++)
+  {
+    const unsigned char
+      *dictionary;
+
+    int
+      code;
+
+    size_t
+      dictionary_length,
+      extent,
+      offset;
+
+    z_stream
+      stream;
+
+    offset=(size_t) i*MagickZipBlockExtent;
+    extent=MagickMin(compressor->length-offset,MagickZipBlockExtent);
+    if (i == 0)
+      {
+        dictionary=compressor->dictionary;
+        dictionary_length=compressor->dictionary_length;
+      }
+    else
+      {
+        dictionary_length=MagickMin(offset,MagickZipWindowExtent);
+        dictionary=compressor->data+offset-dictionary_length;
+      }
+    compressor->block_lengths[i]=0;
+    compressor->block_crcs[i]=crc32(crc32(0L,Z_NULL,0),compressor->data+
+      offset,(uInt) extent);
+    (void) memset(&stream,0,sizeof(stream));
+    code=deflateInit2(&stream,Z_DEFAULT_COMPRESSION,Z_DEFLATED,-MAX_WBITS,8,
+      Z_DEFAULT_STRATEGY);
+    if (code != Z_OK)
+      {
+        status=MagickFalse;
+        continue;
+      }
+    if (dictionary_length != 0)
+      (void) deflateSetDictionary(&stream,dictionary,(uInt)
+        dictionary_length);
+    stream.next_in=compressor->data+offset;
+    stream.avail_in=(uInt) extent;
+    stream.next_out=compressor->blocks[i];
+    stream.avail_out=(uInt) compressor->extent;
+    code=deflate(&stream,((finish != MagickFalse) &&
+      (i == (ssize_t) number_blocks-1)) ? Z_FINISH : Z_SYNC_FLUSH);
+    if (((code != Z_OK) && (code != Z_STREAM_END)) || (stream.avail_in != 0))
+      status=MagickFalse;
+    compressor->block_lengths[i]=compressor->extent-stream.avail_out;
+    (void) deflateEnd(&stream);
+  }
+  for (i=0; i < (ssize_t) number_blocks; i++)
+  {
+    size_t
+      extent;
+
+    extent=MagickMin(compressor->length-(size_t) i*MagickZipBlockExtent,
+      MagickZipBlockExtent);
+    if (fwrite(compressor->blocks[i],1,compressor->block_lengths[i],
+          blob_info->file_info.file) != compressor->block_lengths[i])
+      status=MagickFalse;
+    compressor->crc=crc32_combine(compressor->crc,compressor->block_crcs[i],
+      (z_off_t) extent);
+  }
+  /*
+    Retain the trailing window to prime the next block.
+  */
+  if (compressor->length >= MagickZipWindowExtent)
+    {
+      (void) memcpy(compressor->dictionary,compressor->data+
+        compressor->length-MagickZipWindowExtent,MagickZipWindowExtent);
+      compressor->dictionary_length=MagickZipWindowExtent;
+    }
+  else
+    {
+      size_t
+        keep;
+
+      keep=MagickMin(compressor->dictionary_length,MagickZipWindowExtent-
+        compressor->length);
+      (void) memmove(compressor->dictionary,compressor->dictionary+
+        compressor->dictionary_length-keep,keep);
+      (void) memcpy(compressor->dictionary+keep,compressor->data,
+        compressor->length);
+      compressor->dictionary_length=keep+compressor->length;
+    }
+  compressor->length=0;
+  return(status);
+}
+
+static MagickBooleanType CloseBlobCompressor(BlobInfo *blob_info)
+{
+  BlobCompressorInfo
+    *compressor;
+
+  MagickBooleanType
+    status;
+
+  ssize_t
+    i;
+
+  unsigned char
+    trailer[8];
+
+  /*
+    Write the final block and the gzip trailer.
+  */
+  compressor=blob_info->compressor;
+  status=FlushBlobCompressor(blob_info,MagickTrue);
+  for (i=0; i < 4; i++)
+  {
+    trailer[i]=(unsigned char) (compressor->crc >> (8*i));
+    trailer[i+4]=(unsigned char) (compressor->size >> (8*i));
+  }
+  if (fwrite(trailer,1,sizeof(trailer),blob_info->file_info.file) !=
+      sizeof(trailer))
+    status=MagickFalse;
+  return(status);
+}
+
+static MagickBooleanType OpenBlobCompressor(BlobInfo *blob_info,
+  const char *filename)
+{
+  static const unsigned char
+    header[10] = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x03 };
+
+  blob_info->compressor=AcquireBlobCompressor((size_t) MagickMin(
+    GetMagickResourceLimit(ThreadResource),64));
+  if (blob_info->compressor == (BlobCompressorInfo *) NULL)
+    return(MagickFalse);
+  blob_info->file_info.file=(FILE *) fopen_utf8(filename,"wb");
+  if ((blob_info->file_info.file != (FILE *) NULL) &&
+      (fwrite(header,1,sizeof(header),blob_info->file_info.file) ==
+       sizeof(header)))
+    return(MagickTrue);
+  if (blob_info->file_info.file != (FILE *) NULL)
+    (void) fclose(blob_info->file_info.file);
+  blob_info->file_info.file=(FILE *) NULL;
+  blob_info->compressor=DestroyBlobCompressor(blob_info->compressor);
+  return(MagickFalse);
+}
+
+static ssize_t WriteBlobCompressor(BlobInfo *blob_info,const size_t length,
+  const unsigned char *data)
+{
+  BlobCompressorInfo
+    *compressor;
+
+  size_t
+    count,
+    extent;
+
+  compressor=blob_info->compressor;
+  extent=compressor->number_blocks*MagickZipBlockExtent;
+  for (count=0; count < length; )
+  {
+    size_t
+      n;
+
+    n=MagickMin(length-count,extent-compressor->length);
+    (void) memcpy(compressor->data+compressor->length,data+count,n);
+    compressor->length+=n;
+    count+=n;
+    if ((compressor->length == extent) &&
+        (FlushBlobCompressor(blob_info,MagickFalse) == MagickFalse))
+      break;
+  }
+  compressor->size+=count;
+  return((ssize_t) count);
+}
+#endif
+
+#if defined(MAGICKCORE_THREAD_SUPPORT)
+/*
+  Decompress a gzip or bzip2 stream on a background thread into a bounded
+  ring of buffers that ReadBlob() consumes.
+*/
+static void *BlobReader(void *reader_info)
+{
+  BlobReaderInfo
+    *reader;
+
+  reader=(BlobReaderInfo *) reader_info;
+  for ( ; ; )
+  {
+    size_t
+      slot;
+
+    ssize_t
+      count;
+
+    (void) pthread_mutex_lock(&reader->mutex);
+    while ((reader->count == MagickMaxReaderBuffers) &&
+           (reader->terminate == MagickFalse))
+      (void) pthread_cond_wait(&reader->consumed,&reader->mutex);
+    if (reader->terminate != MagickFalse)
+      {
+        (void) pthread_mutex_unlock(&reader->mutex);
+        break;
+      }
+    slot=(reader->head+reader->count) % MagickMaxReaderBuffers;
+    (void) pthread_mutex_unlock(&reader->mutex);
+    count=0;
+    switch (reader->type)
+    {
+      case ZipStream:
+      {
+#if defined(MAGICKCORE_ZLIB_DELEGATE)
+        count=(ssize_t) gzread(reader->file_info.gzfile,reader->buffers[slot],
+          MagickMaxBufferExtent);
+#endif
+        break;
+      }
+      case BZipStream:
+      {
+#if defined(MAGICKCORE_BZLIB_DELEGATE)
+        count=(ssize_t) BZ2_bzread(reader->file_info.bzfile,
+          reader->buffers[slot],MagickMaxBufferExtent);
+#endif
+        break;
+      }
+      default:
+        break;
+    }
+    (void) pthread_mutex_lock(&reader->mutex);
+    if (count > 0)
+      {
+        reader->lengths[slot]=count;
+        reader->count++;
+      }
+    else
+      {
+        if (count < 0)
+          reader->status=(-1);
+        reader->eof=MagickTrue;
+      }
+    (void) pthread_cond_signal(&reader->produced);
+    (void) pthread_mutex_unlock(&reader->mutex);
+    if (count <= 0)
+      break;
+  }
+  return((void *) NULL);
+}
+
+static BlobReaderInfo *DestroyBlobReader(BlobReaderInfo *reader)
+{
+  ssize_t
+    i;
+
+  (void) pthread_mutex_lock(&reader->mutex);
+  reader->terminate=MagickTrue;
+  (void) pthread_cond_signal(&reader->consumed);
+  (void) pthread_mutex_unlock(&reader->mutex);
+  (void) pthread_join(reader->thread,(void **) NULL);
+  (void) pthread_cond_destroy(&reader->produced);
+  (void) pthread_cond_destroy(&reader->consumed);
+  (void) pthread_mutex_destroy(&reader->mutex);
+  for (i=0; i < MagickMaxReaderBuffers; i++)
+    if (reader->buffers[i] != (unsigned char *) NULL)
+      reader->buffers[i]=(unsigned char *) RelinquishMagickMemory(
+        reader->buffers[i]);
+  reader=(BlobReaderInfo *) RelinquishMagickMemory(reader);
+  return(reader);
+}
+
+static BlobReaderInfo *AcquireBlobReader(const BlobInfo *blob_info)
+{
+  BlobReaderInfo
+    *reader;
+
+  ssize_t
+    i;
+
+  reader=(BlobReaderInfo *) AcquireMagickMemory(sizeof(*reader));
+  if (reader == (BlobReaderInfo *) NULL)
+    return(reader);
+  (void) memset(reader,0,sizeof(*reader));
+  reader->type=blob_info->type;
+  reader->file_info=blob_info->file_info;
+#if defined(MAGICKCORE_ZLIB_DELEGATE)
+  if (reader->type == ZipStream)
+    reader->position=(MagickOffsetType) gztell(reader->file_info.gzfile);
+#endif
+  for (i=0; i < MagickMaxReaderBuffers; i++)
+  {
+    reader->buffers[i]=(unsigned char *) AcquireQuantumMemory(
+      MagickMaxBufferExtent,sizeof(**reader->buffers));
+    if (reader->buffers[i] == (unsigned char *) NULL)
+      break;
+  }
+  if ((i < MagickMaxReaderBuffers) ||
+      (pthread_mutex_init(&reader->mutex,(const pthread_mutexattr_t *)
+         NULL) != 0))
+    {
+      for (i=0; i < MagickMaxReaderBuffers; i++)
+        if (reader->buffers[i] != (unsigned char *) NULL)
+          reader->buffers[i]=(unsigned char *) RelinquishMagickMemory(
+            reader->buffers[i]);
+      reader=(BlobReaderInfo *) RelinquishMagickMemory(reader);
+      return(reader);
+    }
+  (void) pthread_cond_init(&reader->consumed,(const pthread_condattr_t *)
+    NULL);
+  (void) pthread_cond_init(&reader->produced,(const pthread_condattr_t *)
+    NULL);
+  if (pthread_create(&reader->thread,(const pthread_attr_t *) NULL,
+        BlobReader,reader) != 0)
+    {
+      /*
+        Fall back to reading on the caller's thread.
+      */
+      reader->terminate=MagickTrue;
+      (void) pthread_cond_destroy(&reader->produced);
+      (void) pthread_cond_destroy(&reader->consumed);
+      (void) pthread_mutex_destroy(&reader->mutex);
+      for (i=0; i < MagickMaxReaderBuffers; i++)
+        reader->buffers[i]=(unsigned char *) RelinquishMagickMemory(
+          reader->buffers[i]);
+      reader=(BlobReaderInfo *) RelinquishMagickMemory(reader);
+    }
+  return(reader);
+}
+
+static ssize_t ReadBlobReader(BlobReaderInfo *reader,const size_t length,
+  unsigned char *data)
+{
+  size_t
+    count;
+
+  for (count=0; count < length; )
+  {
+    size_t
+      n;
+
+    if (reader->data == (unsigned char *) NULL)
+      {
+        (void) pthread_mutex_lock(&reader->mutex);
+        while ((reader->count == 0) && (reader->eof == MagickFalse))
+          (void) pthread_cond_wait(&reader->produced,&reader->mutex);
+        if (reader->count != 0)
+          {
+            reader->data=reader->buffers[reader->head];
+            reader->length=reader->lengths[reader->head];
+            reader->offset=0;
+          }
+        (void) pthread_mutex_unlock(&reader->mutex);
+        if (reader->data == (unsigned char *) NULL)
+          break;
+      }
+    n=MagickMin(length-count,(size_t) reader->length-reader->offset);
+    if (data != (unsigned char *) NULL)
+      (void) memcpy(data+count,reader->data+reader->offset,n);
+    reader->offset+=n;
+    count+=n;
+    if (reader->offset == (size_t) reader->length)
+      {
+        /*
+          Return the drained buffer to the background thread.
+        */
+        (void) pthread_mutex_lock(&reader->mutex);
+        reader->data=(unsigned char *) NULL;
+        reader->head=(reader->head+1) % MagickMaxReaderBuffers;
+        reader->count--;
+        (void) pthread_cond_signal(&reader->consumed);
+        (void) pthread_mutex_unlock(&reader->mutex);
+      }
+  }
+  reader->position+=(MagickOffsetType) count;
+  return((ssize_t) count);
+}
+#endif
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -637,6 +1195,14 @@ MagickExport MagickBooleanType CloseBlob(Image *image)
   blob_info=image->blob;
   if ((blob_info == (BlobInfo *) NULL) || (blob_info->type == UndefinedStream))
     return(MagickTrue);
+#if defined(MAGICKCORE_THREAD_SUPPORT)
+  if (blob_info->reader != (BlobReaderInfo *) NULL)
+    {
+      if (blob_info->reader->status != 0)
+        ThrowBlobException(blob_info);
+      blob_info->reader=DestroyBlobReader(blob_info->reader);
+    }
+#endif
   (void) SyncBlob(image);
   status=blob_info->status;
   switch (blob_info->type)
@@ -663,6 +1229,12 @@ MagickExport MagickBooleanType CloseBlob(Image *image)
     case ZipStream:
     {
 #if defined(MAGICKCORE_ZLIB_DELEGATE)
+      if (blob_info->compressor != (BlobCompressorInfo *) NULL)
+        {
+          if (CloseBlobCompressor(blob_info) == MagickFalse)
+            ThrowBlobException(blob_info);
+          break;
+        }
       status=Z_OK;
       (void) gzerror(blob_info->file_info.gzfile,&status);
       if (status != Z_OK)
@@ -740,7 +1312,13 @@ MagickExport MagickBooleanType CloseBlob(Image *image)
     case ZipStream:
     {
 #if defined(MAGICKCORE_ZLIB_DELEGATE)
-      status=gzclose(blob_info->file_info.gzfile);
+      if (blob_info->compressor == (BlobCompressorInfo *) NULL)
+        status=gzclose(blob_info->file_info.gzfile);
+      else
+        {
+          status=fclose(blob_info->file_info.file) == 0 ? Z_OK : Z_ERRNO;
+          blob_info->compressor=DestroyBlobCompressor(blob_info->compressor);
+        }
       if (status != Z_OK)
         ThrowBlobException(blob_info);
 #endif
@@ -1282,6 +1860,9 @@ MagickExport int EOFBlob(const Image *image)
     case ZipStream:
     {
 #if defined(MAGICKCORE_ZLIB_DELEGATE)
+      if ((blob_info->reader != (BlobReaderInfo *) NULL) ||
+          (blob_info->compressor != (BlobCompressorInfo *) NULL))
+        break;
       blob_info->eof=gzeof(blob_info->file_info.gzfile) != 0 ? MagickTrue :
         MagickFalse;
 #endif
@@ -1293,6 +1874,8 @@ MagickExport int EOFBlob(const Image *image)
       int
         status;
 
+      if (blob_info->reader != (BlobReaderInfo *) NULL)
+        break;
       status=0;
       (void) BZ2_bzerror(blob_info->file_info.bzfile,&status);
       blob_info->eof=status == BZ_UNEXPECTED_EOF ? MagickTrue : MagickFalse;
@@ -1361,6 +1944,16 @@ MagickExport int ErrorBlob(const Image *image)
     case ZipStream:
     {
 #if defined(MAGICKCORE_ZLIB_DELEGATE)
+      if (blob_info->reader != (BlobReaderInfo *) NULL)
+        {
+          blob_info->error=blob_info->reader->status;
+          break;
+        }
+      if (blob_info->compressor != (BlobCompressorInfo *) NULL)
+        {
+          blob_info->error=ferror(blob_info->file_info.file);
+          break;
+        }
       (void) gzerror(blob_info->file_info.gzfile,&blob_info->error);
 #endif
       break;
@@ -1368,6 +1961,11 @@ MagickExport int ErrorBlob(const Image *image)
     case BZipStream:
     {
 #if defined(MAGICKCORE_BZLIB_DELEGATE)
+      if (blob_info->reader != (BlobReaderInfo *) NULL)
+        {
+          blob_info->error=blob_info->reader->status;
+          break;
+        }
       (void) BZ2_bzerror(blob_info->file_info.bzfile,&blob_info->error);
 #endif
       break;
@@ -2049,6 +2647,153 @@ MagickExport StreamHandler GetBlobStreamHandler(const Image *image)
 %    o exception: return any errors or warnings in this structure.
 %
 */
+
+static int AcquireBlobFileResource(const Image *image,char *filename,
+  MagickBooleanType *anonymous)
+{
+#if defined(MAGICKCORE_HAVE_MEMFD_CREATE)
+  const DelegateInfo
+    *delegate_info;
+
+  ExceptionInfo
+    *sans_exception;
+
+  int
+    file;
+
+  /*
+    Prefer an anonymous memory-backed file; ChargeBlobFileResource() charges
+    its extent once written.  A delegate runs in another process and cannot
+    reopen this file by name, so formats that may be handed to one get a
+    real temporary file.
+  */
+  *anonymous=MagickFalse;
+  sans_exception=AcquireExceptionInfo();
+  delegate_info=GetDelegateInfo("*",image->magick,sans_exception);
+  sans_exception=DestroyExceptionInfo(sans_exception);
+  if (delegate_info != (const DelegateInfo *) NULL)
+    return(AcquireUniqueFileResource(filename));
+  file=memfd_create("magick",MFD_CLOEXEC);
+  if (file != -1)
+    {
+      (void) FormatLocaleString(filename,MagickPathExtent,"/proc/self/fd/%d",
+        file);
+      if (access_utf8(filename,R_OK | W_OK) == 0)
+        {
+          *anonymous=MagickTrue;
+          return(file);
+        }
+      (void) close(file);
+    }
+#else
+  magick_unreferenced(image);
+#endif
+  *anonymous=MagickFalse;
+  return(AcquireUniqueFileResource(filename));
+}
+
+static MagickBooleanType ChargeBlobFileResource(const Image *image,
+  FILE **file,char *filename,MagickBooleanType *anonymous,
+  MagickSizeType *extent,ExceptionInfo *exception)
+{
+  FILE
+    *spill;
+
+  int
+    spill_file;
+
+  MagickBooleanType
+    status;
+
+  size_t
+    count;
+
+  struct stat
+    file_stats;
+
+  unsigned char
+    *buffer;
+
+  /*
+    Charge the bytes written to an anonymous file to the memory resource.
+  */
+  *extent=0;
+  if (*anonymous == MagickFalse)
+    return(MagickTrue);
+  if ((fstat(fileno(*file),&file_stats) != 0) || (file_stats.st_size <= 0))
+    return(MagickTrue);
+  if (AcquireMagickResource(MemoryResource,(MagickSizeType)
+        file_stats.st_size) != MagickFalse)
+    {
+      *extent=(MagickSizeType) file_stats.st_size;
+      return(MagickTrue);
+    }
+  /*
+    Over the memory limit: move the bytes to a temporary file.
+  */
+  buffer=(unsigned char *) AcquireQuantumMemory(MagickMaxBufferExtent,
+    sizeof(*buffer));
+  if (buffer == (unsigned char *) NULL)
+    {
+      (void) ThrowMagickException(exception,GetMagickModule(),
+        ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
+      return(MagickFalse);
+    }
+  spill=(FILE *) NULL;
+  spill_file=AcquireUniqueFileResource(filename);
+  if (spill_file != -1)
+    {
+      spill=fdopen(spill_file,"wb+");
+      if (spill == (FILE *) NULL)
+        (void) close(spill_file);
+    }
+  if (spill == (FILE *) NULL)
+    {
+      buffer=(unsigned char *) RelinquishMagickMemory(buffer);
+      (void) RelinquishUniqueFileResource(filename);
+      ThrowFileException(exception,BlobError,"UnableToWriteBlob",
+        image->filename);
+      return(MagickFalse);
+    }
+  status=MagickTrue;
+  (void) fseek(*file,0,SEEK_SET);
+  for ( ; ; )
+  {
+    count=fread(buffer,sizeof(*buffer),MagickMaxBufferExtent,*file);
+    if (count == 0)
+      break;
+    if (fwrite(buffer,sizeof(*buffer),count,spill) != count)
+      {
+        status=MagickFalse;
+        break;
+      }
+  }
+  if (ferror(*file) != 0)
+    status=MagickFalse;
+  buffer=(unsigned char *) RelinquishMagickMemory(buffer);
+  (void) fclose(*file);
+  *file=spill;
+  *anonymous=MagickFalse;
+  if (fflush(spill) != 0)
+    status=MagickFalse;
+  if (status == MagickFalse)
+    ThrowFileException(exception,BlobError,"UnableToWriteBlob",
+      image->filename);
+  return(status);
+}
+
+static void RelinquishBlobFileResource(const char *filename,
+  const MagickBooleanType anonymous,const MagickSizeType extent)
+{
+  if (anonymous != MagickFalse)
+    {
+      if (extent != 0)
+        RelinquishMagickResource(MemoryResource,extent);
+      return;
+    }
+  (void) RelinquishUniqueFileResource(filename);
+}
+
 MagickExport void *ImageToBlob(const ImageInfo *image_info,
   Image *image,size_t *length,ExceptionInfo *exception)
 {
@@ -2129,10 +2874,17 @@ MagickExport void *ImageToBlob(const ImageInfo *image_info,
       int
         file;
 
+      MagickBooleanType
+        anonymous;
+
+      MagickSizeType
+        extent;
+
       /*
-        Write file to disk in blob image format.
+        Write file to memory or disk in blob image format.
       */
-      file=AcquireUniqueFileResource(unique);
+      extent=0;
+      file=AcquireBlobFileResource(image,unique,&anonymous);
       if (file == -1)
         {
           ThrowFileException(exception,BlobError,"UnableToWriteBlob",
@@ -2146,11 +2898,15 @@ MagickExport void *ImageToBlob(const ImageInfo *image_info,
               (void) FormatLocaleString(image->filename,MagickPathExtent,
                 "%s:%s",image->magick,unique);
               status=WriteImage(blob_info,image,exception);
-              (void) fclose(blob_info->file);
+              (void) fflush(blob_info->file);
+              if (status != MagickFalse)
+                status=ChargeBlobFileResource(image,&blob_info->file,unique,
+                  &anonymous,&extent,exception);
               if (status != MagickFalse)
                 blob=FileToBlob(unique,SIZE_MAX,length,exception);
+              (void) fclose(blob_info->file);
             }
-          (void) RelinquishUniqueFileResource(unique);
+          RelinquishBlobFileResource(unique,anonymous,extent);
         }
     }
   blob_info=DestroyImageInfo(blob_info);
@@ -2249,11 +3005,17 @@ MagickExport void ImageToCustomStream(const ImageInfo *image_info,Image *image,
       int
         file;
 
+      MagickBooleanType
+        anonymous;
+
+      MagickSizeType
+        extent;
+
       unsigned char
         *blob;
 
       /*
-        Write file to disk in blob image format.
+        Write file to memory or disk in blob image format.
       */
       clone_info->custom_stream=(CustomStreamInfo *) NULL;
       blob=(unsigned char *) AcquireQuantumMemory(MagickMaxBufferExtent,
@@ -2265,7 +3027,8 @@ MagickExport void ImageToCustomStream(const ImageInfo *image_info,Image *image,
           clone_info=DestroyImageInfo(clone_info);
           return;
         }
-      file=AcquireUniqueFileResource(unique);
+      extent=0;
+      file=AcquireBlobFileResource(image,unique,&anonymous);
       if (file == -1)
         {
           ThrowFileException(exception,BlobError,"UnableToWriteBlob",
@@ -2283,6 +3046,10 @@ MagickExport void ImageToCustomStream(const ImageInfo *image_info,Image *image,
           (void) FormatLocaleString(image->filename,MagickPathExtent,
             "%s:%s",image->magick,unique);
           status=WriteImage(clone_info,image,exception);
+          (void) fflush(clone_info->file);
+          if (status != MagickFalse)
+            status=ChargeBlobFileResource(image,&clone_info->file,unique,
+              &anonymous,&extent,exception);
           if (status != MagickFalse)
             {
               (void) fseek(clone_info->file,0,SEEK_SET);
@@ -2298,7 +3065,7 @@ MagickExport void ImageToCustomStream(const ImageInfo *image_info,Image *image,
           (void) fclose(clone_info->file);
         }
       blob=(unsigned char *) RelinquishMagickMemory(blob);
-      (void) RelinquishUniqueFileResource(unique);
+      RelinquishBlobFileResource(unique,anonymous,extent);
     }
   clone_info=DestroyImageInfo(clone_info);
 }
@@ -2538,10 +3305,17 @@ MagickExport void *ImagesToBlob(const ImageInfo *image_info,Image *images,
       int
         file;
 
+      MagickBooleanType
+        anonymous;
+
+      MagickSizeType
+        extent;
+
       /*
-        Write file to disk in blob images format.
+        Write file to memory or disk in blob images format.
       */
-      file=AcquireUniqueFileResource(unique);
+      extent=0;
+      file=AcquireBlobFileResource(images,unique,&anonymous);
       if (file == -1)
         {
           ThrowFileException(exception,FileOpenError,"UnableToWriteBlob",
@@ -2555,11 +3329,15 @@ MagickExport void *ImagesToBlob(const ImageInfo *image_info,Image *images,
               (void) FormatLocaleString(filename,MagickPathExtent,"%s:%s",
                 images->magick,unique);
               status=WriteImages(blob_info,images,filename,exception);
-              (void) fclose(blob_info->file);
+              (void) fflush(blob_info->file);
+              if (status != MagickFalse)
+                status=ChargeBlobFileResource(images,&blob_info->file,unique,
+                  &anonymous,&extent,exception);
               if (status != MagickFalse)
                 blob=FileToBlob(unique,SIZE_MAX,length,exception);
+              (void) fclose(blob_info->file);
             }
-          (void) RelinquishUniqueFileResource(unique);
+          RelinquishBlobFileResource(unique,anonymous,extent);
         }
     }
   blob_info=DestroyImageInfo(blob_info);
@@ -2659,11 +3437,17 @@ MagickExport void ImagesToCustomStream(const ImageInfo *image_info,
       int
         file;
 
+      MagickBooleanType
+        anonymous;
+
+      MagickSizeType
+        extent;
+
       unsigned char
         *blob;
 
       /*
-        Write file to disk in blob image format.
+        Write file to memory or disk in blob image format.
       */
       clone_info->custom_stream=(CustomStreamInfo *) NULL;
       blob=(unsigned char *) AcquireQuantumMemory(MagickMaxBufferExtent,
@@ -2675,7 +3459,8 @@ MagickExport void ImagesToCustomStream(const ImageInfo *image_info,
           clone_info=DestroyImageInfo(clone_info);
           return;
         }
-      file=AcquireUniqueFileResource(unique);
+      extent=0;
+      file=AcquireBlobFileResource(images,unique,&anonymous);
       if (file == -1)
         {
           ThrowFileException(exception,BlobError,"UnableToWriteBlob",
@@ -2693,6 +3478,10 @@ MagickExport void ImagesToCustomStream(const ImageInfo *image_info,
           (void) FormatLocaleString(filename,MagickPathExtent,"%s:%s",
             images->magick,unique);
           status=WriteImages(clone_info,images,filename,exception);
+          (void) fflush(clone_info->file);
+          if (status != MagickFalse)
+            status=ChargeBlobFileResource(images,&clone_info->file,unique,
+              &anonymous,&extent,exception);
           if (status != MagickFalse)
             {
               (void) fseek(clone_info->file,0,SEEK_SET);
@@ -2708,7 +3497,7 @@ MagickExport void ImagesToCustomStream(const ImageInfo *image_info,
           (void) fclose(clone_info->file);
         }
       blob=(unsigned char *) RelinquishMagickMemory(blob);
-      (void) RelinquishUniqueFileResource(unique);
+      RelinquishBlobFileResource(unique,anonymous,extent);
     }
   clone_info=DestroyImageInfo(clone_info);
 }
@@ -2863,6 +3652,37 @@ MagickExport MagickBooleanType InjectImageBlob(const ImageInfo *image_info,
   return(status);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   I s B l o b C o m p r e s s e d                                           %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  IsBlobCompressed() returns true if the blob is a gzip or bzip2 stream.
+%
+%  The format of the IsBlobCompressed method is:
+%
+%       MagickBooleanType IsBlobCompressed(const Image *image)
+%
+%  A description of each parameter follows:
+%
+%    o image: the image.
+%
+*/
+MagickPrivate MagickBooleanType IsBlobCompressed(const Image *image)
+{
+  assert(image != (const Image *) NULL);
+  assert(image->signature == MagickCoreSignature);
+  if ((image->blob->type == ZipStream) || (image->blob->type == BZipStream))
+    return(MagickTrue);
+  return(MagickFalse);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -2948,6 +3768,13 @@ MagickExport MagickBooleanType IsBlobSeekable(const Image *image)
 
       if (blob_info->file_info.gzfile == (gzFile) NULL)
         return(MagickFalse);
+      if (blob_info->reader != (BlobReaderInfo *) NULL)
+        return(MagickTrue);
+      if (blob_info->compressor != (BlobCompressorInfo *) NULL)
+        return(MagickFalse);
+      if ((blob_info->mode != ReadBlobMode) &&
+          (blob_info->mode != ReadBinaryBlobMode))
+        return(MagickFalse);  /* gzseek() cannot seek back when writing */
       offset=gzseek(blob_info->file_info.gzfile,0,SEEK_CUR);
       return(offset < 0 ? MagickFalse : MagickTrue);
 #else
@@ -3511,6 +4338,13 @@ MagickExport MagickBooleanType OpenBlob(const ImageInfo *image_info,
                     blob_info->type=BZipStream;
                   }
               }
+#endif
+#if defined(MAGICKCORE_THREAD_SUPPORT)
+            if (((blob_info->type == ZipStream) ||
+                 (blob_info->type == BZipStream)) &&
+                (image_info->ping == MagickFalse) &&
+                (GetMagickResourceLimit(ThreadResource) > 1))
+              blob_info->reader=AcquireBlobReader(blob_info);
 #endif
             if (blob_info->type == FileStream)
               {
@@ -3564,9 +4398,15 @@ MagickExport MagickBooleanType OpenBlob(const ImageInfo *image_info,
           (LocaleCompare(extension,"wmz") == 0) ||
           (LocaleCompare(extension,"svgz") == 0))
         {
-          blob_info->file_info.gzfile=gzopen_utf8(filename,"wb");
-          if (blob_info->file_info.gzfile != (gzFile) NULL)
+          if ((GetMagickResourceLimit(ThreadResource) > 1) &&
+              (OpenBlobCompressor(blob_info,filename) != MagickFalse))
             blob_info->type=ZipStream;
+          else
+            {
+              blob_info->file_info.gzfile=gzopen_utf8(filename,"wb");
+              if (blob_info->file_info.gzfile != (gzFile) NULL)
+                blob_info->type=ZipStream;
+            }
         }
       else
 #endif
@@ -3806,6 +4646,19 @@ MagickExport ssize_t ReadBlob(Image *image,const size_t length,void *data)
   blob_info=image->blob;
   count=0;
   q=(unsigned char *) data;
+#if defined(MAGICKCORE_THREAD_SUPPORT)
+  if (blob_info->reader != (BlobReaderInfo *) NULL)
+    {
+      count=ReadBlobReader(blob_info->reader,length,q);
+      if (count != (ssize_t) length)
+        {
+          if (blob_info->reader->status != 0)
+            ThrowBlobException(blob_info);
+          blob_info->eof=MagickTrue;
+        }
+      return(count);
+    }
+#endif
   switch (blob_info->type)
   {
     case UndefinedStream:
@@ -4945,18 +5798,23 @@ MagickExport char *ReadBlobString(Image *image,char *string)
     case ZipStream:
     {
 #if defined(MAGICKCORE_ZLIB_DELEGATE)
-      char *p = gzgets(blob_info->file_info.gzfile,string,MagickPathExtent);
-      if (p == (char *) NULL)
+      if (blob_info->reader == (BlobReaderInfo *) NULL)
         {
-          int status = Z_OK;
-          (void) gzerror(blob_info->file_info.gzfile,&status);
-          if (status != Z_OK)
-            ThrowBlobException(blob_info);
-          return((char *) NULL);
+          char *p = gzgets(blob_info->file_info.gzfile,string,
+            MagickPathExtent);
+          if (p == (char *) NULL)
+            {
+              int status = Z_OK;
+              (void) gzerror(blob_info->file_info.gzfile,&status);
+              if (status != Z_OK)
+                ThrowBlobException(blob_info);
+              return((char *) NULL);
+            }
+          i=strlen(string);
+          break;
         }
-      i=strlen(string);
-      break;
 #endif
+      magick_fallthrough;
     }
     default:
     {
@@ -5089,6 +5947,43 @@ MagickExport MagickOffsetType SeekBlob(Image *image,
     case ZipStream:
     {
 #if defined(MAGICKCORE_ZLIB_DELEGATE)
+      MagickOffsetType
+        position;
+
+      position=offset;
+      if (whence == SEEK_CUR)
+        position+=TellBlob(image);
+      if (blob_info->compressor != (BlobCompressorInfo *) NULL)
+        {
+          if ((whence == SEEK_END) ||
+              (position != (MagickOffsetType) blob_info->compressor->size))
+            return(-1);
+          blob_info->offset=position;
+          break;
+        }
+#if defined(MAGICKCORE_THREAD_SUPPORT)
+      if (blob_info->reader != (BlobReaderInfo *) NULL)
+        {
+          if ((whence == SEEK_END) || (position < 0))
+            return(-1);
+          if (position >= blob_info->reader->position)
+            {
+              /*
+                Skip forward through the decompressed buffers.
+              */
+              (void) ReadBlobReader(blob_info->reader,(size_t) (position-
+                blob_info->reader->position),(unsigned char *) NULL);
+              blob_info->offset=TellBlob(image);
+              break;
+            }
+          blob_info->reader=DestroyBlobReader(blob_info->reader);
+          if (gzseek(blob_info->file_info.gzfile,position,SEEK_SET) < 0)
+            return(-1);
+          blob_info->reader=AcquireBlobReader(blob_info);
+          blob_info->offset=TellBlob(image);
+          break;
+        }
+#endif
       if (gzseek(blob_info->file_info.gzfile,offset,whence) < 0)
         return(-1);
 #endif
@@ -5558,6 +6453,16 @@ static int SyncBlob(const Image *image)
     case ZipStream:
     {
 #if defined(MAGICKCORE_ZLIB_DELEGATE)
+      if (blob_info->reader != (BlobReaderInfo *) NULL)
+        break;
+      if (blob_info->compressor != (BlobCompressorInfo *) NULL)
+        {
+          if (FlushBlobCompressor(blob_info,MagickFalse) == MagickFalse)
+            status=(-1);
+          else
+            status=fflush(blob_info->file_info.file);
+          break;
+        }
       (void) gzflush(blob_info->file_info.gzfile,Z_SYNC_FLUSH);
 #endif
       break;
@@ -5632,12 +6537,22 @@ MagickExport MagickOffsetType TellBlob(const Image *image)
     case ZipStream:
     {
 #if defined(MAGICKCORE_ZLIB_DELEGATE)
-      offset=(MagickOffsetType) gztell(blob_info->file_info.gzfile);
+      if (blob_info->reader != (BlobReaderInfo *) NULL)
+        offset=blob_info->reader->position;
+      else
+        if (blob_info->compressor != (BlobCompressorInfo *) NULL)
+          offset=(MagickOffsetType) blob_info->compressor->size;
+        else
+          offset=(MagickOffsetType) gztell(blob_info->file_info.gzfile);
 #endif
       break;
     }
     case BZipStream:
+    {
+      if (blob_info->reader != (BlobReaderInfo *) NULL)
+        offset=blob_info->reader->position;
       break;
+    }
     case FifoStream:
       break;
     case BlobStream:
@@ -5814,6 +6729,13 @@ MagickExport ssize_t WriteBlob(Image *image,const size_t length,
       int
         status;
 
+      if (blob_info->compressor != (BlobCompressorInfo *) NULL)
+        {
+          count=WriteBlobCompressor(blob_info,length,p);
+          if (count != (ssize_t) length)
+            ThrowBlobException(blob_info);
+          break;
+        }
       switch (length)
       {
         default:
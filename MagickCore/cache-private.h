@@ -25,6 +25,7 @@
 #include "MagickCore/random_.h"
 #include "MagickCore/thread-private.h"
 #include "MagickCore/semaphore.h"
+#include "MagickCore/splay-tree.h"
 
 #if defined(__cplusplus) || defined(c_plusplus)
 extern "C" {
@@ -162,7 +163,8 @@ typedef struct _CacheInfo
     disk_mode;
 
   MagickBooleanType
-    mapped;
+    mapped,
+    memory_synced;
 
   MagickOffsetType
     offset;
@@ -191,6 +193,9 @@ typedef struct _CacheInfo
   int
     file;
 
+  struct _MemoryFileInfo
+    *memory_file;
+
   char
     filename[MagickPathExtent],
     cache_filename[MagickPathExtent];
@@ -233,6 +238,15 @@ typedef struct _CacheInfo
   MagickSizeType
     width_limit,
     height_limit;
+
+  SplayTreeInfo
+    *memo;
+
+  void
+    *view_cache;
+
+  OffsetInfo
+    view_offset;
 } CacheInfo;
 
 static inline MagickBooleanType IsValidPixelOffset(const ssize_t x,
@@ -269,6 +283,9 @@ extern MagickPrivate const void
 
 extern MagickPrivate MagickBooleanType
   CacheComponentGenesis(void),
+  GetPixelCacheMemo(const Image *,const char *,void *,const size_t),
+  ReferencePixelCacheRegion(Image *,const Image *,const RectangleInfo *),
+  SetPixelCacheMemo(const Image *,const char *,const void *,const size_t),
   SyncAuthenticPixelCacheNexus(Image *,NexusInfo *magick_restrict,
     ExceptionInfo *) magick_hot_spot,
   SyncImagePixelCache(Image *,ExceptionInfo *);
@@ -85,10 +85,58 @@
 #define CacheTick(offset,extent)  QuantumTick((MagickOffsetType) offset,extent)
 #define IsFileDescriptorLimitExceeded() (GetMagickResource(FileResource) > \
   GetMagickResourceLimit(FileResource) ? MagickTrue : MagickFalse)
+#if defined(MAGICKCORE_HAVE_MEMFD_CREATE) && defined(MAGICKCORE_HAVE_MMAP) && \
+  !defined(MAGICKCORE_OPENCL_SUPPORT)
+#define MagickCopyOnWriteCache  1
+#endif
 
 /*
   Typedef declarations.
 */
+typedef struct _MemoryFileInfo
+{
+  int
+    file;
+
+  MagickSizeType
+    length;
+
+  size_t
+    references;
+
+  SemaphoreInfo
+    *semaphore;
+} MemoryFileInfo;
+
+typedef struct _CacheMemoInfo
+{
+  ClassType
+    storage_class;
+
+  ColorspaceType
+    colorspace;
+
+  PixelTrait
+    alpha_trait;
+
+  ChannelType
+    channel_mask;
+
+  size_t
+    columns,
+    rows,
+    number_channels;
+
+  PixelChannelMap
+    channel_map[MaxPixelChannels];
+
+  size_t
+    length;
+
+  void
+    *value;
+} CacheMemoInfo;
+
 typedef struct _MagickModulo
 {
   ssize_t
@@ -159,6 +207,31 @@ static SemaphoreInfo
 
 static ssize_t
   cache_anonymous_memory = (-1);
+
+/*
+  The memo holds attributes derived from the cache pixels, such as image
+  statistics, so they are computed once rather than on every request.  Any
+  access that can change the pixels expires it.
+*/
+static inline void ExpirePixelCacheMemo(CacheInfo *magick_restrict cache_info)
+{
+  if (cache_info->memo == (SplayTreeInfo *) NULL)
+    return;
+  LockSemaphoreInfo(cache_info->semaphore);
+  if (cache_info->memo != (SplayTreeInfo *) NULL)
+    cache_info->memo=DestroySplayTree(cache_info->memo);
+  UnlockSemaphoreInfo(cache_info->semaphore);
+}
+
+/*
+  Any access that can change the pixels goes through here: the memo expires
+  and a copy-on-write cache no longer matches the file it maps.
+*/
+static inline void ModifyPixelCache(CacheInfo *magick_restrict cache_info)
+{
+  cache_info->memory_synced=MagickFalse;
+  ExpirePixelCacheMemo(cache_info);
+}
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -652,6 +725,175 @@ static MagickBooleanType ClonePixelCacheOnDisk(
   return(MagickTrue);
 }
 
+#if defined(MagickCopyOnWriteCache)
+static MemoryFileInfo *AcquireMemoryFileInfo(const CacheInfo *cache_info)
+{
+  int
+    file;
+
+  MagickOffsetType
+    count,
+    i;
+
+  MemoryFileInfo
+    *memory_file;
+
+  unsigned char
+    *pixels;
+
+  /*
+    Copy the cache pixels to an anonymous file.  Its pages stay resident while
+    any cache maps the file, so they are charged to the memory resource once,
+    on top of the private pages each mapping may write.
+  */
+  memory_file=(MemoryFileInfo *) AcquireMagickMemory(sizeof(*memory_file));
+  if (memory_file == (MemoryFileInfo *) NULL)
+    return((MemoryFileInfo *) NULL);
+  if (AcquireMagickResource(FileResource,1) == MagickFalse)
+    {
+      memory_file=(MemoryFileInfo *) RelinquishMagickMemory(memory_file);
+      return((MemoryFileInfo *) NULL);
+    }
+  if (AcquireMagickResource(MemoryResource,cache_info->length) == MagickFalse)
+    {
+      RelinquishMagickResource(FileResource,1);
+      memory_file=(MemoryFileInfo *) RelinquishMagickMemory(memory_file);
+      return((MemoryFileInfo *) NULL);
+    }
+  file=memfd_create("magick-pixel-cache",MFD_CLOEXEC);
+  pixels=(unsigned char *) cache_info->pixels;
+  i=0;
+  if (file != -1)
+    for ( ; i < (MagickOffsetType) cache_info->length; i+=count)
+    {
+      count=(MagickOffsetType) write(file,pixels+i,(size_t) MagickMin(
+        cache_info->length-(MagickSizeType) i,MagickMaxBufferExtent));
+      if (count <= 0)
+        {
+          if ((count == 0) || (errno != EINTR))
+            break;
+          count=0;
+        }
+    }
+  if ((file == -1) || (i != (MagickOffsetType) cache_info->length))
+    {
+      if (file != -1)
+        (void) close(file);
+      RelinquishMagickResource(MemoryResource,cache_info->length);
+      RelinquishMagickResource(FileResource,1);
+      memory_file=(MemoryFileInfo *) RelinquishMagickMemory(memory_file);
+      return((MemoryFileInfo *) NULL);
+    }
+  memory_file->file=file;
+  memory_file->length=cache_info->length;
+  memory_file->references=0;
+  memory_file->semaphore=AcquireSemaphoreInfo();
+  return(memory_file);
+}
+
+static void ReferenceMemoryFileInfo(MemoryFileInfo *memory_file)
+{
+  LockSemaphoreInfo(memory_file->semaphore);
+  memory_file->references++;
+  UnlockSemaphoreInfo(memory_file->semaphore);
+}
+#endif
+
+static MemoryFileInfo *DestroyMemoryFileInfo(MemoryFileInfo *memory_file)
+{
+  (void) close(memory_file->file);
+  RelinquishMagickResource(MemoryResource,memory_file->length);
+  RelinquishMagickResource(FileResource,1);
+  RelinquishSemaphoreInfo(&memory_file->semaphore);
+  return((MemoryFileInfo *) RelinquishMagickMemory(memory_file));
+}
+
+static void RelinquishMemoryFileInfo(CacheInfo *cache_info)
+{
+  MemoryFileInfo
+    *memory_file;
+
+  size_t
+    references;
+
+  /*
+    The cache no longer maps the file; the last mapping releases it.
+  */
+  memory_file=cache_info->memory_file;
+  if (memory_file == (MemoryFileInfo *) NULL)
+    return;
+  cache_info->memory_file=(MemoryFileInfo *) NULL;
+  LockSemaphoreInfo(memory_file->semaphore);
+  references=(--memory_file->references);
+  UnlockSemaphoreInfo(memory_file->semaphore);
+  if (references == 0)
+    memory_file=DestroyMemoryFileInfo(memory_file);
+}
+
+static MagickBooleanType ClonePixelCacheOnWrite(CacheInfo *clone_info,
+  CacheInfo *cache_info)
+{
+#if defined(MagickCopyOnWriteCache)
+  MemoryFileInfo
+    *memory_file;
+
+  unsigned char
+    *pixels;
+
+  /*
+    Share the source pages with the clone until either cache writes to them.
+    Only caches mapped anonymously (the cache memory-map policy) qualify, as
+    their mapping can be replaced by one of the file; heap caches, the
+    default, are copied.
+  */
+  if ((cache_info->type != MemoryCache) || (clone_info->type != MemoryCache) ||
+      (cache_info->mapped == MagickFalse) ||
+      (clone_info->mapped == MagickFalse) ||
+      (cache_info->length != clone_info->length))
+    return(MagickFalse);
+  if ((cache_info->memory_file == (MemoryFileInfo *) NULL) ||
+      (cache_info->memory_synced == MagickFalse))
+    {
+      /*
+        Map the file privately in place of the source memory.
+      */
+      memory_file=AcquireMemoryFileInfo(cache_info);
+      if (memory_file == (MemoryFileInfo *) NULL)
+        return(MagickFalse);
+      if (mmap(cache_info->pixels,(size_t) cache_info->length,PROT_READ |
+          PROT_WRITE,MAP_PRIVATE | MAP_FIXED,memory_file->file,0) ==
+          MAP_FAILED)
+        {
+          memory_file=DestroyMemoryFileInfo(memory_file);
+          return(MagickFalse);
+        }
+      RelinquishMemoryFileInfo(cache_info);
+      ReferenceMemoryFileInfo(memory_file);
+      cache_info->memory_file=memory_file;
+      cache_info->memory_synced=MagickTrue;
+    }
+  memory_file=cache_info->memory_file;
+  pixels=(unsigned char *) mmap((void *) NULL,(size_t) clone_info->length,
+    PROT_READ | PROT_WRITE,MAP_PRIVATE,memory_file->file,0);
+  if (pixels == (unsigned char *) MAP_FAILED)
+    return(MagickFalse);
+  if (clone_info->metacontent != (void *) NULL)
+    clone_info->metacontent=(void *) (pixels+((unsigned char *)
+      clone_info->metacontent-(unsigned char *) clone_info->pixels));
+  (void) UnmapBlob(clone_info->pixels,(size_t) clone_info->length);
+  RelinquishMemoryFileInfo(clone_info);
+  ReferenceMemoryFileInfo(memory_file);
+  clone_info->pixels=(Quantum *) pixels;
+  clone_info->memory_file=memory_file;
+  clone_info->memory_synced=MagickTrue;
+  return(MagickTrue);
+#else
+  magick_unreferenced(clone_info);
+  magick_unreferenced(cache_info);
+  return(MagickFalse);
+#endif
+}
+
 static MagickBooleanType ClonePixelCacheRepository(
   CacheInfo *magick_restrict clone_info,CacheInfo *magick_restrict cache_info,
   ExceptionInfo *exception)
@@ -701,6 +943,8 @@ static MagickBooleanType ClonePixelCacheRepository(
            (cache_info->type == MapCache)) &&
           ((clone_info->type == MemoryCache) || (clone_info->type == MapCache)))
         {
+          if (ClonePixelCacheOnWrite(clone_info,cache_info) != MagickFalse)
+            return(MagickTrue);
           (void) memcpy(clone_info->pixels,cache_info->pixels,
             cache_info->number_channels*cache_info->columns*cache_info->rows*
             sizeof(*cache_info->pixels));
@@ -970,6 +1214,8 @@ static MagickBooleanType ClosePixelCacheOnDisk(CacheInfo *cache_info)
 
 static inline void RelinquishPixelCachePixels(CacheInfo *cache_info)
 {
+  if (cache_info->view_cache != (void *) NULL)
+    cache_info->view_cache=DestroyPixelCache(cache_info->view_cache);
   switch (cache_info->type)
   {
     case MemoryCache:
@@ -991,6 +1237,7 @@ static inline void RelinquishPixelCachePixels(CacheInfo *cache_info)
         {
           (void) UnmapBlob(cache_info->pixels,(size_t) cache_info->length);
           cache_info->pixels=(Quantum *) NULL;
+          RelinquishMemoryFileInfo(cache_info);
         }
       RelinquishMagickResource(MemoryResource,cache_info->length);
       break;
@@ -1067,6 +1314,8 @@ MagickPrivate Cache DestroyPixelCache(Cache cache)
       cache_info->number_threads);
   if (cache_info->random_info != (RandomInfo *) NULL)
     cache_info->random_info=DestroyRandomInfo(cache_info->random_info);
+  if (cache_info->memo != (SplayTreeInfo *) NULL)
+    cache_info->memo=DestroySplayTree(cache_info->memo);
   if (cache_info->file_semaphore != (SemaphoreInfo *) NULL)
     RelinquishSemaphoreInfo(&cache_info->file_semaphore);
   if (cache_info->semaphore != (SemaphoreInfo *) NULL)
@@ -1272,6 +1521,7 @@ MagickPrivate cl_mem GetAuthenticOpenCLBuffer(const Image *image,
     }
   if ((cache_info->type != MemoryCache) || (cache_info->mapped != MagickFalse))
     return((cl_mem) NULL);
+  ModifyPixelCache(cache_info);
   LockSemaphoreInfo(cache_info->semaphore);
   if ((cache_info->opencl != (MagickCLCacheInfo) NULL) &&
       (cache_info->opencl->device->context != device->context))
@@ -1759,6 +2009,7 @@ static Cache GetImagePixelCache(Image *image,const MagickBooleanType clone,
       */
       if (image->type != UndefinedType)
         image->type=UndefinedType;
+      ModifyPixelCache((CacheInfo *) image->cache);
       if (ValidatePixelCacheMorphology(image) == MagickFalse)
         {
           status=OpenPixelCache(image,IOMode,exception);
@@ -1785,7 +2036,8 @@ static Cache GetImagePixelCache(Image *image,const MagickBooleanType clone,
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
 %  GetImagePixelCacheType() returns the pixel cache type: UndefinedCache,
-%  DiskCache, MemoryCache, MapCache, or PingCache.
+%  DiskCache, MemoryCache, MapCache, or PingCache.  An image that is a view
+%  of a region of another image reports the type of that image's cache.
 %
 %  The format of the GetImagePixelCacheType() method is:
 %
@@ -1806,6 +2058,8 @@ MagickExport CacheType GetImagePixelCacheType(const Image *image)
   assert(image->cache != (Cache) NULL);
   cache_info=(CacheInfo *) image->cache;
   assert(cache_info->signature == MagickCoreSignature);
+  if (cache_info->type == ViewCache)
+    cache_info=(CacheInfo *) cache_info->view_cache;
   return(cache_info->type);
 }
 
@@ -2195,6 +2449,94 @@ MagickExport const char *GetPixelCacheFilename(const Image *image)
   return(cache_info->cache_filename);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   G e t P i x e l C a c h e M e m o                                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  GetPixelCacheMemo() copies an attribute memoized by SetPixelCacheMemo() to
+%  the value buffer.  It returns MagickFalse if the attribute is not memoized,
+%  the pixels changed since, or the image no longer matches the channel
+%  layout it was computed for.
+%
+%  The format of the GetPixelCacheMemo() method is:
+%
+%      MagickBooleanType GetPixelCacheMemo(const Image *image,
+%        const char *key,void *value,const size_t length)
+%
+%  A description of each parameter follows:
+%
+%    o image: the image.
+%
+%    o key: the attribute key.  Include any image setting, other than its
+%      channel layout, that the attribute depends on.
+%
+%    o value: the attribute value is returned here.
+%
+%    o length: the attribute length in bytes.
+%
+*/
+
+static MagickBooleanType IsCacheMemoCurrent(const Image *image,
+  const CacheMemoInfo *memo_info)
+{
+  if ((memo_info->storage_class != image->storage_class) ||
+      (memo_info->colorspace != image->colorspace) ||
+      (memo_info->alpha_trait != image->alpha_trait) ||
+      (memo_info->channel_mask != image->channel_mask) ||
+      (memo_info->columns != image->columns) ||
+      (memo_info->rows != image->rows) ||
+      (memo_info->number_channels != image->number_channels))
+    return(MagickFalse);
+  if (memcmp(memo_info->channel_map,image->channel_map,
+        sizeof(memo_info->channel_map)) != 0)
+    return(MagickFalse);
+  return(MagickTrue);
+}
+
+MagickPrivate MagickBooleanType GetPixelCacheMemo(const Image *image,
+  const char *key,void *value,const size_t length)
+{
+  CacheInfo
+    *magick_restrict cache_info;
+
+  const CacheMemoInfo
+    *memo_info;
+
+  MagickBooleanType
+    status;
+
+  assert(image != (const Image *) NULL);
+  assert(image->signature == MagickCoreSignature);
+  assert(image->cache != (Cache) NULL);
+  cache_info=(CacheInfo *) image->cache;
+  assert(cache_info->signature == MagickCoreSignature);
+  if (cache_info->memo == (SplayTreeInfo *) NULL)
+    return(MagickFalse);
+  status=MagickFalse;
+  LockSemaphoreInfo(cache_info->semaphore);
+  if (cache_info->memo != (SplayTreeInfo *) NULL)
+    {
+      memo_info=(const CacheMemoInfo *) GetValueFromSplayTree(
+        cache_info->memo,key);
+      if ((memo_info != (const CacheMemoInfo *) NULL) &&
+          (memo_info->length == length) &&
+          (IsCacheMemoCurrent(image,memo_info) != MagickFalse))
+        {
+          (void) memcpy(value,memo_info->value,length);
+          status=MagickTrue;
+        }
+    }
+  UnlockSemaphoreInfo(cache_info->semaphore);
+  return(status);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -2323,6 +2665,7 @@ MagickExport void *GetPixelCachePixels(Image *image,MagickSizeType *length,
   *length=cache_info->length;
   if ((cache_info->type != MemoryCache) && (cache_info->type != MapCache))
     return((void *) NULL);
+  ModifyPixelCache(cache_info);
   return((void *) cache_info->pixels);
 }
 
@@ -3686,6 +4029,7 @@ static MagickBooleanType OpenPixelCache(Image *image,const MapMode mode,
     ThrowBinaryException(CacheError,"NoPixelsDefinedInCache",image->filename);
   cache_info=(CacheInfo *) image->cache;
   assert(cache_info->signature == MagickCoreSignature);
+  ModifyPixelCache(cache_info);
   if (((MagickSizeType) image->columns > cache_info->width_limit) ||
       ((MagickSizeType) image->rows > cache_info->height_limit))
     {
@@ -3703,6 +4047,14 @@ static MagickBooleanType OpenPixelCache(Image *image,const MapMode mode,
     }
   source_info=(*cache_info);
   source_info.file=(-1);
+  if (cache_info->type == ViewCache)
+    {
+      /*
+        The source keeps the view reference; this cache gets its own pixels.
+      */
+      cache_info->type=UndefinedCache;
+      cache_info->view_cache=(void *) NULL;
+    }
   (void) FormatLocaleString(cache_info->filename,MagickPathExtent,"%s[%.20g]",
     image->filename,(double) image->scene);
   cache_info->storage_class=image->storage_class;
@@ -3750,6 +4102,7 @@ static MagickBooleanType OpenPixelCache(Image *image,const MapMode mode,
       if (status != MagickFalse)
         {
           status=MagickTrue;
+          cache_info->memory_file=(MemoryFileInfo *) NULL;
           if (cache_anonymous_memory <= 0)
             {
               cache_info->mapped=MagickFalse;
@@ -3766,6 +4119,7 @@ static MagickBooleanType OpenPixelCache(Image *image,const MapMode mode,
             {
               cache_info->mapped=source_info.mapped;
               cache_info->pixels=source_info.pixels;
+              cache_info->memory_file=source_info.memory_file;
             }
           else
             {
@@ -3949,6 +4303,7 @@ static MagickBooleanType OpenPixelCache(Image *image,const MapMode mode,
               (void) ClosePixelCacheOnDisk(cache_info);
               cache_info->type=MapCache;
               cache_info->mapped=MagickTrue;
+              cache_info->memory_file=(MemoryFileInfo *) NULL;
               cache_info->metacontent=(void *) NULL;
               if (cache_info->metacontent_extent != 0)
                 cache_info->metacontent=(void *) (cache_info->pixels+
@@ -4465,6 +4820,20 @@ static MagickBooleanType ReadPixelCacheMetacontent(
   rows=nexus_info->region.height;
   y=0;
   q=(unsigned char *) nexus_info->metacontent;
+  if (cache_info->type == ViewCache)
+    {
+      NexusInfo
+        view_nexus;
+
+      /*
+        Read metacontent from the region of the referenced cache.
+      */
+      view_nexus=(*nexus_info);
+      view_nexus.region.x+=cache_info->view_offset.x;
+      view_nexus.region.y+=cache_info->view_offset.y;
+      return(ReadPixelCacheMetacontent((CacheInfo *) cache_info->view_cache,
+        &view_nexus,exception));
+    }
   switch (cache_info->type)
   {
     case MemoryCache:
@@ -4646,6 +5015,20 @@ static MagickBooleanType ReadPixelCachePixels(
     return(MagickFalse);
   y=0;
   q=nexus_info->pixels;
+  if (cache_info->type == ViewCache)
+    {
+      NexusInfo
+        view_nexus;
+
+      /*
+        Read pixels from the region of the referenced cache.
+      */
+      view_nexus=(*nexus_info);
+      view_nexus.region.x+=cache_info->view_offset.x;
+      view_nexus.region.y+=cache_info->view_offset.y;
+      return(ReadPixelCachePixels((CacheInfo *) cache_info->view_cache,
+        &view_nexus,exception));
+    }
   switch (cache_info->type)
   {
     case MemoryCache:
@@ -4797,6 +5180,118 @@ MagickPrivate Cache ReferencePixelCache(Cache cache)
 %                                                                             %
 %                                                                             %
 %                                                                             %
++   R e f e r e n c e P i x e l C a c h e R e g i o n                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ReferencePixelCacheRegion() associates the pixel cache of an image with a
+%  region of the pixel cache of the source image rather than copying its
+%  pixels.  The view is read-only: the region is copied to a private pixel
+%  cache the first time the pixels of the image are modified.  The image
+%  must be the same size as the region and not yet have pixels of its own.
+%
+%  The format of the ReferencePixelCacheRegion method is:
+%
+%      MagickBooleanType ReferencePixelCacheRegion(Image *image,
+%        const Image *source,const RectangleInfo *region)
+%
+%  A description of each parameter follows:
+%
+%    o image: the image.
+%
+%    o source: the source image.
+%
+%    o region: the region of the source image.
+%
+*/
+MagickPrivate MagickBooleanType ReferencePixelCacheRegion(Image *image,
+  const Image *source,const RectangleInfo *region)
+{
+  CacheInfo
+    *magick_restrict cache_info,
+    *magick_restrict source_info;
+
+  OffsetInfo
+    offset;
+
+  assert(image != (Image *) NULL);
+  assert(image->signature == MagickCoreSignature);
+  assert(source != (const Image *) NULL);
+  assert(source->signature == MagickCoreSignature);
+  assert(region != (const RectangleInfo *) NULL);
+  if (IsEventLogging() != MagickFalse)
+    (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",image->filename);
+  cache_info=(CacheInfo *) image->cache;
+  source_info=(CacheInfo *) source->cache;
+  if ((cache_info == source_info) || (cache_info->type != UndefinedCache) ||
+      (cache_info->reference_count != 1))
+    return(MagickFalse);
+  if ((image->columns != region->width) || (image->rows != region->height) ||
+      (region->width == 0) || (region->height == 0) ||
+      (region->x < 0) || (region->y < 0) ||
+      ((region->x+(ssize_t) region->width) > (ssize_t) source_info->columns) ||
+      ((region->y+(ssize_t) region->height) > (ssize_t) source_info->rows))
+    return(MagickFalse);
+  offset.x=region->x;
+  offset.y=region->y;
+  if (source_info->type == ViewCache)
+    {
+      /*
+        Reference the pixel cache the source view is itself a region of.
+      */
+      offset.x+=source_info->view_offset.x;
+      offset.y+=source_info->view_offset.y;
+      source_info=(CacheInfo *) source_info->view_cache;
+    }
+  if ((source_info->type == UndefinedCache) ||
+      (source_info->type == PingCache))
+    return(MagickFalse);
+  cache_info->storage_class=source_info->storage_class;
+  cache_info->colorspace=source_info->colorspace;
+  cache_info->alpha_trait=source_info->alpha_trait;
+  cache_info->channels=source_info->channels;
+  cache_info->columns=region->width;
+  cache_info->rows=region->height;
+  cache_info->number_channels=source_info->number_channels;
+  (void) memcpy(cache_info->channel_map,source_info->channel_map,
+    MaxPixelChannels*sizeof(*source_info->channel_map));
+  cache_info->metacontent_extent=source_info->metacontent_extent;
+  if (ValidatePixelCacheMorphology(image) == MagickFalse)
+    {
+      cache_info->columns=0;
+      cache_info->rows=0;
+      return(MagickFalse);
+    }
+  (void) FormatLocaleString(cache_info->filename,MagickPathExtent,"%s[%.20g]",
+    image->filename,(double) image->scene);
+  cache_info->length=(MagickSizeType) cache_info->columns*cache_info->rows*
+    (cache_info->number_channels*sizeof(Quantum)+
+    cache_info->metacontent_extent);
+  cache_info->mode=ReadMode;
+  cache_info->view_cache=ReferencePixelCache(source_info);
+  cache_info->view_offset=offset;
+  cache_info->type=ViewCache;
+  if (cache_info->debug != MagickFalse)
+    {
+      char
+        message[MagickPathExtent];
+
+      (void) FormatLocaleString(message,MagickPathExtent,
+        "view %s[%.20gx%.20g%+.20g%+.20g]",source_info->filename,(double)
+        region->width,(double) region->height,(double) offset.x,(double)
+        offset.y);
+      (void) LogMagickEvent(CacheEvent,GetMagickModule(),"%s",message);
+    }
+  return(MagickTrue);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
 +   R e s e t P i x e l C a c h e C h a n n e l s                             %
 %                                                                             %
 %                                                                             %
@@ -4824,6 +5319,7 @@ MagickPrivate void ResetPixelCacheChannels(Image *image)
   assert(image->cache != (Cache) NULL);
   cache_info=(CacheInfo *) image->cache;
   assert(cache_info->signature == MagickCoreSignature);
+  ModifyPixelCache(cache_info);
   cache_info->number_channels=GetPixelChannels(image);
 }
 
@@ -4905,6 +5401,97 @@ MagickExport MagickBooleanType ReshapePixelCache(Image *image,
   return(SyncImagePixelCache(image,exception));
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S e t P i x e l C a c h e M e m o                                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  SetPixelCacheMemo() memoizes an attribute computed from the image pixels.
+%  The memo is shared by the images that share the pixel cache and expires
+%  when the pixels change.
+%
+%  The format of the SetPixelCacheMemo() method is:
+%
+%      MagickBooleanType SetPixelCacheMemo(const Image *image,
+%        const char *key,const void *value,const size_t length)
+%
+%  A description of each parameter follows:
+%
+%    o image: the image.
+%
+%    o key: the attribute key.
+%
+%    o value: the attribute value.
+%
+%    o length: the attribute length in bytes.
+%
+*/
+
+static void *DestroyCacheMemo(void *memo_info)
+{
+  CacheMemoInfo
+    *p;
+
+  p=(CacheMemoInfo *) memo_info;
+  p->value=RelinquishMagickMemory(p->value);
+  return(RelinquishMagickMemory(p));
+}
+
+MagickPrivate MagickBooleanType SetPixelCacheMemo(const Image *image,
+  const char *key,const void *value,const size_t length)
+{
+  CacheInfo
+    *magick_restrict cache_info;
+
+  CacheMemoInfo
+    *memo_info;
+
+  MagickBooleanType
+    status;
+
+  assert(image != (const Image *) NULL);
+  assert(image->signature == MagickCoreSignature);
+  assert(image->cache != (Cache) NULL);
+  cache_info=(CacheInfo *) image->cache;
+  assert(cache_info->signature == MagickCoreSignature);
+  if ((cache_info->type == UndefinedCache) || (cache_info->type == PingCache))
+    return(MagickFalse);
+  memo_info=(CacheMemoInfo *) AcquireMagickMemory(sizeof(*memo_info));
+  if (memo_info == (CacheMemoInfo *) NULL)
+    return(MagickFalse);
+  (void) memset(memo_info,0,sizeof(*memo_info));
+  memo_info->value=AcquireMagickMemory(MagickMax(length,1));
+  if (memo_info->value == (void *) NULL)
+    {
+      memo_info=(CacheMemoInfo *) RelinquishMagickMemory(memo_info);
+      return(MagickFalse);
+    }
+  (void) memcpy(memo_info->value,value,length);
+  memo_info->length=length;
+  memo_info->storage_class=image->storage_class;
+  memo_info->colorspace=image->colorspace;
+  memo_info->alpha_trait=image->alpha_trait;
+  memo_info->channel_mask=image->channel_mask;
+  memo_info->columns=image->columns;
+  memo_info->rows=image->rows;
+  memo_info->number_channels=image->number_channels;
+  (void) memcpy(memo_info->channel_map,image->channel_map,
+    sizeof(memo_info->channel_map));
+  LockSemaphoreInfo(cache_info->semaphore);
+  if (cache_info->memo == (SplayTreeInfo *) NULL)
+    cache_info->memo=NewSplayTree(CompareSplayTreeString,
+      RelinquishMagickMemory,DestroyCacheMemo);
+  status=AddValueToSplayTree(cache_info->memo,ConstantString(key),memo_info);
+  UnlockSemaphoreInfo(cache_info->semaphore);
+  return(status);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -5412,6 +5999,7 @@ MagickPrivate MagickBooleanType SyncAuthenticPixelCacheNexus(Image *image,
   assert(cache_info->signature == MagickCoreSignature);
   if (cache_info->type == UndefinedCache)
     return(MagickFalse);
+  ModifyPixelCache(cache_info);
   if (image->mask_trait != UpdatePixelTrait)
     {
       if (((image->channels & WriteMaskChannel) != 0) &&
@@ -31,7 +31,8 @@ typedef enum
   DistributedCache,
   MapCache,
   MemoryCache,
-  PingCache
+  PingCache,
+  ViewCache
 } CacheType;
 
 extern MagickExport CacheType
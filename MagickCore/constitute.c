@@ -1243,6 +1243,7 @@ MagickExport MagickBooleanType WriteImage(const ImageInfo *image_info,
     *write_info;
 
   MagickBooleanType
+    compress,
     status,
     temporary;
 
@@ -1316,6 +1317,7 @@ MagickExport MagickBooleanType WriteImage(const ImageInfo *image_info,
         }
     }
   status=MagickFalse;
+  compress=MagickFalse;
   temporary=MagickFalse;
   if ((magick_info != (const MagickInfo *) NULL) &&
       (GetMagickEncoderSeekableStream(magick_info) != MagickFalse))
@@ -1337,6 +1339,7 @@ MagickExport MagickBooleanType WriteImage(const ImageInfo *image_info,
               (void) CopyMagickString(write_info->filename,image->filename,
                 MagickPathExtent);
               (void) AcquireUniqueFilename(image->filename);
+              compress=IsBlobCompressed(image);
               temporary=MagickTrue;
             }
           if (CloseBlob(image) == MagickFalse)
@@ -1433,23 +1436,46 @@ MagickExport MagickBooleanType WriteImage(const ImageInfo *image_info,
             }
         }
     }
-  if (temporary != MagickFalse)
+  if ((temporary != MagickFalse) && (compress != MagickFalse))
     {
+      char
+        temporary_filename[MagickPathExtent];
+
       /*
-        Copy temporary image file to permanent.
+        Copy temporary image file to permanent through a blob, so a
+        compressed filename is still compressed.
       */
-      status=OpenBlob(write_info,image,ReadBinaryBlobMode,exception);
+      (void) CopyMagickString(temporary_filename,image->filename,
+        MagickPathExtent);
+      (void) CopyMagickString(image->filename,write_info->filename,
+        MagickPathExtent);
+      status=OpenBlob(write_info,image,WriteBinaryBlobMode,exception);
       if (status != MagickFalse)
         {
-          (void) RelinquishUniqueFileResource(write_info->filename);
-          status=ImageToFile(image,write_info->filename,exception);
+          status=FileToImage(image,temporary_filename,exception);
+          if (CloseBlob(image) == MagickFalse)
+            status=MagickFalse;
         }
-      if (CloseBlob(image) == MagickFalse)
-        status=MagickFalse;
-      (void) RelinquishUniqueFileResource(image->filename);
-      (void) CopyMagickString(image->filename,write_info->filename,
-        MagickPathExtent);
+      (void) RelinquishUniqueFileResource(temporary_filename);
     }
+  else
+    if (temporary != MagickFalse)
+      {
+        /*
+          Copy temporary image file to permanent.
+        */
+        status=OpenBlob(write_info,image,ReadBinaryBlobMode,exception);
+        if (status != MagickFalse)
+          {
+            (void) RelinquishUniqueFileResource(write_info->filename);
+            status=ImageToFile(image,write_info->filename,exception);
+          }
+        if (CloseBlob(image) == MagickFalse)
+          status=MagickFalse;
+        (void) RelinquishUniqueFileResource(image->filename);
+        (void) CopyMagickString(image->filename,write_info->filename,
+          MagickPathExtent);
+      }
   if ((LocaleCompare(write_info->magick,"info") != 0) &&
       (write_info->verbose != MagickFalse))
     (void) IdentifyImage(image,stdout,MagickFalse,exception);
@@ -2466,6 +2466,14 @@ MagickExport Image *DistortImage(const Image *image, DistortMethod method,
     GetPixelInfo(distort_image,&zero);
     resample_filter=AcquireResampleFilterTLS(image,UndefinedVirtualPixelMethod,
       MagickFalse,exception);
+    if ((method == AffineDistortion) || (method == RigidAffineDistortion))
+      {
+        /*
+          Affine scaling vectors are constant, so the EWA ellipse is set once.
+        */
+        for (j=0; j < (ssize_t) GetMagickResourceLimit(ThreadResource); j++)
+          ScaleFilter(resample_filter[j],coeff[0],coeff[1],coeff[3],coeff[4]);
+      }
     distort_view=AcquireAuthenticCacheView(distort_image,exception);
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
     #pragma omp parallel for schedule(static) shared(progress,status) \
@@ -2486,6 +2494,7 @@ MagickExport Image *DistortImage(const Image *image, DistortMethod method,
         pixel;    /* pixel color to assign to distorted image */
 
       PointInfo
+        affine,
         d,
         s;  /* transform destination image x,y  to source image x,y */
 
@@ -2503,21 +2512,12 @@ MagickExport Image *DistortImage(const Image *image, DistortMethod method,
           continue;
         }
       pixel=zero;
-
-      /* Define constant scaling vectors for Affine Distortions
-        Other methods are either variable, or use interpolated lookup
+      /*
+        Affine mappings are linear, so the row term is constant along a row.
       */
-      switch (method)
-      {
-        case AffineDistortion:
-        case RigidAffineDistortion:
-          ScaleFilter( resample_filter[id],
-            coeff[0], coeff[1],
-            coeff[3], coeff[4] );
-          break;
-        default:
-          break;
-      }
+      d.y=(double) (geometry.y+j+0.5)*output_scaling;
+      affine.x=coeff[1]*d.y;
+      affine.y=coeff[4]*d.y;
 
       /* Initialize default pixel validity
       *    negative:         pixel is invalid  output 'matte_color'
@@ -2537,8 +2537,8 @@ MagickExport Image *DistortImage(const Image *image, DistortMethod method,
           case AffineDistortion:
           case RigidAffineDistortion:
           {
-            s.x=coeff[0]*d.x+coeff[1]*d.y+coeff[2];
-            s.y=coeff[3]*d.x+coeff[4]*d.y+coeff[5];
+            s.x=coeff[0]*d.x+affine.x+coeff[2];
+            s.y=coeff[3]*d.x+affine.y+coeff[5];
             /* Affine partial derivatives are constant -- set above */
             break;
           }
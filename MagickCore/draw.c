@@ -139,6 +139,20 @@ typedef struct _ElementInfo
     angle;
 } ElementInfo;
 
+typedef struct _GradientOffsetInfo
+{
+  PointInfo
+    vector;
+
+  double
+    reciprocal_length,
+    cosine,
+    sine;
+
+  PointInfo
+    reciprocal_radii;
+} GradientOffsetInfo;
+
 typedef struct _MVGInfo
 {
   PrimitiveInfo
@@ -1934,37 +1948,25 @@ static MagickBooleanType DrawDashPolygon(const DrawInfo *draw_info,
 */
 
 static inline double GetStopColorOffset(const GradientInfo *gradient,
-  const ssize_t x,const ssize_t y)
+  const GradientOffsetInfo *gradient_offset,const ssize_t x,const ssize_t y)
 {
   switch (gradient->type)
   {
     case UndefinedGradient:
     case LinearGradient:
     {
-      double
-        gamma,
-        length,
-        offset,
-        scale;
-
-      PointInfo
-        p,
-        q;
-
       const SegmentInfo
         *gradient_vector;
 
+      /*
+        The projection onto the gradient vector is linear in x and y.  It
+        may differ from the normalized dot product in the last bit of an
+        HDRI pixel, never by a quantum.
+      */
       gradient_vector=(&gradient->gradient_vector);
-      p.x=gradient_vector->x2-gradient_vector->x1;
-      p.y=gradient_vector->y2-gradient_vector->y1;
-      q.x=(double) x-gradient_vector->x1;
-      q.y=(double) y-gradient_vector->y1;
-      length=sqrt(q.x*q.x+q.y*q.y);
-      gamma=sqrt(p.x*p.x+p.y*p.y)*length;
-      gamma=PerceptibleReciprocal(gamma);
-      scale=p.x*q.x+p.y*q.y;
-      offset=gamma*scale*length;
-      return(offset);
+      return((gradient_offset->vector.x*((double) x-gradient_vector->x1)+
+        gradient_offset->vector.y*((double) y-gradient_vector->y1))*
+        gradient_offset->reciprocal_length);
     }
     case RadialGradient:
     {
@@ -1977,18 +1979,27 @@ static inline double GetStopColorOffset(const GradientInfo *gradient,
           v.y=(double) y-gradient->center.y;
           return(sqrt(v.x*v.x+v.y*v.y));
         }
-      v.x=(double) (((x-gradient->center.x)*cos(DegreesToRadians(
-        gradient->angle)))+((y-gradient->center.y)*sin(DegreesToRadians(
-        gradient->angle))))*PerceptibleReciprocal(gradient->radii.x);
-      v.y=(double) (((x-gradient->center.x)*sin(DegreesToRadians(
-        gradient->angle)))-((y-gradient->center.y)*cos(DegreesToRadians(
-        gradient->angle))))*PerceptibleReciprocal(gradient->radii.y);
+      v.x=(double) (((x-gradient->center.x)*gradient_offset->cosine)+
+        ((y-gradient->center.y)*gradient_offset->sine))*
+        gradient_offset->reciprocal_radii.x;
+      v.y=(double) (((x-gradient->center.x)*gradient_offset->sine)-
+        ((y-gradient->center.y)*gradient_offset->cosine))*
+        gradient_offset->reciprocal_radii.y;
       return(sqrt(v.x*v.x+v.y*v.y));
     }
   }
   return(0.0);
 }
 
+static inline MagickBooleanType IsGradientPixelEquivalent(const PixelInfo *p,
+  const PixelInfo *q)
+{
+  if ((p->red != q->red) || (p->green != q->green) || (p->blue != q->blue) ||
+      (p->black != q->black) || (p->alpha != q->alpha))
+    return(MagickFalse);
+  return(MagickTrue);
+}
+
 static int StopInfoCompare(const void *x,const void *y)
 {
   StopInfo
@@ -2019,6 +2030,9 @@ MagickExport MagickBooleanType DrawGradientImage(Image *image,
   double
     length;
 
+  GradientOffsetInfo
+    gradient_offset;
+
   MagickBooleanType
     status;
 
@@ -2035,6 +2049,8 @@ MagickExport MagickBooleanType DrawGradientImage(Image *image,
     height;
 
   ssize_t
+    start_x,
+    start_y,
     y;
 
   /*
@@ -2052,6 +2068,18 @@ MagickExport MagickBooleanType DrawGradientImage(Image *image,
   point.x=gradient_vector->x2-gradient_vector->x1;
   point.y=gradient_vector->y2-gradient_vector->y1;
   length=sqrt(point.x*point.x+point.y*point.y);
+  /*
+    Precompute the per-gradient terms of the stop offset once rather than for
+    each pixel.
+  */
+  gradient_offset.vector=point;
+  gradient_offset.reciprocal_length=PerceptibleReciprocal(length);
+  gradient_offset.cosine=cos(DegreesToRadians(gradient->angle));
+  gradient_offset.sine=sin(DegreesToRadians(gradient->angle));
+  gradient_offset.reciprocal_radii.x=PerceptibleReciprocal(gradient->radii.x);
+  gradient_offset.reciprocal_radii.y=PerceptibleReciprocal(gradient->radii.y);
+  start_x=CastDoubleToLong(ceil(gradient_vector->x1-0.5));
+  start_y=CastDoubleToLong(ceil(gradient_vector->y1-0.5));
   bounding_box=gradient->bounding_box;
   status=MagickTrue;
   GetPixelInfo(image,&zero);
@@ -2065,11 +2093,19 @@ MagickExport MagickBooleanType DrawGradientImage(Image *image,
   {
     double
       alpha,
-      offset;
+      offset,
+      stop_offset;
+
+    MagickBooleanType
+      blend,
+      cached_offset,
+      cached_pixel;
 
     PixelInfo
       composite,
-      pixel;
+      pixel,
+      result,
+      source;
 
     Quantum
       *magick_restrict q;
@@ -2093,146 +2129,184 @@ MagickExport MagickBooleanType DrawGradientImage(Image *image,
       }
     pixel=zero;
     composite=zero;
-    offset=GetStopColorOffset(gradient,0,y);
+    result=zero;
+    source=zero;
+    offset=GetStopColorOffset(gradient,&gradient_offset,0,y);
     if (gradient->type != RadialGradient)
       offset*=PerceptibleReciprocal(length);
+    stop_offset=offset;
+    cached_offset=MagickFalse;
+    cached_pixel=MagickFalse;
     width=(size_t) (bounding_box.x+(ssize_t) bounding_box.width);
     for (x=bounding_box.x; x < (ssize_t) width; x++)
     {
-      GetPixelInfoPixel(image,q,&pixel);
-      switch (gradient->spread)
-      {
-        case UndefinedSpread:
-        case PadSpread:
+      MagickBooleanType
+        update;
+
+      /*
+        Gradients constant along a row (e.g. the default vertical gradient)
+        yield the same stop offset for each pixel: reuse the stop color and,
+        if the destination pixel is unchanged too, the composited result.
+      */
+      update=(x != start_x) || (y != start_y) ? MagickTrue : MagickFalse;
+      blend=MagickTrue;
+      if (update != MagickFalse)
         {
-          if ((x != CastDoubleToLong(ceil(gradient_vector->x1-0.5))) ||
-              (y != CastDoubleToLong(ceil(gradient_vector->y1-0.5))))
-            {
-              offset=GetStopColorOffset(gradient,x,y);
-              if (gradient->type != RadialGradient)
-                offset*=PerceptibleReciprocal(length);
-            }
-          for (i=0; i < (ssize_t) gradient->number_stops; i++)
-            if (offset < gradient->stops[i].offset)
-              break;
-          if ((offset < 0.0) || (i == 0))
-            composite=gradient->stops[0].color;
-          else
-            if ((offset > 1.0) || (i == (ssize_t) gradient->number_stops))
-              composite=gradient->stops[gradient->number_stops-1].color;
-            else
-              {
-                j=i;
-                i--;
-                alpha=(offset-gradient->stops[i].offset)/
-                  (gradient->stops[j].offset-gradient->stops[i].offset);
-                CompositePixelInfoBlend(&gradient->stops[i].color,1.0-alpha,
-                  &gradient->stops[j].color,alpha,&composite);
-              }
-          break;
+          double
+            next_offset;
+
+          next_offset=GetStopColorOffset(gradient,&gradient_offset,x,y);
+          if ((cached_offset != MagickFalse) && (next_offset == stop_offset))
+            blend=MagickFalse;
+          stop_offset=next_offset;
         }
-        case ReflectSpread:
+      if (blend != MagickFalse)
+        switch (gradient->spread)
         {
-          if ((x != CastDoubleToLong(ceil(gradient_vector->x1-0.5))) ||
-              (y != CastDoubleToLong(ceil(gradient_vector->y1-0.5))))
-            {
-              offset=GetStopColorOffset(gradient,x,y);
-              if (gradient->type != RadialGradient)
-                offset*=PerceptibleReciprocal(length);
-            }
-          if (offset < 0.0)
-            offset=(-offset);
-          if ((ssize_t) fmod(offset,2.0) == 0)
-            offset=fmod(offset,1.0);
-          else
-            offset=1.0-fmod(offset,1.0);
-          for (i=0; i < (ssize_t) gradient->number_stops; i++)
-            if (offset < gradient->stops[i].offset)
-              break;
-          if (i == 0)
-            composite=gradient->stops[0].color;
-          else
-            if (i == (ssize_t) gradient->number_stops)
-              composite=gradient->stops[gradient->number_stops-1].color;
-            else
+          case UndefinedSpread:
+          case PadSpread:
+          {
+            if (update != MagickFalse)
               {
-                j=i;
-                i--;
-                alpha=(offset-gradient->stops[i].offset)/
-                  (gradient->stops[j].offset-gradient->stops[i].offset);
-                CompositePixelInfoBlend(&gradient->stops[i].color,1.0-alpha,
-                  &gradient->stops[j].color,alpha,&composite);
+                offset=stop_offset;
+                if (gradient->type != RadialGradient)
+                  offset*=PerceptibleReciprocal(length);
               }
-          break;
-        }
-        case RepeatSpread:
-        {
-          double
-            repeat;
-
-          MagickBooleanType
-            antialias;
-
-          antialias=MagickFalse;
-          repeat=0.0;
-          if ((x != CastDoubleToLong(ceil(gradient_vector->x1-0.5))) ||
-              (y != CastDoubleToLong(ceil(gradient_vector->y1-0.5))))
-            {
-              offset=GetStopColorOffset(gradient,x,y);
-              if (gradient->type == LinearGradient)
+            for (i=0; i < (ssize_t) gradient->number_stops; i++)
+              if (offset < gradient->stops[i].offset)
+                break;
+            if ((offset < 0.0) || (i == 0))
+              composite=gradient->stops[0].color;
+            else
+              if ((offset > 1.0) || (i == (ssize_t) gradient->number_stops))
+                composite=gradient->stops[gradient->number_stops-1].color;
+              else
                 {
-                  repeat=fmod(offset,length);
-                  if (repeat < 0.0)
-                    repeat=length-fmod(-repeat,length);
-                  else
-                    repeat=fmod(offset,length);
-                  antialias=(repeat < length) && ((repeat+1.0) > length) ?
-                    MagickTrue : MagickFalse;
-                  offset=PerceptibleReciprocal(length)*repeat;
+                  j=i;
+                  i--;
+                  alpha=(offset-gradient->stops[i].offset)/
+                    (gradient->stops[j].offset-gradient->stops[i].offset);
+                  CompositePixelInfoBlend(&gradient->stops[i].color,1.0-alpha,
+                    &gradient->stops[j].color,alpha,&composite);
                 }
+            break;
+          }
+          case ReflectSpread:
+          {
+            if (update != MagickFalse)
+              {
+                offset=stop_offset;
+                if (gradient->type != RadialGradient)
+                  offset*=PerceptibleReciprocal(length);
+              }
+            if (offset < 0.0)
+              offset=(-offset);
+            if ((ssize_t) fmod(offset,2.0) == 0)
+              offset=fmod(offset,1.0);
+            else
+              offset=1.0-fmod(offset,1.0);
+            for (i=0; i < (ssize_t) gradient->number_stops; i++)
+              if (offset < gradient->stops[i].offset)
+                break;
+            if (i == 0)
+              composite=gradient->stops[0].color;
+            else
+              if (i == (ssize_t) gradient->number_stops)
+                composite=gradient->stops[gradient->number_stops-1].color;
               else
                 {
-                  repeat=fmod(offset,gradient->radius);
-                  if (repeat < 0.0)
-                    repeat=gradient->radius-fmod(-repeat,gradient->radius);
-                  else
-                    repeat=fmod(offset,gradient->radius);
-                  antialias=repeat+1.0 > gradient->radius ? MagickTrue :
-                    MagickFalse;
-                  offset=repeat*PerceptibleReciprocal(gradient->radius);
+                  j=i;
+                  i--;
+                  alpha=(offset-gradient->stops[i].offset)/
+                    (gradient->stops[j].offset-gradient->stops[i].offset);
+                  CompositePixelInfoBlend(&gradient->stops[i].color,1.0-alpha,
+                    &gradient->stops[j].color,alpha,&composite);
                 }
-            }
-          for (i=0; i < (ssize_t) gradient->number_stops; i++)
-            if (offset < gradient->stops[i].offset)
-              break;
-          if (i == 0)
-            composite=gradient->stops[0].color;
-          else
-            if (i == (ssize_t) gradient->number_stops)
-              composite=gradient->stops[gradient->number_stops-1].color;
-            else
+            break;
+          }
+          case RepeatSpread:
+          {
+            double
+              repeat;
+
+            MagickBooleanType
+              antialias;
+
+            antialias=MagickFalse;
+            repeat=0.0;
+            if (update != MagickFalse)
               {
-                j=i;
-                i--;
-                alpha=(offset-gradient->stops[i].offset)/
-                  (gradient->stops[j].offset-gradient->stops[i].offset);
-                if (antialias != MagickFalse)
+                offset=stop_offset;
+                if (gradient->type == LinearGradient)
                   {
-                    if (gradient->type == LinearGradient)
-                      alpha=length-repeat;
+                    repeat=fmod(offset,length);
+                    if (repeat < 0.0)
+                      repeat=length-fmod(-repeat,length);
                     else
-                      alpha=gradient->radius-repeat;
-                    i=0;
-                    j=(ssize_t) gradient->number_stops-1L;
+                      repeat=fmod(offset,length);
+                    antialias=(repeat < length) && ((repeat+1.0) > length) ?
+                      MagickTrue : MagickFalse;
+                    offset=PerceptibleReciprocal(length)*repeat;
+                  }
+                else
+                  {
+                    repeat=fmod(offset,gradient->radius);
+                    if (repeat < 0.0)
+                      repeat=gradient->radius-fmod(-repeat,gradient->radius);
+                    else
+                      repeat=fmod(offset,gradient->radius);
+                    antialias=repeat+1.0 > gradient->radius ? MagickTrue :
+                      MagickFalse;
+                    offset=repeat*PerceptibleReciprocal(gradient->radius);
                   }
-                CompositePixelInfoBlend(&gradient->stops[i].color,1.0-alpha,
-                  &gradient->stops[j].color,alpha,&composite);
               }
-          break;
+            for (i=0; i < (ssize_t) gradient->number_stops; i++)
+              if (offset < gradient->stops[i].offset)
+                break;
+            if (i == 0)
+              composite=gradient->stops[0].color;
+            else
+              if (i == (ssize_t) gradient->number_stops)
+                composite=gradient->stops[gradient->number_stops-1].color;
+              else
+                {
+                  j=i;
+                  i--;
+                  alpha=(offset-gradient->stops[i].offset)/
+                    (gradient->stops[j].offset-gradient->stops[i].offset);
+                  if (antialias != MagickFalse)
+                    {
+                      if (gradient->type == LinearGradient)
+                        alpha=length-repeat;
+                      else
+                        alpha=gradient->radius-repeat;
+                      i=0;
+                      j=(ssize_t) gradient->number_stops-1L;
+                    }
+                  CompositePixelInfoBlend(&gradient->stops[i].color,1.0-alpha,
+                    &gradient->stops[j].color,alpha,&composite);
+                }
+            break;
+          }
         }
-      }
+      /*
+        The stop color is only a function of the stop offset when the offset
+        was computed for this pixel.
+      */
+      cached_offset=update;
+      GetPixelInfoPixel(image,q,&pixel);
+      if ((blend == MagickFalse) && (cached_pixel != MagickFalse) &&
+          (IsGradientPixelEquivalent(&pixel,&source) != MagickFalse))
+        {
+          SetPixelViaPixelInfo(image,&result,q);
+          q+=(ptrdiff_t) GetPixelChannels(image);
+          continue;
+        }
+      source=pixel;
       CompositePixelInfoOver(&composite,composite.alpha,&pixel,pixel.alpha,
         &pixel);
+      result=pixel;
+      cached_pixel=MagickTrue;
       SetPixelViaPixelInfo(image,&pixel,q);
       q+=(ptrdiff_t) GetPixelChannels(image);
     }
@@ -41,12 +41,14 @@
   Include declarations.
 */
 #include "MagickCore/studio.h"
+#include "MagickCore/cache-private.h"
 #include "MagickCore/cache-view.h"
 #include "MagickCore/color-private.h"
 #include "MagickCore/enhance.h"
 #include "MagickCore/exception.h"
 #include "MagickCore/exception-private.h"
 #include "MagickCore/histogram.h"
+#include "MagickCore/image-private.h"
 #include "MagickCore/image.h"
 #include "MagickCore/linked-list.h"
 #include "MagickCore/list.h"
@@ -66,71 +68,40 @@
   Define declarations.
 */
 #define MaxTreeDepth  8
-#define HNodesInAList  1536
-
+#define MinimumColorTable  256
+
 /*
   Typedef declarations.
 */
-typedef struct _HNodeInfo
+typedef struct _HColorInfo
 {
-  struct _HNodeInfo
-    *child[16];
-
-  PixelInfo
-    *list;
-
-  size_t
-    extent;
+  Quantum
+    red,
+    green,
+    blue,
+    black,
+    alpha,
+    index;
 
   MagickSizeType
-    number_unique;
-
-  size_t
-    level;
-} HNodeInfo;
-
-typedef struct _HNodes
-{
-  HNodeInfo
-    nodes[HNodesInAList];
-
-  struct _HNodes
-    *next;
-} HNodes;
-
-typedef struct _HCubeInfo
-{
-  HNodeInfo
-    *root;
-
-  ssize_t
-    x;
+    count;
 
   MagickOffsetType
-    progress;
+    offset;
 
   size_t
-    colors,
-    free_nodes;
-
-  HNodeInfo
-    *node_info;
-
-  HNodes
-    *node_queue;
-} HCubeInfo;
-
-/*
-  Forward declarations.
-*/
-static HCubeInfo
-  *GetHCubeInfo(void);
+    id;
+} HColorInfo;
 
-static HNodeInfo
-  *GetHNodeInfo(HCubeInfo *,const size_t);
+typedef struct _HTableInfo
+{
+  HColorInfo
+    *colors;
 
-static void
-  DestroyColorCube(const Image *,HNodeInfo *);
+  size_t
+    extent,
+    number_colors;
+} HTableInfo;
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -143,255 +114,373 @@ static void
 %                                                                             %
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
-%  ClassifyImageColors() builds a populated HCubeInfo tree for the specified
-%  image.  The returned tree should be deallocated using DestroyHCubeInfo()
-%  once it is no longer needed.
+%  ClassifyImageColors() returns the unique colors of the image and their
+%  counts.  Each thread hashes the colors of its rows into a private open
+%  addressing table and the tables are then merged.  The colors are returned
+%  in no particular order, see SortImageColors().  The array should be
+%  deallocated with RelinquishMagickMemory() once it is no longer needed.
+%
+%  If the image has more than max_colors unique colors, the scan stops early
+%  and NULL is returned with number_colors set to max_colors+1.
 %
 %  The format of the ClassifyImageColors() method is:
 %
-%      HCubeInfo *ClassifyImageColors(const Image *image,
+%      HColorInfo *ClassifyImageColors(const Image *image,
+%        const size_t max_colors,size_t *number_colors,
 %        ExceptionInfo *exception)
 %
 %  A description of each parameter follows.
 %
 %    o image: the image.
 %
+%    o max_colors: stop once there are more unique colors than this.
+%
+%    o number_colors: the number of unique colors is returned here.
+%
 %    o exception: return any errors or warnings in this structure.
 %
 */
 
-static inline size_t ColorToNodeId(const PixelInfo *pixel,size_t index)
+static HTableInfo *AcquireHTableInfo(const size_t extent)
+{
+  HTableInfo
+    *table_info;
+
+  table_info=(HTableInfo *) AcquireMagickMemory(sizeof(*table_info));
+  if (table_info == (HTableInfo *) NULL)
+    return((HTableInfo *) NULL);
+  table_info->extent=extent;
+  table_info->number_colors=0;
+  table_info->colors=(HColorInfo *) AcquireQuantumMemory(extent,
+    sizeof(*table_info->colors));
+  if (table_info->colors == (HColorInfo *) NULL)
+    return((HTableInfo *) RelinquishMagickMemory(table_info));
+  (void) memset(table_info->colors,0,extent*sizeof(*table_info->colors));
+  return(table_info);
+}
+
+static HTableInfo *DestroyHTableInfo(HTableInfo *table_info)
+{
+  table_info->colors=(HColorInfo *) RelinquishMagickMemory(table_info->colors);
+  return((HTableInfo *) RelinquishMagickMemory(table_info));
+}
+
+static HTableInfo **DestroyHTableTLS(HTableInfo **table_info)
+{
+  ssize_t
+    i;
+
+  for (i=0; i < (ssize_t) GetMagickResourceLimit(ThreadResource); i++)
+    if (table_info[i] != (HTableInfo *) NULL)
+      table_info[i]=DestroyHTableInfo(table_info[i]);
+  return((HTableInfo **) RelinquishMagickMemory(table_info));
+}
+
+static HTableInfo **AcquireHTableTLS(void)
 {
+  HTableInfo
+    **table_info;
+
+  ssize_t
+    i;
+
   size_t
-    id;
+    number_threads;
+
+  number_threads=(size_t) GetMagickResourceLimit(ThreadResource);
+  table_info=(HTableInfo **) AcquireQuantumMemory(number_threads,
+    sizeof(*table_info));
+  if (table_info == (HTableInfo **) NULL)
+    return((HTableInfo **) NULL);
+  (void) memset(table_info,0,number_threads*sizeof(*table_info));
+  for (i=0; i < (ssize_t) number_threads; i++)
+  {
+    table_info[i]=AcquireHTableInfo(MinimumColorTable);
+    if (table_info[i] == (HTableInfo *) NULL)
+      return(DestroyHTableTLS(table_info));
+  }
+  return(table_info);
+}
 
-  id=(size_t) (
-    ((ScaleQuantumToChar(ClampToQuantum(pixel->red)) >> index) & 0x01) |
-    ((ScaleQuantumToChar(ClampToQuantum(pixel->green)) >> index) & 0x01) << 1 |
-    ((ScaleQuantumToChar(ClampToQuantum(pixel->blue)) >> index) & 0x01) << 2);
-  if (pixel->alpha_trait != UndefinedPixelTrait)
-    id|=((size_t) ((ScaleQuantumToChar(ClampToQuantum(pixel->alpha)) >> index) &
-      0x01) << 3);
-  return(id);
+static inline MagickSizeType HashQuantum(const MagickSizeType hash,
+  const Quantum quantum)
+{
+  double
+    value;
+
+  MagickSizeType
+    key;
+
+  value=(double) quantum;
+  if (value == 0.0)
+    value=0.0;  /* fold negative zero */
+  if (IsNaN(value) != 0)
+    value=(double) NAN;
+  (void) memcpy(&key,&value,sizeof(key));
+  key=(hash ^ key)*0x9e3779b97f4a7c15ULL;
+  return(key ^ (key >> 32));
 }
 
-static inline MagickBooleanType IsPixelInfoColorMatch(
-  const PixelInfo *magick_restrict p,const PixelInfo *magick_restrict q)
+static inline size_t HashHColor(const HColorInfo *color,
+  const MagickBooleanType cmyk)
 {
-  MagickRealType
-    alpha,
-    beta;
+  MagickSizeType
+    hash;
+
+  hash=0;
+  hash=HashQuantum(hash,color->red);
+  hash=HashQuantum(hash,color->green);
+  hash=HashQuantum(hash,color->blue);
+  hash=HashQuantum(hash,color->alpha);
+  if (cmyk != MagickFalse)
+    hash=HashQuantum(hash,color->black);
+  hash*=0xff51afd7ed558ccdULL;
+  return((size_t) (hash ^ (hash >> 33)));
+}
 
-  alpha=p->alpha_trait == UndefinedPixelTrait ? (MagickRealType) OpaqueAlpha :
-    p->alpha;
-  beta=q->alpha_trait == UndefinedPixelTrait ? (MagickRealType) OpaqueAlpha :
-    q->alpha;
-  if (AbsolutePixelValue(alpha-beta) >= MagickEpsilon)
-    return(MagickFalse);
-  if (AbsolutePixelValue(p->red-q->red) >= MagickEpsilon)
-    return(MagickFalse);
-  if (AbsolutePixelValue(p->green-q->green) >= MagickEpsilon)
+static inline MagickBooleanType IsQuantumMatch(const Quantum p,
+  const Quantum q)
+{
+  if (p == q)
+    return(MagickTrue);
+  if ((IsNaN((double) p) != 0) && (IsNaN((double) q) != 0))
+    return(MagickTrue);
+  return(MagickFalse);
+}
+
+static inline MagickBooleanType IsHColorMatch(const HColorInfo *p,
+  const HColorInfo *q,const MagickBooleanType cmyk)
+{
+  if ((IsQuantumMatch(p->red,q->red) == MagickFalse) ||
+      (IsQuantumMatch(p->green,q->green) == MagickFalse) ||
+      (IsQuantumMatch(p->blue,q->blue) == MagickFalse) ||
+      (IsQuantumMatch(p->alpha,q->alpha) == MagickFalse))
     return(MagickFalse);
-  if (AbsolutePixelValue(p->blue-q->blue) >= MagickEpsilon)
+  if ((cmyk != MagickFalse) &&
+      (IsQuantumMatch(p->black,q->black) == MagickFalse))
     return(MagickFalse);
-  if (p->colorspace == CMYKColorspace)
+  return(MagickTrue);
+}
+
+static MagickBooleanType InsertHColor(HTableInfo *table_info,
+  const HColorInfo *color,const MagickBooleanType cmyk)
+{
+  HColorInfo
+    *q;
+
+  size_t
+    i;
+
+  if (table_info->number_colors >= (table_info->extent >> 1))
     {
-      if (AbsolutePixelValue(p->black-q->black) >= MagickEpsilon)
+      HTableInfo
+        *resize_info;
+
+      /*
+        Keep the load factor under one half.
+      */
+      resize_info=AcquireHTableInfo(table_info->extent << 1);
+      if (resize_info == (HTableInfo *) NULL)
         return(MagickFalse);
+      for (i=0; i < table_info->extent; i++)
+        if (table_info->colors[i].count != 0)
+          (void) InsertHColor(resize_info,table_info->colors+i,cmyk);
+      table_info->colors=(HColorInfo *) RelinquishMagickMemory(
+        table_info->colors);
+      *table_info=(*resize_info);
+      resize_info=(HTableInfo *) RelinquishMagickMemory(resize_info);
+    }
+  i=HashHColor(color,cmyk) & (table_info->extent-1);
+  for ( ; ; i=(i+1) & (table_info->extent-1))
+  {
+    q=table_info->colors+i;
+    if (q->count == 0)
+      {
+        *q=(*color);
+        table_info->number_colors++;
+        return(MagickTrue);
+      }
+    if (IsHColorMatch(q,color,cmyk) != MagickFalse)
+      break;
+  }
+  q->count+=color->count;
+  if (color->offset < q->offset)
+    {
+      q->offset=color->offset;
+      q->index=color->index;
+      if (cmyk == MagickFalse)
+        q->black=color->black;
     }
   return(MagickTrue);
 }
 
-
-static HCubeInfo *ClassifyImageColors(const Image *image,
-  ExceptionInfo *exception)
+static HColorInfo *ClassifyImageColors(const Image *image,
+  const size_t max_colors,size_t *number_colors,ExceptionInfo *exception)
 {
 #define EvaluateImageTag  "  Compute image colors...  "
 
   CacheView
     *image_view;
 
-  HCubeInfo
-    *cube_info;
+  HColorInfo
+    *colors;
 
-  MagickBooleanType
-    proceed;
+  HTableInfo
+    **table_info;
 
-  PixelInfo
-    pixel;
-
-  HNodeInfo
-    *node_info;
+  MagickBooleanType
+    cmyk,
+    exceeded,
+    status;
 
-  const Quantum
-    *p;
+  MagickOffsetType
+    progress;
 
   size_t
-    id,
-    index,
-    level;
+    number_threads;
 
   ssize_t
     i,
-    x;
-
-  ssize_t
+    j,
     y;
 
-  /*
-    Initialize color description tree.
-  */
   assert(image != (const Image *) NULL);
   assert(image->signature == MagickCoreSignature);
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",image->filename);
-  cube_info=GetHCubeInfo();
-  if (cube_info == (HCubeInfo *) NULL)
+  *number_colors=0;
+  table_info=AcquireHTableTLS();
+  if (table_info == (HTableInfo **) NULL)
     {
       (void) ThrowMagickException(exception,GetMagickModule(),
         ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
-      return(cube_info);
+      return((HColorInfo *) NULL);
     }
-  GetPixelInfo(image,&pixel);
+  cmyk=image->colorspace == CMYKColorspace ? MagickTrue : MagickFalse;
+  status=MagickTrue;
+  exceeded=MagickFalse;
+  progress=0;
   image_view=AcquireVirtualCacheView(image,exception);
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(static) shared(exceeded,progress,status) \
+    magick_number_threads(image,image,image->rows,1)
+#endif
   for (y=0; y < (ssize_t) image->rows; y++)
   {
+    const int
+      id = GetOpenMPThreadId();
+
+    const Quantum
+      *magick_restrict p;
+
+    HColorInfo
+      color;
+
+    ssize_t
+      x;
+
+    if ((status == MagickFalse) || (exceeded != MagickFalse))
+      continue;
     p=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
     if (p == (const Quantum *) NULL)
-      break;
-    for (x=0; x < (ssize_t) image->columns; x++)
-    {
-      /*
-        Start at the root and proceed level by level.
-      */
-      node_info=cube_info->root;
-      index=MaxTreeDepth-1;
-      for (level=1; level < MaxTreeDepth; level++)
       {
-        GetPixelInfoPixel(image,p,&pixel);
-        id=ColorToNodeId(&pixel,index);
-        if (node_info->child[id] == (HNodeInfo *) NULL)
-          {
-            node_info->child[id]=GetHNodeInfo(cube_info,level);
-            if (node_info->child[id] == (HNodeInfo *) NULL)
-              {
-                (void) ThrowMagickException(exception,GetMagickModule(),
-                  ResourceLimitError,"MemoryAllocationFailed","`%s'",
-                  image->filename);
-                return(0);
-              }
-          }
-        node_info=node_info->child[id];
-        index--;
+        status=MagickFalse;
+        continue;
       }
-      for (i=0; i < (ssize_t) node_info->number_unique; i++)
-        if (IsPixelInfoColorMatch(&pixel,node_info->list+i) != MagickFalse)
+    (void) memset(&color,0,sizeof(color));
+    color.count=1;
+    for (x=0; x < (ssize_t) image->columns; x++)
+    {
+      color.red=GetPixelRed(image,p);
+      color.green=GetPixelGreen(image,p);
+      color.blue=GetPixelBlue(image,p);
+      color.black=GetPixelBlack(image,p);
+      color.alpha=GetPixelAlpha(image,p);
+      color.index=GetPixelIndex(image,p);
+      color.offset=(MagickOffsetType) y*(MagickOffsetType) image->columns+x;
+      if (InsertHColor(table_info[id],&color,cmyk) == MagickFalse)
+        {
+          (void) ThrowMagickException(exception,GetMagickModule(),
+            ResourceLimitError,"MemoryAllocationFailed","`%s'",
+            image->filename);
+          status=MagickFalse;
           break;
-      if (i < (ssize_t) node_info->number_unique)
-        node_info->list[i].count++;
-      else
+        }
+      if (table_info[id]->number_colors > max_colors)
         {
-          if (node_info->number_unique == 0)
-            {
-              node_info->extent=1;
-              node_info->list=(PixelInfo *) AcquireQuantumMemory(
-                node_info->extent,sizeof(*node_info->list));
-            }
-          else
-            if (i >= (ssize_t) node_info->extent)
-              {
-                node_info->extent<<=1;
-                node_info->list=(PixelInfo *) ResizeQuantumMemory(
-                  node_info->list,node_info->extent,sizeof(*node_info->list));
-              }
-          if (node_info->list == (PixelInfo *) NULL)
-            {
-              (void) ThrowMagickException(exception,GetMagickModule(),
-                ResourceLimitError,"MemoryAllocationFailed","`%s'",
-                image->filename);
-              return(0);
-            }
-          node_info->list[i]=pixel;
-          node_info->list[i].red=(double) GetPixelRed(image,p);
-          node_info->list[i].green=(double) GetPixelGreen(image,p);
-          node_info->list[i].blue=(double) GetPixelBlue(image,p);
-          if (image->colorspace == CMYKColorspace)
-            node_info->list[i].black=(double) GetPixelBlack(image,p);
-          node_info->list[i].alpha=(double) GetPixelAlpha(image,p);
-          node_info->list[i].count=1;
-          node_info->number_unique++;
-          cube_info->colors++;
+          exceeded=MagickTrue;
+          break;
         }
       p+=(ptrdiff_t) GetPixelChannels(image);
     }
-    proceed=SetImageProgress(image,EvaluateImageTag,(MagickOffsetType) y,
-      image->rows);
-    if (proceed == MagickFalse)
-      break;
+    if (image->progress_monitor != (MagickProgressMonitor) NULL)
+      {
+        MagickBooleanType
+          proceed;
+
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+        #pragma omp atomic
+#endif
+        progress++;
+        proceed=SetImageProgress(image,EvaluateImageTag,progress,image->rows);
+        if (proceed == MagickFalse)
+          status=MagickFalse;
+      }
   }
   image_view=DestroyCacheView(image_view);
-  return(cube_info);
-}
-
-/*
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%                                                                             %
-%                                                                             %
-%                                                                             %
-+   D e f i n e I m a g e H i s t o g r a m                                   %
-%                                                                             %
-%                                                                             %
-%                                                                             %
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%
-%  DefineImageHistogram() traverses the color cube tree and notes each colormap
-%  entry.  A colormap entry is any node in the color cube tree where the
-%  of unique colors is not zero.
-%
-%  The format of the DefineImageHistogram method is:
-%
-%      DefineImageHistogram(const Image *image,HNodeInfo *node_info,
-%        PixelInfo **unique_colors)
-%
-%  A description of each parameter follows.
-%
-%    o image: the image.
-%
-%    o node_info: the address of a structure of type HNodeInfo which points to a
-%      node in the color cube tree that is to be pruned.
-%
-%    o histogram: the image histogram.
-%
-*/
-static void DefineImageHistogram(const Image *image,HNodeInfo *node_info,
-  PixelInfo **histogram)
-{
-  ssize_t
-    i;
-
-  size_t
-    number_children;
-
+  if ((status == MagickFalse) || (exceeded != MagickFalse))
+    {
+      table_info=DestroyHTableTLS(table_info);
+      if (exceeded != MagickFalse)
+        *number_colors=max_colors+1;
+      return((HColorInfo *) NULL);
+    }
   /*
-    Traverse any children.
+    Merge the thread tables into the largest one.
   */
-  number_children=image->alpha_trait == UndefinedPixelTrait ? 8UL : 16UL;
-  for (i=0; i < (ssize_t) number_children; i++)
-    if (node_info->child[i] != (HNodeInfo *) NULL)
-      DefineImageHistogram(image,node_info->child[i],histogram);
-  if (node_info->level == (MaxTreeDepth-1))
-    {
-      PixelInfo
-        *p;
+  number_threads=(size_t) GetMagickResourceLimit(ThreadResource);
+  j=0;
+  for (i=1; i < (ssize_t) number_threads; i++)
+    if (table_info[i]->number_colors > table_info[j]->number_colors)
+      j=i;
+  for (i=0; i < (ssize_t) number_threads; i++)
+  {
+    size_t
+      k;
 
-      p=node_info->list;
-      for (i=0; i < (ssize_t) node_info->number_unique; i++)
+    if ((i == j) || (table_info[i]->number_colors == 0))
+      continue;
+    for (k=0; k < table_info[i]->extent; k++)
+      if (table_info[i]->colors[k].count != 0)
+        if (InsertHColor(table_info[j],table_info[i]->colors+k,cmyk) ==
+            MagickFalse)
+          break;
+    if (k < table_info[i]->extent)
       {
-        **histogram=(*p);
-        (*histogram)++;
-        p++;
+        (void) ThrowMagickException(exception,GetMagickModule(),
+          ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
+        table_info=DestroyHTableTLS(table_info);
+        return((HColorInfo *) NULL);
       }
+    table_info[i]=DestroyHTableInfo(table_info[i]);
+  }
+  if (table_info[j]->number_colors > max_colors)
+    {
+      table_info=DestroyHTableTLS(table_info);
+      *number_colors=max_colors+1;
+      return((HColorInfo *) NULL);
     }
+  /*
+    Compact the table.
+  */
+  colors=table_info[j]->colors;
+  *number_colors=0;
+  for (i=0; i < (ssize_t) table_info[j]->extent; i++)
+    if (colors[i].count != 0)
+      colors[(*number_colors)++]=colors[i];
+  table_info[j]->colors=(HColorInfo *) NULL;
+  table_info=DestroyHTableTLS(table_info);
+  return(colors);
 }
 
 /*
@@ -399,130 +488,112 @@ static void DefineImageHistogram(const Image *image,HNodeInfo *node_info,
 %                                                                             %
 %                                                                             %
 %                                                                             %
-+   D e s t r o y C u b e I n f o                                             %
++   S o r t I m a g e C o l o r s                                             %
 %                                                                             %
 %                                                                             %
 %                                                                             %
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
-%  DestroyHCubeInfo() deallocates memory associated with a HCubeInfo structure.
+%  SortImageColors() sorts the colors returned by ClassifyImageColors() in
+%  color cube order: by the interleaved bits of the 8-bit red, green, blue,
+%  and alpha components, most significant first, then by first appearance.
 %
-%  The format of the DestroyHCubeInfo method is:
+%  The format of the SortImageColors method is:
 %
-%      DestroyHCubeInfo(const Image *image,HCubeInfo *cube_info)
+%      void SortImageColors(const Image *image,HColorInfo *colors,
+%        const size_t number_colors)
 %
-%  A description of each parameter follows:
+%  A description of each parameter follows.
 %
 %    o image: the image.
 %
-%    o cube_info: the address of a structure of type HCubeInfo.
+%    o colors: the image colors.
+%
+%    o number_colors: the number of colors.
 %
 */
-static HCubeInfo *DestroyHCubeInfo(const Image *image,HCubeInfo *cube_info)
+
+static inline size_t HColorToNodeId(const HColorInfo *color,
+  const MagickBooleanType alpha)
 {
-  HNodes
-    *nodes;
+  size_t
+    id,
+    index;
+
+  unsigned char
+    blue,
+    green,
+    opacity,
+    red;
 
   /*
-    Release color cube tree storage.
+    Concatenate the node ids on the color cube path to this color.
   */
-  DestroyColorCube(image,cube_info->root);
-  do
+  red=ScaleQuantumToChar(ClampToQuantum((MagickRealType) color->red));
+  green=ScaleQuantumToChar(ClampToQuantum((MagickRealType) color->green));
+  blue=ScaleQuantumToChar(ClampToQuantum((MagickRealType) color->blue));
+  opacity=ScaleQuantumToChar(ClampToQuantum((MagickRealType) color->alpha));
+  id=0;
+  for (index=MaxTreeDepth-1; index > 0; index--)
   {
-    nodes=cube_info->node_queue->next;
-    cube_info->node_queue=(HNodes *)
-      RelinquishMagickMemory(cube_info->node_queue);
-    cube_info->node_queue=nodes;
-  } while (cube_info->node_queue != (HNodes *) NULL);
-  return((HCubeInfo *) RelinquishMagickMemory(cube_info));
+    id<<=4;
+    id|=(size_t) (((red >> index) & 0x01) | ((green >> index) & 0x01) << 1 |
+      ((blue >> index) & 0x01) << 2);
+    if (alpha != MagickFalse)
+      id|=(size_t) ((opacity >> index) & 0x01) << 3;
+  }
+  return(id);
 }
-
-/*
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%                                                                             %
-%                                                                             %
-%                                                                             %
-+  D e s t r o y C o l o r C u b e                                            %
-%                                                                             %
-%                                                                             %
-%                                                                             %
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%
-%  DestroyColorCube() traverses the color cube tree and frees the list of
-%  unique colors.
-%
-%  The format of the DestroyColorCube method is:
-%
-%      void DestroyColorCube(const Image *image,const HNodeInfo *node_info)
-%
-%  A description of each parameter follows.
-%
-%    o image: the image.
-%
-%    o node_info: the address of a structure of type HNodeInfo which points to a
-%      node in the color cube tree that is to be pruned.
-%
-*/
-static void DestroyColorCube(const Image *image,HNodeInfo *node_info)
+
+#if defined(__cplusplus) || defined(c_plusplus)
+extern "C" {
+#endif
+
+static int HColorCompare(const void *x,const void *y)
 {
-  ssize_t
-    i;
+  const HColorInfo
+    *color_1,
+    *color_2;
 
-  size_t
-    number_children;
+  color_1=(const HColorInfo *) x;
+  color_2=(const HColorInfo *) y;
+  if (color_1->id != color_2->id)
+    return(color_1->id < color_2->id ? -1 : 1);
+  if (color_1->offset != color_2->offset)
+    return(color_1->offset < color_2->offset ? -1 : 1);
+  return(0);
+}
 
-  /*
-    Traverse any children.
-  */
-  number_children=image->alpha_trait == UndefinedPixelTrait ? 8UL : 16UL;
-  for (i=0; i < (ssize_t) number_children; i++)
-    if (node_info->child[i] != (HNodeInfo *) NULL)
-      DestroyColorCube(image,node_info->child[i]);
-  if (node_info->list != (PixelInfo *) NULL)
-    node_info->list=(PixelInfo *) RelinquishMagickMemory(node_info->list);
+#if defined(__cplusplus) || defined(c_plusplus)
 }
-
-/*
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%                                                                             %
-%                                                                             %
-%                                                                             %
-+   G e t C u b e I n f o                                                     %
-%                                                                             %
-%                                                                             %
-%                                                                             %
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%
-%  GetHCubeInfo() initializes the HCubeInfo data structure.
-%
-%  The format of the GetHCubeInfo method is:
-%
-%      cube_info=GetHCubeInfo()
-%
-%  A description of each parameter follows.
-%
-%    o cube_info: A pointer to the Cube structure.
-%
-*/
-static HCubeInfo *GetHCubeInfo(void)
+#endif
+
+static void SortImageColors(const Image *image,HColorInfo *colors,
+  const size_t number_colors)
 {
-  HCubeInfo
-    *cube_info;
+  MagickBooleanType
+    alpha;
 
-  /*
-    Initialize tree to describe color cube.
-  */
-  cube_info=(HCubeInfo *) AcquireMagickMemory(sizeof(*cube_info));
-  if (cube_info == (HCubeInfo *) NULL)
-    return((HCubeInfo *) NULL);
-  (void) memset(cube_info,0,sizeof(*cube_info));
-  /*
-    Initialize root node.
-  */
-  cube_info->root=GetHNodeInfo(cube_info,0);
-  if (cube_info->root == (HNodeInfo *) NULL)
-    return((HCubeInfo *) NULL);
-  return(cube_info);
+  ssize_t
+    i;
+
+  alpha=image->alpha_trait != UndefinedPixelTrait ? MagickTrue : MagickFalse;
+  for (i=0; i < (ssize_t) number_colors; i++)
+    colors[i].id=HColorToNodeId(colors+i,alpha);
+  qsort((void *) colors,number_colors,sizeof(*colors),HColorCompare);
+}
+
+static void HColorToPixelInfo(const Image *image,const HColorInfo *color,
+  PixelInfo *pixel)
+{
+  GetPixelInfo(image,pixel);
+  pixel->red=(MagickRealType) color->red;
+  pixel->green=(MagickRealType) color->green;
+  pixel->blue=(MagickRealType) color->blue;
+  pixel->black=(MagickRealType) color->black;
+  pixel->alpha=(MagickRealType) color->alpha;
+  pixel->index=(MagickRealType) color->index;
+  pixel->count=color->count;
 }
 
 /*
@@ -555,32 +626,33 @@ static HCubeInfo *GetHCubeInfo(void)
 MagickExport PixelInfo *GetImageHistogram(const Image *image,
   size_t *number_colors,ExceptionInfo *exception)
 {
+  HColorInfo
+    *colors;
+
   PixelInfo
     *histogram;
 
-  HCubeInfo
-    *cube_info;
+  ssize_t
+    i;
 
   *number_colors=0;
   histogram=(PixelInfo *) NULL;
-  cube_info=ClassifyImageColors(image,exception);
-  if (cube_info != (HCubeInfo *) NULL)
+  colors=ClassifyImageColors(image,MAGICK_SIZE_MAX,number_colors,exception);
+  if (colors != (HColorInfo *) NULL)
     {
-      histogram=(PixelInfo *) AcquireQuantumMemory((size_t) cube_info->colors+1,
+      SortImageColors(image,colors,*number_colors);
+      histogram=(PixelInfo *) AcquireQuantumMemory((size_t) *number_colors+1,
         sizeof(*histogram));
       if (histogram == (PixelInfo *) NULL)
-        (void) ThrowMagickException(exception,GetMagickModule(),
-          ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
-      else
         {
-          PixelInfo
-            *root;
-
-          *number_colors=cube_info->colors;
-          root=histogram;
-          DefineImageHistogram(image,cube_info->root,&root);
+          (void) ThrowMagickException(exception,GetMagickModule(),
+            ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
+          *number_colors=0;
         }
-      cube_info=DestroyHCubeInfo(image,cube_info);
+      else
+        for (i=0; i < (ssize_t) *number_colors; i++)
+          HColorToPixelInfo(image,colors+i,histogram+i);
+      colors=(HColorInfo *) RelinquishMagickMemory(colors);
     }
   return(histogram);
 }
@@ -590,59 +662,6 @@ MagickExport PixelInfo *GetImageHistogram(const Image *image,
 %                                                                             %
 %                                                                             %
 %                                                                             %
-+  G e t N o d e I n f o                                                      %
-%                                                                             %
-%                                                                             %
-%                                                                             %
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%
-%  GetHNodeInfo() allocates memory for a new node in the color cube tree and
-%  presets all fields to zero.
-%
-%  The format of the GetHNodeInfo method is:
-%
-%      HNodeInfo *GetHNodeInfo(HCubeInfo *cube_info,const size_t level)
-%
-%  A description of each parameter follows.
-%
-%    o cube_info: A pointer to the HCubeInfo structure.
-%
-%    o level: Specifies the level in the storage_class the node resides.
-%
-*/
-static HNodeInfo *GetHNodeInfo(HCubeInfo *cube_info,const size_t level)
-{
-  HNodeInfo
-    *node_info;
-
-  if (cube_info->free_nodes == 0)
-    {
-      HNodes
-        *nodes;
-
-      /*
-        Allocate a new nodes of nodes.
-      */
-      nodes=(HNodes *) AcquireMagickMemory(sizeof(*nodes));
-      if (nodes == (HNodes *) NULL)
-        return((HNodeInfo *) NULL);
-      nodes->next=cube_info->node_queue;
-      cube_info->node_queue=nodes;
-      cube_info->node_info=nodes->nodes;
-      cube_info->free_nodes=HNodesInAList;
-    }
-  cube_info->free_nodes--;
-  node_info=cube_info->node_info++;
-  (void) memset(node_info,0,sizeof(*node_info));
-  node_info->level=level;
-  return(node_info);
-}
-
-/*
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%                                                                             %
-%                                                                             %
-%                                                                             %
 %  I d e n t i f y P a l e t t e I m a g e                                    %
 %                                                                             %
 %                                                                             %
@@ -670,128 +689,19 @@ static HNodeInfo *GetHNodeInfo(HCubeInfo *cube_info,const size_t level)
 static MagickBooleanType CheckImageColors(const Image *image,
   const size_t max_colors,ExceptionInfo *exception)
 {
-  CacheView
-    *image_view;
-
-  const Quantum
-    *p;
-
-  HCubeInfo
-    *cube_info;
-
-  HNodeInfo
-    *node_info;
-
-  PixelInfo
-    pixel,
-    target;
+  HColorInfo
+    *colors;
 
   size_t
-    id,
-    index,
-    level;
-
-  ssize_t
-    i,
-    y;
+    number_colors;
 
   if (image->storage_class == PseudoClass)
     return((image->colors <= max_colors) ? MagickTrue : MagickFalse);
-  /*
-    Initialize color description tree.
-  */
-  cube_info=GetHCubeInfo();
-  if (cube_info == (HCubeInfo *) NULL)
-    {
-      (void) ThrowMagickException(exception,GetMagickModule(),
-        ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
-      return(MagickFalse);
-    }
-  GetPixelInfo(image,&pixel);
-  GetPixelInfo(image,&target);
-  image_view=AcquireVirtualCacheView(image,exception);
-  for (y=0; y < (ssize_t) image->rows; y++)
-  {
-    ssize_t
-      x;
-
-    p=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
-    if (p == (const Quantum *) NULL)
-      break;
-    for (x=0; x < (ssize_t) image->columns; x++)
-    {
-      /*
-        Start at the root and proceed level by level.
-      */
-      node_info=cube_info->root;
-      index=MaxTreeDepth-1;
-      for (level=1; level < MaxTreeDepth; level++)
-      {
-        GetPixelInfoPixel(image,p,&pixel);
-        id=ColorToNodeId(&pixel,index);
-        if (node_info->child[id] == (HNodeInfo *) NULL)
-          {
-            node_info->child[id]=GetHNodeInfo(cube_info,level);
-            if (node_info->child[id] == (HNodeInfo *) NULL)
-              {
-                (void) ThrowMagickException(exception,GetMagickModule(),
-                  ResourceLimitError,"MemoryAllocationFailed","`%s'",
-                  image->filename);
-                break;
-              }
-          }
-        node_info=node_info->child[id];
-        index--;
-      }
-      if (level < MaxTreeDepth)
-        break;
-      for (i=0; i < (ssize_t) node_info->number_unique; i++)
-      {
-        target=node_info->list[i];
-        if (IsPixelInfoColorMatch(&pixel,&target) != MagickFalse)
-          break;
-      }
-      if (i < (ssize_t) node_info->number_unique)
-        node_info->list[i].count++;
-      else
-        {
-          /*
-            Add this unique color to the color list.
-          */
-          if (node_info->list == (PixelInfo *) NULL)
-            node_info->list=(PixelInfo *) AcquireQuantumMemory(1,
-              sizeof(*node_info->list));
-          else
-            node_info->list=(PixelInfo *) ResizeQuantumMemory(node_info->list,
-              (size_t) (i+1),sizeof(*node_info->list));
-          if (node_info->list == (PixelInfo *) NULL)
-            {
-              (void) ThrowMagickException(exception,GetMagickModule(),
-                ResourceLimitError,"MemoryAllocationFailed","`%s'",
-                image->filename);
-              break;
-            }
-          GetPixelInfo(image,&node_info->list[i]);
-          node_info->list[i].red=(double) GetPixelRed(image,p);
-          node_info->list[i].green=(double) GetPixelGreen(image,p);
-          node_info->list[i].blue=(double) GetPixelBlue(image,p);
-          if (image->colorspace == CMYKColorspace)
-            node_info->list[i].black=(double) GetPixelBlack(image,p);
-          node_info->list[i].alpha=(double) GetPixelAlpha(image,p);
-          node_info->list[i].count=1;
-          node_info->number_unique++;
-          cube_info->colors++;
-          if (cube_info->colors > max_colors)
-            break;
-        }
-      p+=(ptrdiff_t) GetPixelChannels(image);
-    }
-    if (x < (ssize_t) image->columns)
-      break;
-  }
-  image_view=DestroyCacheView(image_view);
-  cube_info=DestroyHCubeInfo(image,cube_info);
-  return(y < (ssize_t) image->rows ? MagickFalse : MagickTrue);
+  colors=ClassifyImageColors(image,max_colors,&number_colors,exception);
+  if (colors == (HColorInfo *) NULL)
+    return(MagickFalse);
+  colors=(HColorInfo *) RelinquishMagickMemory(colors);
+  return(MagickTrue);
 }
 
 MagickExport MagickBooleanType IdentifyPaletteImage(const Image *image,
@@ -1059,14 +969,20 @@ MagickExport size_t GetNumberColors(const Image *image,FILE *file,
   number_colors=0;
   if (file == (FILE *) NULL)
     {
-      HCubeInfo
-        *cube_info;
-
-      cube_info=ClassifyImageColors(image,exception);
-      if (cube_info != (HCubeInfo *) NULL)
+      HColorInfo
+        *colors;
+
+      if (GetPixelCacheMemo(image,"histogram:colors",&number_colors,
+            sizeof(number_colors)) != MagickFalse)
+        return(number_colors);
+      colors=ClassifyImageColors(image,MAGICK_SIZE_MAX,&number_colors,
+        exception);
+      if (colors != (HColorInfo *) NULL)
         {
-          number_colors=cube_info->colors;
-          cube_info=DestroyHCubeInfo(image,cube_info);
+          colors=(HColorInfo *) RelinquishMagickMemory(colors);
+          if (image->progress_monitor == (MagickProgressMonitor) NULL)
+            (void) SetPixelCacheMemo(image,"histogram:colors",&number_colors,
+              sizeof(number_colors));
         }
       return(number_colors);
     }
@@ -1149,98 +1065,77 @@ MagickExport size_t GetNumberColors(const Image *image,FILE *file,
 %
 */
 
-static void UniqueColorsToImage(Image *unique_image,CacheView *unique_view,
-  HCubeInfo *cube_info,const HNodeInfo *node_info,ExceptionInfo *exception)
-{
-#define UniqueColorsImageTag  "UniqueColors/Image"
-
-  MagickBooleanType
-    status;
-
-  ssize_t
-    i;
-
-  size_t
-    number_children;
-
-  /*
-    Traverse any children.
-  */
-  number_children=unique_image->alpha_trait == UndefinedPixelTrait ? 8UL : 16UL;
-  for (i=0; i < (ssize_t) number_children; i++)
-    if (node_info->child[i] != (HNodeInfo *) NULL)
-      UniqueColorsToImage(unique_image,unique_view,cube_info,
-        node_info->child[i],exception);
-  if (node_info->level == (MaxTreeDepth-1))
-    {
-      PixelInfo
-        *p;
-
-      Quantum
-        *magick_restrict q;
-
-      status=MagickTrue;
-      p=node_info->list;
-      for (i=0; i < (ssize_t) node_info->number_unique; i++)
-      {
-        q=QueueCacheViewAuthenticPixels(unique_view,cube_info->x,0,1,1,
-          exception);
-        if (q == (Quantum *) NULL)
-          continue;
-        SetPixelRed(unique_image,ClampToQuantum(p->red),q);
-        SetPixelGreen(unique_image,ClampToQuantum(p->green),q);
-        SetPixelBlue(unique_image,ClampToQuantum(p->blue),q);
-        SetPixelAlpha(unique_image,ClampToQuantum(p->alpha),q);
-        if (unique_image->colorspace == CMYKColorspace)
-          SetPixelBlack(unique_image,ClampToQuantum(p->black),q);
-        if (SyncCacheViewAuthenticPixels(unique_view,exception) == MagickFalse)
-          break;
-        cube_info->x++;
-        p++;
-      }
-      if (unique_image->progress_monitor != (MagickProgressMonitor) NULL)
-        {
-          MagickBooleanType
-            proceed;
-
-          proceed=SetImageProgress(unique_image,UniqueColorsImageTag,
-            cube_info->progress,cube_info->colors);
-          if (proceed == MagickFalse)
-            status=MagickFalse;
-        }
-      cube_info->progress++;
-      if (status == MagickFalse)
-        return;
-    }
-}
-
 MagickExport Image *UniqueImageColors(const Image *image,
   ExceptionInfo *exception)
 {
+#define UniqueColorsImageTag  "UniqueColors/Image"
+
   CacheView
     *unique_view;
 
-  HCubeInfo
-    *cube_info;
+  HColorInfo
+    *colors;
 
   Image
     *unique_image;
 
-  cube_info=ClassifyImageColors(image,exception);
-  if (cube_info == (HCubeInfo *) NULL)
+  MagickBooleanType
+    status;
+
+  Quantum
+    *magick_restrict q;
+
+  size_t
+    number_colors;
+
+  ssize_t
+    i;
+
+  colors=ClassifyImageColors(image,MAGICK_SIZE_MAX,&number_colors,exception);
+  if (colors == (HColorInfo *) NULL)
     return((Image *) NULL);
-  unique_image=CloneImage(image,cube_info->colors,1,MagickTrue,exception);
+  SortImageColors(image,colors,number_colors);
+  unique_image=CloneImage(image,number_colors,1,MagickTrue,exception);
   if (unique_image == (Image *) NULL)
-    return(unique_image);
+    {
+      colors=(HColorInfo *) RelinquishMagickMemory(colors);
+      return(unique_image);
+    }
   if (SetImageStorageClass(unique_image,DirectClass,exception) == MagickFalse)
     {
+      colors=(HColorInfo *) RelinquishMagickMemory(colors);
       unique_image=DestroyImage(unique_image);
       return((Image *) NULL);
     }
+  status=MagickTrue;
   unique_view=AcquireAuthenticCacheView(unique_image,exception);
-  UniqueColorsToImage(unique_image,unique_view,cube_info,cube_info->root,
-    exception);
+  q=QueueCacheViewAuthenticPixels(unique_view,0,0,number_colors,1,exception);
+  if (q == (Quantum *) NULL)
+    status=MagickFalse;
+  else
+    {
+      for (i=0; i < (ssize_t) number_colors; i++)
+      {
+        SetPixelRed(unique_image,ClampToQuantum((MagickRealType)
+          colors[i].red),q);
+        SetPixelGreen(unique_image,ClampToQuantum((MagickRealType)
+          colors[i].green),q);
+        SetPixelBlue(unique_image,ClampToQuantum((MagickRealType)
+          colors[i].blue),q);
+        SetPixelAlpha(unique_image,ClampToQuantum((MagickRealType)
+          colors[i].alpha),q);
+        if (unique_image->colorspace == CMYKColorspace)
+          SetPixelBlack(unique_image,ClampToQuantum((MagickRealType)
+            colors[i].black),q);
+        q+=(ptrdiff_t) GetPixelChannels(unique_image);
+      }
+      status=SyncCacheViewAuthenticPixels(unique_view,exception);
+    }
   unique_view=DestroyCacheView(unique_view);
-  cube_info=DestroyHCubeInfo(image,cube_info);
+  colors=(HColorInfo *) RelinquishMagickMemory(colors);
+  if ((status != MagickFalse) &&
+      (unique_image->progress_monitor != (MagickProgressMonitor) NULL))
+    (void) SetImageProgress(unique_image,UniqueColorsImageTag,(MagickOffsetType)
+      number_colors-1,number_colors);
   return(unique_image);
 }
@@ -71,6 +71,7 @@
 #include "MagickCore/histogram.h"
 #include "MagickCore/image-private.h"
 #include "MagickCore/list.h"
+#include "MagickCore/list-private.h"
 #include "MagickCore/magic.h"
 #include "MagickCore/magick.h"
 #include "MagickCore/magick-private.h"
@@ -1223,6 +1224,7 @@ MagickExport Image *DestroyImage(Image *image)
   if (image->image_info != (ImageInfo *) NULL)
     image->image_info=DestroyImageInfo(image->image_info);
   DestroyBlob(image);
+  RelinquishImageListIndex(image);
   if (image->semaphore != (SemaphoreInfo *) NULL)
     RelinquishSemaphoreInfo(&image->semaphore);
   image->signature=(~MagickCoreSignature);
@@ -2384,6 +2386,18 @@ MagickExport MagickBooleanType SetImageAlpha(Image *image,const Quantum alpha,
       status=MagickFalse;
   }
   image_view=DestroyCacheView(image_view);
+  if ((status != MagickFalse) && (alpha == OpaqueAlpha) &&
+      ((image->channels & WriteMaskChannel) == 0))
+    {
+      MagickBooleanType
+        opaque = MagickTrue;
+
+      /*
+        Spare IsImageOpaque() a scan of the alpha channel just filled.
+      */
+      (void) SetPixelCacheMemo(image,"attribute:opaque",&opaque,
+        sizeof(opaque));
+    }
   return(status);
 }
 
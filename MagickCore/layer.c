@@ -41,6 +41,7 @@
 #include "MagickCore/artifact.h"
 #include "MagickCore/attribute.h"
 #include "MagickCore/cache.h"
+#include "MagickCore/cache-view.h"
 #include "MagickCore/channel.h"
 #include "MagickCore/color.h"
 #include "MagickCore/color-private.h"
@@ -167,24 +168,45 @@ static void ClearBounds(Image *image,RectangleInfo *bounds,
 static MagickBooleanType IsBoundsCleared(const Image *image1,
   const Image *image2,RectangleInfo *bounds,ExceptionInfo *exception)
 {
-  const Quantum
-    *p,
-    *q;
+  CacheView
+    *image1_view,
+    *image2_view;
 
-  ssize_t
-    x;
+  MagickBooleanType
+    cleared;
 
   ssize_t
     y;
 
   if (bounds->x < 0)
     return(MagickFalse);
+  cleared=MagickFalse;
+  image1_view=AcquireVirtualCacheView(image1,exception);
+  image2_view=AcquireVirtualCacheView(image2,exception);
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(static) shared(cleared) \
+    magick_number_threads(image1,image2,bounds->height,1)
+#endif
   for (y=0; y < (ssize_t) bounds->height; y++)
   {
-    p=GetVirtualPixels(image1,bounds->x,bounds->y+y,bounds->width,1,exception);
-    q=GetVirtualPixels(image2,bounds->x,bounds->y+y,bounds->width,1,exception);
+    const Quantum
+      *p,
+      *q;
+
+    ssize_t
+      x;
+
+    if (cleared != MagickFalse)
+      continue;
+    p=GetCacheViewVirtualPixels(image1_view,bounds->x,bounds->y+y,
+      bounds->width,1,exception);
+    q=GetCacheViewVirtualPixels(image2_view,bounds->x,bounds->y+y,
+      bounds->width,1,exception);
     if ((p == (const Quantum *) NULL) || (q == (Quantum *) NULL))
-      break;
+      {
+        cleared=MagickTrue;
+        continue;
+      }
     for (x=0; x < (ssize_t) bounds->width; x++)
     {
       if ((GetPixelAlpha(image1,p) >= (Quantum) (QuantumRange/2)) &&
@@ -194,9 +216,11 @@ static MagickBooleanType IsBoundsCleared(const Image *image1,
       q+=(ptrdiff_t) GetPixelChannels(image2);
     }
     if (x < (ssize_t) bounds->width)
-      break;
+      cleared=MagickTrue;
   }
-  return(y < (ssize_t) bounds->height ? MagickTrue : MagickFalse);
+  image2_view=DestroyCacheView(image2_view);
+  image1_view=DestroyCacheView(image1_view);
+  return(cleared);
 }
 
 /*
@@ -615,22 +639,49 @@ static MagickBooleanType ComparePixels(const LayerMethod method,
 %
 */
 
+static inline MagickBooleanType IsPixelChanged(const Image *alpha_image,
+  const Quantum *p,const Image *beta_image,const Quantum *q,
+  const LayerMethod method,const MagickBooleanType same_layout,
+  PixelInfo *alpha_pixel,PixelInfo *beta_pixel)
+{
+  ssize_t
+    i;
+
+  if (same_layout != MagickFalse)
+    {
+      /*
+        Identical pixels never differ, whatever the comparison method.
+      */
+      for (i=0; i < (ssize_t) GetPixelChannels(alpha_image); i++)
+        if (p[i] != q[i])
+          break;
+      if (i >= (ssize_t) GetPixelChannels(alpha_image))
+        return(MagickFalse);
+    }
+  GetPixelInfoPixel(alpha_image,p,alpha_pixel);
+  GetPixelInfoPixel(beta_image,q,beta_pixel);
+  return(ComparePixels(method,alpha_pixel,beta_pixel));
+}
+
 static RectangleInfo CompareImagesBounds(const Image *alpha_image,
   const Image *beta_image,const LayerMethod method,ExceptionInfo *exception)
 {
-  const Quantum
-    *p,
-    *q;
+  CacheView
+    *alpha_view,
+    *beta_view;
 
-  PixelInfo
-    alpha_pixel,
-    beta_pixel;
+  MagickBooleanType
+    same_layout,
+    status;
 
   RectangleInfo
     bounds;
 
   ssize_t
-    x,
+    bottom,
+    left,
+    right,
+    top,
     y;
 
   /*
@@ -639,27 +690,93 @@ static RectangleInfo CompareImagesBounds(const Image *alpha_image,
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",
       alpha_image->filename);
-  GetPixelInfo(alpha_image,&alpha_pixel);
-  GetPixelInfo(beta_image,&beta_pixel);
-  for (x=0; x < (ssize_t) alpha_image->columns; x++)
+  same_layout=MagickFalse;
+  if ((alpha_image->columns == beta_image->columns) &&
+      (alpha_image->number_channels == beta_image->number_channels) &&
+      (alpha_image->alpha_trait == beta_image->alpha_trait) &&
+      (alpha_image->colorspace == beta_image->colorspace) &&
+      (memcmp(alpha_image->channel_map,beta_image->channel_map,
+       (MaxPixelChannels+1)*sizeof(*alpha_image->channel_map)) == 0))
+    same_layout=MagickTrue;
+  /*
+    Each row contributes the span between its first and last differing
+    pixels, so the rows are compared independently and merged.
+  */
+  status=MagickTrue;
+  left=(ssize_t) alpha_image->columns;
+  right=(-1);
+  top=(ssize_t) alpha_image->rows;
+  bottom=(-1);
+  alpha_view=AcquireVirtualCacheView(alpha_image,exception);
+  beta_view=AcquireVirtualCacheView(beta_image,exception);
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(static) \
+    shared(bottom,left,right,status,top) \
+    magick_number_threads(alpha_image,beta_image,alpha_image->rows,1)
+#endif
+  for (y=0; y < (ssize_t) alpha_image->rows; y++)
   {
-    p=GetVirtualPixels(alpha_image,x,0,1,alpha_image->rows,exception);
-    q=GetVirtualPixels(beta_image,x,0,1,beta_image->rows,exception);
-    if ((p == (const Quantum *) NULL) || (q == (Quantum *) NULL))
-      break;
-    for (y=0; y < (ssize_t) alpha_image->rows; y++)
-    {
-      GetPixelInfoPixel(alpha_image,p,&alpha_pixel);
-      GetPixelInfoPixel(beta_image,q,&beta_pixel);
-      if (ComparePixels(method,&alpha_pixel,&beta_pixel) != MagickFalse)
+    const Quantum
+      *p,
+      *q;
+
+    PixelInfo
+      alpha_pixel,
+      beta_pixel;
+
+    size_t
+      channels;
+
+    ssize_t
+      first,
+      last;
+
+    if (status == MagickFalse)
+      continue;
+    p=GetCacheViewVirtualPixels(alpha_view,0,y,alpha_image->columns,1,
+      exception);
+    q=GetCacheViewVirtualPixels(beta_view,0,y,alpha_image->columns,1,
+      exception);
+    if ((p == (const Quantum *) NULL) || (q == (const Quantum *) NULL))
+      {
+        status=MagickFalse;
+        continue;
+      }
+    channels=GetPixelChannels(alpha_image);
+    if ((same_layout != MagickFalse) &&
+        (memcmp(p,q,alpha_image->columns*channels*sizeof(*p)) == 0))
+      continue;
+    GetPixelInfo(alpha_image,&alpha_pixel);
+    GetPixelInfo(beta_image,&beta_pixel);
+    for (first=0; first < (ssize_t) alpha_image->columns; first++)
+      if (IsPixelChanged(alpha_image,p+first*(ssize_t) channels,beta_image,
+            q+first*(ssize_t) GetPixelChannels(beta_image),method,
+            same_layout,&alpha_pixel,&beta_pixel) != MagickFalse)
         break;
-      p+=(ptrdiff_t) GetPixelChannels(alpha_image);
-      q+=(ptrdiff_t) GetPixelChannels(beta_image);
+    if (first >= (ssize_t) alpha_image->columns)
+      continue;
+    for (last=(ssize_t) alpha_image->columns-1; last > first; last--)
+      if (IsPixelChanged(alpha_image,p+last*(ssize_t) channels,beta_image,
+            q+last*(ssize_t) GetPixelChannels(beta_image),method,
+            same_layout,&alpha_pixel,&beta_pixel) != MagickFalse)
+        break;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+    #pragma omp critical (MagickCore_CompareImagesBounds)
+#endif
+    {
+      if (first < left)
+        left=first;
+      if (last > right)
+        right=last;
+      if (y < top)
+        top=y;
+      if (y > bottom)
+        bottom=y;
     }
-    if (y < (ssize_t) alpha_image->rows)
-      break;
   }
-  if (x >= (ssize_t) alpha_image->columns)
+  beta_view=DestroyCacheView(beta_view);
+  alpha_view=DestroyCacheView(alpha_view);
+  if ((status == MagickFalse) || (right < 0))
     {
       /*
         Images are identical, return a null image.
@@ -670,64 +787,10 @@ static RectangleInfo CompareImagesBounds(const Image *alpha_image,
       bounds.height=1;
       return(bounds);
     }
-  bounds.x=x;
-  for (x=(ssize_t) alpha_image->columns-1; x >= 0; x--)
-  {
-    p=GetVirtualPixels(alpha_image,x,0,1,alpha_image->rows,exception);
-    q=GetVirtualPixels(beta_image,x,0,1,beta_image->rows,exception);
-    if ((p == (const Quantum *) NULL) || (q == (Quantum *) NULL))
-      break;
-    for (y=0; y < (ssize_t) alpha_image->rows; y++)
-    {
-      GetPixelInfoPixel(alpha_image,p,&alpha_pixel);
-      GetPixelInfoPixel(beta_image,q,&beta_pixel);
-      if (ComparePixels(method,&alpha_pixel,&beta_pixel) != MagickFalse)
-        break;
-      p+=(ptrdiff_t) GetPixelChannels(alpha_image);
-      q+=(ptrdiff_t) GetPixelChannels(beta_image);
-    }
-    if (y < (ssize_t) alpha_image->rows)
-      break;
-  }
-  bounds.width=(size_t) (x-bounds.x+1);
-  for (y=0; y < (ssize_t) alpha_image->rows; y++)
-  {
-    p=GetVirtualPixels(alpha_image,0,y,alpha_image->columns,1,exception);
-    q=GetVirtualPixels(beta_image,0,y,beta_image->columns,1,exception);
-    if ((p == (const Quantum *) NULL) || (q == (Quantum *) NULL))
-      break;
-    for (x=0; x < (ssize_t) alpha_image->columns; x++)
-    {
-      GetPixelInfoPixel(alpha_image,p,&alpha_pixel);
-      GetPixelInfoPixel(beta_image,q,&beta_pixel);
-      if (ComparePixels(method,&alpha_pixel,&beta_pixel) != MagickFalse)
-        break;
-      p+=(ptrdiff_t) GetPixelChannels(alpha_image);
-      q+=(ptrdiff_t) GetPixelChannels(beta_image);
-    }
-    if (x < (ssize_t) alpha_image->columns)
-      break;
-  }
-  bounds.y=y;
-  for (y=(ssize_t) alpha_image->rows-1; y >= 0; y--)
-  {
-    p=GetVirtualPixels(alpha_image,0,y,alpha_image->columns,1,exception);
-    q=GetVirtualPixels(beta_image,0,y,beta_image->columns,1,exception);
-    if ((p == (const Quantum *) NULL) || (q == (Quantum *) NULL))
-      break;
-    for (x=0; x < (ssize_t) alpha_image->columns; x++)
-    {
-      GetPixelInfoPixel(alpha_image,p,&alpha_pixel);
-      GetPixelInfoPixel(beta_image,q,&beta_pixel);
-      if (ComparePixels(method,&alpha_pixel,&beta_pixel) != MagickFalse)
-        break;
-      p+=(ptrdiff_t) GetPixelChannels(alpha_image);
-      q+=(ptrdiff_t) GetPixelChannels(beta_image);
-    }
-    if (x < (ssize_t) alpha_image->columns)
-      break;
-  }
-  bounds.height=(size_t) (y-bounds.y+1);
+  bounds.x=left;
+  bounds.y=top;
+  bounds.width=(size_t) (right-left+1);
+  bounds.height=(size_t) (bottom-top+1);
   return(bounds);
 }
 
@@ -958,20 +1021,27 @@ static Image *OptimizeLayerFrames(const Image *image,const LayerMethod method,
     *prev_image,
     *dup_image,
     *bgnd_image,
-    *optimized_image;
+    *optimized_image,
+    **frames;
 
   RectangleInfo
     try_bounds,
     bgnd_bounds,
     dup_bounds,
-    *bounds;
+    *bounds,
+    *changes;
 
   MagickBooleanType
     add_frames,
     try_cleared,
-    cleared;
+    cleared,
+    *changes_cleared;
+
+  size_t
+    number_frames;
 
   ssize_t
+    frame,
     i;
 
   assert(image != (const Image *) NULL);
@@ -1028,6 +1098,44 @@ static Image *OptimizeLayerFrames(const Image *image,const LayerMethod method,
       disposals=(DisposeType *) RelinquishMagickMemory(disposals);
       return((Image *) NULL);
     }
+  /*
+    The changes between each frame and the one before it do not depend on
+    the disposals chosen, so compute them for all frame pairs in parallel.
+  */
+  number_frames=GetImageListLength(curr);
+  changes=(RectangleInfo *) AcquireQuantumMemory(number_frames,
+    sizeof(*changes));
+  changes_cleared=(MagickBooleanType *) AcquireQuantumMemory(number_frames,
+    sizeof(*changes_cleared));
+  frames=ImageListToArray(curr,exception);
+  if ((changes == (RectangleInfo *) NULL) ||
+      (changes_cleared == (MagickBooleanType *) NULL) ||
+      (frames == (Image **) NULL))
+    {
+      if (frames != (Image **) NULL)
+        frames=(Image **) RelinquishMagickMemory(frames);
+      if (changes_cleared != (MagickBooleanType *) NULL)
+        changes_cleared=(MagickBooleanType *)
+          RelinquishMagickMemory(changes_cleared);
+      if (changes != (RectangleInfo *) NULL)
+        changes=(RectangleInfo *) RelinquishMagickMemory(changes);
+      prev_image=DestroyImage(prev_image);
+      bounds=(RectangleInfo *) RelinquishMagickMemory(bounds);
+      disposals=(DisposeType *) RelinquishMagickMemory(disposals);
+      ThrowImageException(ResourceLimitError,"MemoryAllocationFailed");
+    }
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(dynamic,1) \
+    num_threads(GetMagickResourceLimit(ThreadResource))
+#endif
+  for (frame=1; frame < (ssize_t) number_frames; frame++)
+  {
+    changes[frame]=CompareImagesBounds(frames[frame-1],frames[frame],
+      CompareAnyLayer,exception);
+    changes_cleared[frame]=IsBoundsCleared(frames[frame-1],frames[frame],
+      &changes[frame],exception);
+  }
+  frames=(Image **) RelinquishMagickMemory(frames);
   prev_image->page=curr->page;  /* ERROR: <-- should not be need, but is! */
   prev_image->page.x=0;
   prev_image->page.y=0;
@@ -1060,6 +1168,7 @@ static Image *OptimizeLayerFrames(const Image *image,const LayerMethod method,
   dup_bounds.height=0;
   dup_bounds.x=0;
   dup_bounds.y=0;
+  frame=0;
   curr=GetNextImageInList(curr);
   for ( ; curr != (const Image *) NULL; curr=GetNextImageInList(curr))
   {
@@ -1069,8 +1178,9 @@ static Image *OptimizeLayerFrames(const Image *image,const LayerMethod method,
     /*
       Assume none disposal is the best
     */
-    bounds[i]=CompareImagesBounds(curr->previous,curr,CompareAnyLayer,exception);
-    cleared=IsBoundsCleared(curr->previous,curr,&bounds[i],exception);
+    frame++;
+    bounds[i]=changes[frame];
+    cleared=changes_cleared[frame];
     disposals[i-1]=NoneDispose;
 #if DEBUG_OPT_FRAME
     (void) FormatLocaleFile(stderr, "overlay: %.20gx%.20g%+.20g%+.20g%s%s\n",
@@ -1132,6 +1242,9 @@ static Image *OptimizeLayerFrames(const Image *image,const LayerMethod method,
             dup_image=CloneImage(curr->previous,0,0,MagickTrue,exception);
             if (dup_image == (Image *) NULL)
               {
+                changes_cleared=(MagickBooleanType *)
+                  RelinquishMagickMemory(changes_cleared);
+                changes=(RectangleInfo *) RelinquishMagickMemory(changes);
                 bounds=(RectangleInfo *) RelinquishMagickMemory(bounds);
                 disposals=(DisposeType *) RelinquishMagickMemory(disposals);
                 prev_image=DestroyImage(prev_image);
@@ -1160,6 +1273,9 @@ static Image *OptimizeLayerFrames(const Image *image,const LayerMethod method,
         bgnd_image=CloneImage(curr->previous,0,0,MagickTrue,exception);
         if (bgnd_image == (Image *) NULL)
           {
+            changes_cleared=(MagickBooleanType *)
+              RelinquishMagickMemory(changes_cleared);
+            changes=(RectangleInfo *) RelinquishMagickMemory(changes);
             bounds=(RectangleInfo *) RelinquishMagickMemory(bounds);
             disposals=(DisposeType *) RelinquishMagickMemory(disposals);
             prev_image=DestroyImage(prev_image);
@@ -1320,6 +1436,9 @@ static Image *OptimizeLayerFrames(const Image *image,const LayerMethod method,
             prev_image=ReferenceImage(curr->previous);
             if (prev_image == (Image *) NULL)
               {
+                changes_cleared=(MagickBooleanType *)
+                  RelinquishMagickMemory(changes_cleared);
+                changes=(RectangleInfo *) RelinquishMagickMemory(changes);
                 bounds=(RectangleInfo *) RelinquishMagickMemory(bounds);
                 disposals=(DisposeType *) RelinquishMagickMemory(disposals);
                 return((Image *) NULL);
@@ -1346,6 +1465,9 @@ static Image *OptimizeLayerFrames(const Image *image,const LayerMethod method,
 #endif
     i++;
   }
+  changes_cleared=(MagickBooleanType *)
+    RelinquishMagickMemory(changes_cleared);
+  changes=(RectangleInfo *) RelinquishMagickMemory(changes);
   prev_image=DestroyImage(prev_image);
   /*
     Optimize all images in sequence.
@@ -48,9 +48,432 @@
 #include "MagickCore/exception-private.h"
 #include "MagickCore/image-private.h"
 #include "MagickCore/list.h"
+#include "MagickCore/list-private.h"
 #include "MagickCore/memory_.h"
+#include "MagickCore/semaphore.h"
 #include "MagickCore/string_.h"
 #include "MagickCore/string-private.h"
+
+/*
+  Define declarations.
+*/
+#define MinimumImageListIndex  32
+
+/*
+  Typedef declarations.
+*/
+typedef struct _ImageListIndex
+{
+  Image
+    **images;
+
+  size_t
+    extent,
+    first,
+    number_images,
+    references;
+
+  MagickBooleanType
+    stale;
+} ImageListIndex;
+
+typedef struct _ImageListEntry
+{
+  const Image
+    *image;
+
+  ImageListIndex
+    *list_index;
+
+  size_t
+    offset;
+} ImageListEntry;
+
+/*
+  Global declarations.
+*/
+static ImageListEntry
+  *list_entries = (ImageListEntry *) NULL;
+
+static SemaphoreInfo
+  *list_semaphore = (SemaphoreInfo *) NULL;
+
+static size_t
+  list_extent = 0,
+  number_list_entries = 0;
+
+/*
+  Lists longer than MinimumImageListIndex images get a position index, an
+  array of their images in list order, so the accessors below answer in
+  constant time rather than walking the links.  A private table, keyed by
+  image address, maps each indexed image to its index and offset; it is only
+  consulted with list_semaphore held, and shorter lists never take the lock.
+
+  The list methods below mark an index stale when they relink images, and the
+  next accessor rebuilds it.  Appending to the tail and removing either end
+  update the index in place, so building or draining a list stays linear.
+  The links remain authoritative: an index is also rejected when the head of
+  the list or the neighbors of the queried image disagree with it, and images
+  linked directly behind the tail are picked up.
+*/
+static inline size_t HashImageListEntry(const Image *image,
+  const size_t extent)
+{
+  size_t
+    key;
+
+  key=(size_t) image >> 4;
+  key^=key >> 13;
+  return((key*0x5bd1e995UL) & (extent-1));
+}
+
+static ImageListEntry *GetImageListEntry(const Image *image)
+{
+  size_t
+    i;
+
+  if (list_entries == (ImageListEntry *) NULL)
+    return((ImageListEntry *) NULL);
+  for (i=HashImageListEntry(image,list_extent);
+       list_entries[i].image != (const Image *) NULL; i=(i+1) & (list_extent-1))
+    if (list_entries[i].image == image)
+      return(list_entries+i);
+  return((ImageListEntry *) NULL);
+}
+
+static void ReleaseImageListIndex(ImageListIndex *list_index)
+{
+  list_index->references--;
+  if (list_index->references != 0)
+    return;
+  list_index->images=(Image **) RelinquishMagickMemory(list_index->images);
+  list_index=(ImageListIndex *) RelinquishMagickMemory(list_index);
+}
+
+static void DetachImageListEntry(const Image *image,
+  const MagickBooleanType stale)
+{
+  ImageListEntry
+    *entry;
+
+  size_t
+    home,
+    i,
+    j;
+
+  entry=GetImageListEntry(image);
+  if (entry == (ImageListEntry *) NULL)
+    return;
+  if (stale != MagickFalse)
+    entry->list_index->stale=MagickTrue;
+  ReleaseImageListIndex(entry->list_index);
+  /*
+    Shift the entries of the probe sequence back over the vacated slot.
+  */
+  i=(size_t) (entry-list_entries);
+  for (j=(i+1) & (list_extent-1);
+       list_entries[j].image != (const Image *) NULL;
+       j=(j+1) & (list_extent-1))
+  {
+    home=HashImageListEntry(list_entries[j].image,list_extent);
+    if ((i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j)))
+      continue;
+    list_entries[i]=list_entries[j];
+    i=j;
+  }
+  list_entries[i].image=(const Image *) NULL;
+  list_entries[i].list_index=(ImageListIndex *) NULL;
+  number_list_entries--;
+}
+
+static MagickBooleanType AttachImageListEntry(const Image *image,
+  ImageListIndex *list_index,const size_t offset)
+{
+  ImageListEntry
+    *entry;
+
+  size_t
+    i;
+
+  entry=GetImageListEntry(image);
+  if (entry == (ImageListEntry *) NULL)
+    {
+      if ((2*(number_list_entries+1)) > list_extent)
+        {
+          ImageListEntry
+            *entries;
+
+          size_t
+            extent,
+            j;
+
+          /*
+            Grow the table, keeping it at most half full.
+          */
+          extent=list_extent << 1;
+          if (extent == 0)
+            extent=(size_t) (MinimumImageListIndex << 3);
+          entries=(ImageListEntry *) AcquireQuantumMemory(extent,
+            sizeof(*entries));
+          if (entries == (ImageListEntry *) NULL)
+            return(MagickFalse);
+          (void) memset(entries,0,extent*sizeof(*entries));
+          for (j=0; j < list_extent; j++)
+          {
+            if (list_entries[j].image == (const Image *) NULL)
+              continue;
+            i=HashImageListEntry(list_entries[j].image,extent);
+            while (entries[i].image != (const Image *) NULL)
+              i=(i+1) & (extent-1);
+            entries[i]=list_entries[j];
+          }
+          if (list_entries != (ImageListEntry *) NULL)
+            list_entries=(ImageListEntry *) RelinquishMagickMemory(
+              list_entries);
+          list_entries=entries;
+          list_extent=extent;
+        }
+      for (i=HashImageListEntry(image,list_extent);
+           list_entries[i].image != (const Image *) NULL;
+           i=(i+1) & (list_extent-1)) ;
+      entry=list_entries+i;
+      entry->image=image;
+      entry->list_index=(ImageListIndex *) NULL;
+      number_list_entries++;
+    }
+  if (entry->list_index != list_index)
+    {
+      if (entry->list_index != (ImageListIndex *) NULL)
+        {
+          entry->list_index->stale=MagickTrue;
+          ReleaseImageListIndex(entry->list_index);
+        }
+      entry->list_index=list_index;
+      list_index->references++;
+    }
+  entry->offset=offset;
+  return(MagickTrue);
+}
+
+static MagickBooleanType ExtendImageListIndex(ImageListIndex *list_index,
+  Image *image)
+{
+  if (list_index->number_images >= list_index->extent)
+    {
+      size_t
+        i;
+
+      if (list_index->first >= (list_index->extent >> 1))
+        {
+          /*
+            Reclaim the slots of images removed from the head.
+          */
+          list_index->number_images-=list_index->first;
+          (void) memmove(list_index->images,list_index->images+
+            list_index->first,list_index->number_images*
+            sizeof(*list_index->images));
+          list_index->first=0;
+          for (i=0; i < list_index->number_images; i++)
+            GetImageListEntry(list_index->images[i])->offset=i;
+        }
+      else
+        {
+          Image
+            **images;
+
+          images=(Image **) ResizeQuantumMemory(list_index->images,
+            list_index->extent << 1,sizeof(*list_index->images));
+          if (images == (Image **) NULL)
+            {
+              list_index->stale=MagickTrue;
+              return(MagickFalse);
+            }
+          list_index->images=images;
+          list_index->extent<<=1;
+        }
+    }
+  if (AttachImageListEntry(image,list_index,list_index->number_images) ==
+      MagickFalse)
+    {
+      list_index->stale=MagickTrue;
+      return(MagickFalse);
+    }
+  list_index->images[list_index->number_images++]=image;
+  return(MagickTrue);
+}
+
+static ImageListIndex *GetImageListIndex(const Image *images,size_t *offset)
+{
+  Image
+    *head,
+    *p;
+
+  ImageListEntry
+    *entry;
+
+  ImageListIndex
+    *list_index;
+
+  size_t
+    i,
+    number_images;
+
+  entry=GetImageListEntry(images);
+  if ((entry != (ImageListEntry *) NULL) &&
+      (entry->list_index->stale == MagickFalse))
+    {
+      /*
+        Validate the index against the list links.
+      */
+      list_index=entry->list_index;
+      i=entry->offset;
+      number_images=list_index->number_images;
+      if ((i >= list_index->first) && (i < number_images) &&
+          (list_index->images[i] == images) &&
+          (list_index->images[list_index->first]->previous == (Image *) NULL) &&
+          (images->previous == (i == list_index->first ? (Image *) NULL :
+           list_index->images[i-1])) && ((i == (number_images-1)) ||
+          (images->next == list_index->images[i+1])))
+        {
+          /*
+            Pick up images linked behind the tail.
+          */
+          for (p=list_index->images[number_images-1]->next;
+               p != (Image *) NULL; p=p->next)
+            if (ExtendImageListIndex(list_index,p) == MagickFalse)
+              break;
+          if (list_index->stale == MagickFalse)
+            {
+              *offset=i;
+              return(list_index);
+            }
+        }
+      list_index->stale=MagickTrue;
+    }
+  /*
+    Rebuild the index.
+  */
+  for (head=(Image *) images; head->previous != (Image *) NULL; )
+    head=head->previous;
+  number_images=0;
+  for (p=head; p != (Image *) NULL; p=p->next)
+    number_images++;
+  if (number_images < MinimumImageListIndex)
+    return((ImageListIndex *) NULL);
+  list_index=(ImageListIndex *) AcquireMagickMemory(sizeof(*list_index));
+  if (list_index == (ImageListIndex *) NULL)
+    return((ImageListIndex *) NULL);
+  (void) memset(list_index,0,sizeof(*list_index));
+  list_index->extent=number_images;
+  list_index->images=(Image **) AcquireQuantumMemory(list_index->extent,
+    sizeof(*list_index->images));
+  if (list_index->images == (Image **) NULL)
+    {
+      list_index=(ImageListIndex *) RelinquishMagickMemory(list_index);
+      return((ImageListIndex *) NULL);
+    }
+  list_index->references=1;
+  for (p=head; p != (Image *) NULL; p=p->next)
+    if (ExtendImageListIndex(list_index,p) == MagickFalse)
+      break;
+  /*
+    An image whose links were copied from a list member, as CloneImage does,
+    is not reachable from the head and is answered from its links.
+  */
+  entry=GetImageListEntry(images);
+  if ((entry == (ImageListEntry *) NULL) ||
+      (entry->list_index != list_index) || (list_index->stale != MagickFalse))
+    {
+      ReleaseImageListIndex(list_index);
+      return((ImageListIndex *) NULL);
+    }
+  *offset=entry->offset;
+  ReleaseImageListIndex(list_index);
+  return(list_index);
+}
+
+static inline MagickBooleanType IsShortImageList(const Image *images)
+{
+  const Image
+    *p;
+
+  size_t
+    n;
+
+  n=0;
+  for (p=images->previous; (p != (Image *) NULL) &&
+       (n < MinimumImageListIndex); p=p->previous)
+    n++;
+  for (p=images->next; (p != (Image *) NULL) &&
+       (n < MinimumImageListIndex); p=p->next)
+    n++;
+  return(n < MinimumImageListIndex ? MagickTrue : MagickFalse);
+}
+
+static inline void LockImageListIndex(void)
+{
+  if (list_semaphore == (SemaphoreInfo *) NULL)
+    ActivateSemaphoreInfo(&list_semaphore);
+  LockSemaphoreInfo(list_semaphore);
+}
+
+static inline void UnlockImageListIndex(void)
+{
+  UnlockSemaphoreInfo(list_semaphore);
+}
+
+static void RemoveImageFromListIndex(const Image *image)
+{
+  ImageListEntry
+    *entry;
+
+  ImageListIndex
+    *list_index;
+
+  /*
+    Called before the image is unlinked: removing either end of the list
+    keeps its index, anything else marks it stale.
+  */
+  if (list_semaphore == (SemaphoreInfo *) NULL)
+    return;
+  LockImageListIndex();
+  entry=GetImageListEntry(image);
+  if (entry != (ImageListEntry *) NULL)
+    {
+      list_index=entry->list_index;
+      if ((list_index->stale == MagickFalse) &&
+          (list_index->images[entry->offset] == image) &&
+          (entry->offset == list_index->first) &&
+          (image->previous == (Image *) NULL))
+        list_index->first++;
+      else
+        if ((list_index->stale == MagickFalse) &&
+            (list_index->images[entry->offset] == image) &&
+            (entry->offset == (list_index->number_images-1)) &&
+            (image->next == (Image *) NULL))
+          list_index->number_images--;
+        else
+          list_index->stale=MagickTrue;
+      if (list_index->first >= list_index->number_images)
+        list_index->stale=MagickTrue;
+      DetachImageListEntry(image,MagickFalse);
+    }
+  UnlockImageListIndex();
+}
+
+static void ResetImageListIndex(const Image *image)
+{
+  ImageListEntry
+    *entry;
+
+  if (list_semaphore == (SemaphoreInfo *) NULL)
+    return;
+  LockImageListIndex();
+  entry=GetImageListEntry(image);
+  if (entry != (ImageListEntry *) NULL)
+    entry->list_index->stale=MagickTrue;
+  UnlockImageListIndex();
+}
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -83,6 +506,12 @@ MagickExport void AppendImageToList(Image **images,const Image *append)
     *p,
     *q;
 
+  ImageListIndex
+    *list_index;
+
+  size_t
+    offset;
+
   assert(images != (Image **) NULL);
   if (append == (Image *) NULL)
     return;
@@ -95,8 +524,29 @@ MagickExport void AppendImageToList(Image **images,const Image *append)
       return;
     }
   assert((*images)->signature == MagickCoreSignature);
-  p=GetLastImageInList(*images);
   q=GetFirstImageInList(append);
+  if (IsShortImageList(*images) == MagickFalse)
+    {
+      LockImageListIndex();
+      list_index=GetImageListIndex(*images,&offset);
+      if (list_index != (ImageListIndex *) NULL)
+        {
+          /*
+            Extend the index rather than rebuilding it.
+          */
+          p=list_index->images[list_index->number_images-1];
+          p->next=q;
+          q->previous=p;
+          for ( ; q != (Image *) NULL; q=q->next)
+            if (ExtendImageListIndex(list_index,q) == MagickFalse)
+              break;
+          UnlockImageListIndex();
+          return;
+        }
+      UnlockImageListIndex();
+    }
+  ResetImageListIndex(q);
+  p=GetLastImageInList(*images);
   p->next=q;
   q->previous=p;
 }
@@ -240,6 +690,12 @@ MagickExport Image *CloneImages(const Image *images,const char *scenes,
   images=GetFirstImageInList(images);
   artifact=GetImageArtifact(images,"frames:step");
   length=GetImageListLength(images);
+  /*
+    Move a cursor from one selected scene to the next and append behind the
+    last clone, rather than walking both lists for each scene.
+  */
+  next=images;
+  i=0;
   for (p=(char *) scenes; *p != '\0';)
   {
     MagickBooleanType
@@ -279,19 +735,20 @@ MagickExport Image *CloneImages(const Image *images,const char *scenes,
     step=(ssize_t) (first > last ? -step : step);
     for ( ; step > 0 ? (last-first) >= 0 : (last-first) <= 0; first+=step)
     {
-      i=0;
-      for (next=images; next != (Image *) NULL; next=GetNextImageInList(next))
-      {
-        if (i == (ssize_t) first)
-          {
-            image=CloneImage(next,0,0,MagickTrue,exception);
-            if (image == (Image *) NULL)
-              break;
-            AppendImageToList(&clone_images,image);
-            match=MagickTrue;
-          }
-        i++;
-      }
+      if ((first >= 0) && (first < (ssize_t) length))
+        {
+          for ( ; i < first; i++)
+            next=GetNextImageInList(next);
+          for ( ; i > first; i--)
+            next=GetPreviousImageInList(next);
+          image=CloneImage(next,0,0,MagickTrue,exception);
+          if (image != (Image *) NULL)
+            {
+              AppendImageToList(&clone_images,image);
+              clone_images=image;
+              match=MagickTrue;
+            }
+        }
       if (match == MagickFalse)
         (void) ThrowMagickException(exception,GetMagickModule(),OptionError,
           "InvalidImageIndex","%g `%s'",(double) offset,images->filename);
@@ -587,9 +1044,28 @@ MagickExport Image *GetFirstImageInList(const Image *images)
   const Image
     *p;
 
+  ImageListIndex
+    *list_index;
+
+  size_t
+    offset;
+
   if (images == (Image *) NULL)
     return((Image *) NULL);
   assert(images->signature == MagickCoreSignature);
+  if (images->previous == (Image *) NULL)
+    return((Image *) images);
+  if (IsShortImageList(images) == MagickFalse)
+    {
+      LockImageListIndex();
+      list_index=GetImageListIndex(images,&offset);
+      p=(const Image *) NULL;
+      if (list_index != (ImageListIndex *) NULL)
+        p=list_index->images[list_index->first];
+      UnlockImageListIndex();
+      if (p != (const Image *) NULL)
+        return((Image *) p);
+    }
   for (p=images; p->previous != (Image *) NULL; p=p->previous) ;
   return((Image *) p);
 }
@@ -631,6 +1107,12 @@ MagickExport Image *GetImageFromList(const Image *images,const ssize_t index)
   const Image
     *p;
 
+  ImageListIndex
+    *list_index;
+
+  size_t
+    offset;
+
   ssize_t
     i;
 
@@ -639,6 +1121,24 @@ MagickExport Image *GetImageFromList(const Image *images,const ssize_t index)
   assert(images->signature == MagickCoreSignature);
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",images->filename);
+  if (IsShortImageList(images) == MagickFalse)
+    {
+      LockImageListIndex();
+      list_index=GetImageListIndex(images,&offset);
+      if (list_index != (ImageListIndex *) NULL)
+        {
+          i=index;
+          if (i < 0)
+            i+=(ssize_t) (list_index->number_images-list_index->first);
+          p=(const Image *) NULL;
+          if ((i >= 0) && (i < (ssize_t) (list_index->number_images-
+               list_index->first)))
+            p=list_index->images[list_index->first+(size_t) i];
+          UnlockImageListIndex();
+          return((Image *) p);
+        }
+      UnlockImageListIndex();
+    }
   if (index < 0)
     {
       p=GetLastImageInList(images);
@@ -680,12 +1180,31 @@ MagickExport Image *GetImageFromList(const Image *images,const ssize_t index)
 */
 MagickExport ssize_t GetImageIndexInList(const Image *images)
 {
+  ImageListIndex
+    *list_index;
+
+  size_t
+    offset;
+
   ssize_t
     i;
 
   if (images == (const Image *) NULL)
     return(-1);
   assert(images->signature == MagickCoreSignature);
+  if (images->previous == (Image *) NULL)
+    return(0);
+  if (IsShortImageList(images) == MagickFalse)
+    {
+      LockImageListIndex();
+      list_index=GetImageListIndex(images,&offset);
+      i=(-1);
+      if (list_index != (ImageListIndex *) NULL)
+        i=(ssize_t) (offset-list_index->first);
+      UnlockImageListIndex();
+      if (i >= 0)
+        return(i);
+    }
   for (i=0; images->previous != (Image *) NULL; i++)
   {
     assert(images != images->previous);
@@ -719,14 +1238,29 @@ MagickExport ssize_t GetImageIndexInList(const Image *images)
 */
 MagickExport size_t GetImageListLength(const Image *images)
 {
+  ImageListIndex
+    *list_index;
+
   size_t
-    i;
+    i,
+    offset;
 
   if (images == (Image *) NULL)
     return(0);
   assert(images->signature == MagickCoreSignature);
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",images->filename);
+  if (IsShortImageList(images) == MagickFalse)
+    {
+      LockImageListIndex();
+      list_index=GetImageListIndex(images,&offset);
+      i=0;
+      if (list_index != (ImageListIndex *) NULL)
+        i=list_index->number_images-list_index->first;
+      UnlockImageListIndex();
+      if (i != 0)
+        return(i);
+    }
   images=GetLastImageInList(images);
   for (i=0; images != (Image *) NULL; images=images->previous)
   {
@@ -763,9 +1297,28 @@ MagickExport Image *GetLastImageInList(const Image *images)
   const Image
     *p;
 
+  ImageListIndex
+    *list_index;
+
+  size_t
+    offset;
+
   if (images == (Image *) NULL)
     return((Image *) NULL);
   assert(images->signature == MagickCoreSignature);
+  if (images->next == (Image *) NULL)
+    return((Image *) images);
+  if (IsShortImageList(images) == MagickFalse)
+    {
+      LockImageListIndex();
+      list_index=GetImageListIndex(images,&offset);
+      p=(const Image *) NULL;
+      if (list_index != (ImageListIndex *) NULL)
+        p=list_index->images[list_index->number_images-1];
+      UnlockImageListIndex();
+      if (p != (const Image *) NULL)
+        return((Image *) p);
+    }
   for (p=images; p->next != (Image *) NULL; p=p->next) ;
   return((Image *) p);
 }
@@ -941,6 +1494,43 @@ MagickExport void InsertImageInList(Image **images,Image *insert)
   AppendImageToList(images,split);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   L i s t C o m p o n e n t T e r m i n u s                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ListComponentTerminus() destroys the image list component.
+%
+%  The format of the ListComponentTerminus method is:
+%
+%      ListComponentTerminus(void)
+%
+*/
+MagickPrivate void ListComponentTerminus(void)
+{
+  size_t
+    i;
+
+  if (list_semaphore == (SemaphoreInfo *) NULL)
+    ActivateSemaphoreInfo(&list_semaphore);
+  LockSemaphoreInfo(list_semaphore);
+  for (i=0; i < list_extent; i++)
+    if (list_entries[i].image != (const Image *) NULL)
+      ReleaseImageListIndex(list_entries[i].list_index);
+  if (list_entries != (ImageListEntry *) NULL)
+    list_entries=(ImageListEntry *) RelinquishMagickMemory(list_entries);
+  list_extent=0;
+  number_list_entries=0;
+  UnlockSemaphoreInfo(list_semaphore);
+  RelinquishSemaphoreInfo(&list_semaphore);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -998,6 +1588,38 @@ MagickExport void PrependImageToList(Image **images,Image *prepend)
   AppendImageToList(&prepend,*images);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   R e l i n q u i s h I m a g e L i s t I n d e x                           %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  RelinquishImageListIndex() drops the image from the index of its image
+%  list, marking the index stale.
+%
+%  The format of the RelinquishImageListIndex method is:
+%
+%      void RelinquishImageListIndex(const Image *image)
+%
+%  A description of each parameter follows:
+%
+%    o image: the image.
+%
+*/
+MagickPrivate void RelinquishImageListIndex(const Image *image)
+{
+  if (list_semaphore == (SemaphoreInfo *) NULL)
+    return;
+  LockImageListIndex();
+  DetachImageListEntry(image,MagickTrue);
+  UnlockImageListIndex();
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1037,6 +1659,7 @@ MagickExport Image *RemoveImageFromList(Image **images)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",
       (*images)->filename);
   p=(*images);
+  RemoveImageFromListIndex(p);
   if ((p->previous == (Image *) NULL) && (p->next == (Image *) NULL))
     *images=(Image *) NULL;
   else
@@ -1095,9 +1718,8 @@ MagickExport Image *RemoveFirstImageFromList(Image **images)
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",
       (*images)->filename);
-  image=(*images);
-  while (image->previous != (Image *) NULL)
-    image=image->previous;
+  image=GetFirstImageInList(*images);
+  RemoveImageFromListIndex(image);
   if (image == *images)
     *images=(*images)->next;
   if (image->next != (Image *) NULL)
@@ -1146,9 +1768,8 @@ MagickExport Image *RemoveLastImageFromList(Image **images)
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",
       (*images)->filename);
-  image=(*images);
-  while (image->next != (Image *) NULL)
-    image=image->next;
+  image=GetLastImageInList(*images);
+  RemoveImageFromListIndex(image);
   if (image == *images)
     *images=(*images)->previous;
   if (image->previous != (Image *) NULL)
@@ -1197,6 +1818,8 @@ MagickExport void ReplaceImageInList(Image **images,Image *replace)
   if ((*images) == (Image *) NULL)
     return;
   assert((*images)->signature == MagickCoreSignature);
+  ResetImageListIndex(*images);
+  ResetImageListIndex(replace);
   /*
     Link next pointer.
   */
@@ -1258,6 +1881,8 @@ MagickExport void ReplaceImageInListReturnLast(Image **images,Image *replace)
   if ((*images) == (Image *) NULL)
     return;
   assert((*images)->signature == MagickCoreSignature);
+  ResetImageListIndex(*images);
+  ResetImageListIndex(replace);
   /*
     Link previous pointer.
   */
@@ -1317,6 +1942,7 @@ MagickExport void ReverseImageList(Image **images)
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",
       (*images)->filename);
+  ResetImageListIndex(*images);
   for (p=(*images); p->next != (Image *) NULL; p=p->next) ;
   *images=p;
   for ( ; p != (Image *) NULL; p=p->next)
@@ -1410,6 +2036,7 @@ MagickExport Image *SplitImageList(Image *images)
 {
   if ((images == (Image *) NULL) || (images->next == (Image *) NULL))
     return((Image *) NULL);
+  ResetImageListIndex(images);
   images=images->next;
   images->previous->next=(Image *) NULL;
   images->previous=(Image *) NULL;
@@ -1447,6 +2074,11 @@ MagickExport void SyncImageList(Image *images)
   if (images == (Image *) NULL)
     return;
   assert(images->signature == MagickCoreSignature);
+  for (p=images; p->next != (Image *) NULL; p=p->next)
+    if (p->next->scene <= p->scene)
+      break;
+  if (p->next == (Image *) NULL)
+    return;  /* scenes strictly increase, so they are distinct */
   for (p=images; p != (Image *) NULL; p=p->next)
   {
     for (q=p->next; q != (Image *) NULL; q=q->next)
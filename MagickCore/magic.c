@@ -86,6 +86,25 @@ typedef struct _MagicMapInfo
     skip_spaces;
 } MagicMapInfo;
 
+typedef struct _MagicIndexInfo
+{
+  const MagicInfo
+    **magic_info;
+
+  size_t
+    number_entries;
+
+  MagickOffsetType
+    *offsets;
+
+  size_t
+    number_offsets,
+    *buckets,
+    *entries,
+    *unkeyed,
+    number_unkeyed;
+} MagicIndexInfo;
+
 struct _MagicInfo
 {
   char
@@ -121,11 +140,12 @@ static const MagicMapInfo
   };
 
 static LinkedListInfo
-  *magic_cache = (LinkedListInfo *) NULL,
   *magic_list = (LinkedListInfo *) NULL;
 
+static MagicIndexInfo
+  *magic_index = (MagicIndexInfo *) NULL;
+
 static SemaphoreInfo
-  *magic_cache_semaphore = (SemaphoreInfo *) NULL,
   *magic_list_semaphore = (SemaphoreInfo *) NULL;
 
 /*
@@ -231,6 +251,161 @@ static LinkedListInfo *AcquireMagicList(ExceptionInfo *exception)
   }
   return(list);
 }
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++  A c q u i r e M a g i c I n d e x                                          %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  AcquireMagicIndex() builds an immutable detection index over the magic
+%  list.  Patterns are bucketed by their offset and the value of their first
+%  byte; each bucket lists its entries in magic list order so a lookup
+%  returns the same entry as a linear walk of the list, without locking.
+%  Patterns that skip leading spaces, or that are empty, are kept in a
+%  separate unkeyed list that is always checked.
+%
+%  The format of the AcquireMagicIndex method is:
+%
+%      MagicIndexInfo *AcquireMagicIndex(LinkedListInfo *list)
+%
+%  A description of each parameter follows:
+%
+%    o list: the magic list.
+%
+*/
+
+static MagicIndexInfo *DestroyMagicIndex(MagicIndexInfo *index)
+{
+  if (index->unkeyed != (size_t *) NULL)
+    index->unkeyed=(size_t *) RelinquishMagickMemory(index->unkeyed);
+  if (index->entries != (size_t *) NULL)
+    index->entries=(size_t *) RelinquishMagickMemory(index->entries);
+  if (index->buckets != (size_t *) NULL)
+    index->buckets=(size_t *) RelinquishMagickMemory(index->buckets);
+  if (index->offsets != (MagickOffsetType *) NULL)
+    index->offsets=(MagickOffsetType *) RelinquishMagickMemory(
+      index->offsets);
+  if (index->magic_info != (const MagicInfo **) NULL)
+    index->magic_info=(const MagicInfo **) RelinquishMagickMemory(
+      (void *) index->magic_info);
+  index=(MagicIndexInfo *) RelinquishMagickMemory(index);
+  return(index);
+}
+
+static inline MagickBooleanType IsMagicKeyed(const MagicInfo *magic_info)
+{
+  if ((magic_info->skip_spaces != MagickFalse) || (magic_info->length == 0))
+    return(MagickFalse);
+  return(MagickTrue);
+}
+
+static MagicIndexInfo *AcquireMagicIndex(LinkedListInfo *list)
+{
+  ElementInfo
+    *p;
+
+  MagicIndexInfo
+    *index;
+
+  size_t
+    *fill;
+
+  ssize_t
+    i,
+    j;
+
+  index=(MagicIndexInfo *) AcquireMagickMemory(sizeof(*index));
+  if (index == (MagicIndexInfo *) NULL)
+    return(index);
+  (void) memset(index,0,sizeof(*index));
+  index->number_entries=GetNumberOfElementsInLinkedList(list);
+  index->magic_info=(const MagicInfo **) AcquireQuantumMemory(
+    index->number_entries+1,sizeof(*index->magic_info));
+  index->offsets=(MagickOffsetType *) AcquireQuantumMemory(
+    index->number_entries+1,sizeof(*index->offsets));
+  index->entries=(size_t *) AcquireQuantumMemory(index->number_entries+1,
+    sizeof(*index->entries));
+  index->unkeyed=(size_t *) AcquireQuantumMemory(index->number_entries+1,
+    sizeof(*index->unkeyed));
+  if ((index->magic_info == (const MagicInfo **) NULL) ||
+      (index->offsets == (MagickOffsetType *) NULL) ||
+      (index->entries == (size_t *) NULL) ||
+      (index->unkeyed == (size_t *) NULL))
+    return(DestroyMagicIndex(index));
+  /*
+    Collect the entries in priority order and their distinct offsets.
+  */
+  i=0;
+  for (p=GetHeadElementInLinkedList(list); p != (ElementInfo *) NULL; p=p->next)
+  {
+    const MagicInfo
+      *magic_info;
+
+    magic_info=(const MagicInfo *) p->value;
+    index->magic_info[i++]=magic_info;
+    if (IsMagicKeyed(magic_info) == MagickFalse)
+      {
+        index->unkeyed[index->number_unkeyed++]=(size_t) i-1;
+        continue;
+      }
+    for (j=0; j < (ssize_t) index->number_offsets; j++)
+      if (index->offsets[j] == magic_info->offset)
+        break;
+    if (j == (ssize_t) index->number_offsets)
+      index->offsets[index->number_offsets++]=magic_info->offset;
+  }
+  index->number_entries=(size_t) i;
+  /*
+    Bucket the keyed entries by offset and first pattern byte.
+  */
+  index->buckets=(size_t *) AcquireQuantumMemory(256*index->number_offsets+1,
+    sizeof(*index->buckets));
+  fill=(size_t *) AcquireQuantumMemory(256*index->number_offsets+1,
+    sizeof(*fill));
+  if ((index->buckets == (size_t *) NULL) || (fill == (size_t *) NULL))
+    {
+      if (fill != (size_t *) NULL)
+        fill=(size_t *) RelinquishMagickMemory(fill);
+      return(DestroyMagicIndex(index));
+    }
+  (void) memset(fill,0,(256*index->number_offsets+1)*sizeof(*fill));
+  for (i=0; i < (ssize_t) index->number_entries; i++)
+  {
+    const MagicInfo
+      *magic_info = index->magic_info[i];
+
+    if (IsMagicKeyed(magic_info) == MagickFalse)
+      continue;
+    for (j=0; index->offsets[j] != magic_info->offset; j++) ;
+    fill[256*j+(ssize_t) *magic_info->magic+1]++;
+  }
+  index->buckets[0]=0;
+  for (i=1; i <= (ssize_t) (256*index->number_offsets); i++)
+    index->buckets[i]=index->buckets[i-1]+fill[i];
+  (void) memset(fill,0,(256*index->number_offsets+1)*sizeof(*fill));
+  for (i=0; i < (ssize_t) index->number_entries; i++)
+  {
+    const MagicInfo
+      *magic_info = index->magic_info[i];
+
+    size_t
+      bucket;
+
+    if (IsMagicKeyed(magic_info) == MagickFalse)
+      continue;
+    for (j=0; index->offsets[j] != magic_info->offset; j++) ;
+    bucket=(size_t) (256*j+(ssize_t) *magic_info->magic);
+    index->entries[index->buckets[bucket]+fill[bucket]++]=(size_t) i;
+  }
+  fill=(size_t *) RelinquishMagickMemory(fill);
+  return(index);
+}
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -286,83 +461,96 @@ static inline MagickBooleanType CompareMagic(const unsigned char *magic,
   return(MagickFalse);
 }
 
-static MagickBooleanType IsMagicCacheInstantiated(void)
-{
-  if (magic_cache == (LinkedListInfo *) NULL)
-    {
-      if (magic_cache_semaphore == (SemaphoreInfo *) NULL)
-        ActivateSemaphoreInfo(&magic_cache_semaphore);
-      LockSemaphoreInfo(magic_cache_semaphore);
-      if (magic_cache == (LinkedListInfo *) NULL)
-        magic_cache=NewLinkedList(0);
-      UnlockSemaphoreInfo(magic_cache_semaphore);
-    }
-  return(magic_cache != (LinkedListInfo *) NULL ? MagickTrue : MagickFalse);
-}
-
 MagickExport const MagicInfo *GetMagicInfo(const unsigned char *magic,
   const size_t length,ExceptionInfo *exception)
 {
-  const MagicInfo *
-    magic_info;
+  const MagicIndexInfo
+    *index;
 
-  ElementInfo
-    *p;
+  size_t
+    best;
+
+  ssize_t
+    i;
 
   assert(exception != (ExceptionInfo *) NULL);
   if (IsMagicListInstantiated(exception) == MagickFalse)
     return((const MagicInfo *) NULL);
-  if (IsMagicCacheInstantiated() == MagickFalse)
+  index=magic_index;
+  if (index == (const MagicIndexInfo *) NULL)
+    {
+      const MagicInfo
+        *magic_info;
+
+      ElementInfo
+        *p;
+
+      /*
+        The index could not be built, try again; until it is, search the
+        magic list in priority order.
+      */
+      LockSemaphoreInfo(magic_list_semaphore);
+      if (magic_index == (MagicIndexInfo *) NULL)
+        magic_index=AcquireMagicIndex(magic_list);
+      index=magic_index;
+      if (index == (const MagicIndexInfo *) NULL)
+        {
+          p=GetHeadElementInLinkedList(magic_list);
+          if (magic != (const unsigned char *) NULL)
+            while (p != (ElementInfo *) NULL)
+            {
+              if (CompareMagic(magic,length,(const MagicInfo *) p->value) !=
+                  MagickFalse)
+                break;
+              p=p->next;
+            }
+          magic_info=(const MagicInfo *) NULL;
+          if (p != (ElementInfo *) NULL)
+            magic_info=(const MagicInfo *) p->value;
+          UnlockSemaphoreInfo(magic_list_semaphore);
+          return(magic_info);
+        }
+      UnlockSemaphoreInfo(magic_list_semaphore);
+    }
+  if (index->number_entries == 0)
     return((const MagicInfo *) NULL);
+  if (magic == (const unsigned char *) NULL)
+    return(index->magic_info[0]);
   /*
-    Search for cached entries.
+    Search the index for the highest priority matching magic tag.
   */
-  magic_info=(const MagicInfo *) NULL;
-  if (magic != (const unsigned char *) NULL)
-    {
-      LockSemaphoreInfo(magic_cache_semaphore);
-      p=GetHeadElementInLinkedList(magic_cache);
-      while (p != (ElementInfo *) NULL)
+  best=index->number_entries;
+  for (i=0; i < (ssize_t) index->number_unkeyed; i++)
+    if (CompareMagic(magic,length,index->magic_info[index->unkeyed[i]]) !=
+        MagickFalse)
       {
-        magic_info=(const MagicInfo *) p->value;
-        if (CompareMagic(magic,length,magic_info) != MagickFalse)
-          break;
-        p=p->next;
+        best=index->unkeyed[i];
+        break;
       }
-      UnlockSemaphoreInfo(magic_cache_semaphore);
-      if (p != (ElementInfo *) NULL)
-        return(magic_info);
-    }
-  /*
-    Search for magic tag.
-  */
-  LockSemaphoreInfo(magic_list_semaphore);
-  p=GetHeadElementInLinkedList(magic_list);
-  if (magic == (const unsigned char *) NULL)
-    {
-      UnlockSemaphoreInfo(magic_list_semaphore);
-      if (p != (ElementInfo *) NULL)
-        magic_info=(const MagicInfo *) p->value;
-      return(magic_info);
-    }
-  while (p != (ElementInfo *) NULL)
+  for (i=0; i < (ssize_t) index->number_offsets; i++)
   {
-    magic_info=(const MagicInfo *) p->value;
-    if (CompareMagic(magic,length,magic_info) != MagickFalse)
-      break;
-    p=p->next;
-  }
-  UnlockSemaphoreInfo(magic_list_semaphore);
-  if (p == (ElementInfo *) NULL)
-    magic_info=(const MagicInfo *) NULL;
-  else
+    size_t
+      bucket,
+      j;
+
+    if (index->offsets[i] >= (MagickOffsetType) length)
+      continue;
+    bucket=(size_t) (256*i+(ssize_t) magic[index->offsets[i]]);
+    for (j=index->buckets[bucket]; j < index->buckets[bucket+1]; j++)
     {
-      LockSemaphoreInfo(magic_cache_semaphore);
-      (void) InsertValueInSortedLinkedList(magic_cache,CompareMagickInfoExtent,
-        NULL,magic_info);
-      UnlockSemaphoreInfo(magic_cache_semaphore);
+      if (index->entries[j] >= best)
+        break;
+      if (CompareMagic(magic,length,index->magic_info[index->entries[j]]) !=
+          MagickFalse)
+        {
+          best=index->entries[j];
+          break;
+        }
     }
-  return(magic_info);
+  }
+  if (best == index->number_entries)
+    return((const MagicInfo *) NULL);
+  return(index->magic_info[best]);
 }
 
 /*
@@ -472,7 +660,7 @@ static int MagicInfoCompare(const void *x,const void *y)
 #endif
 
 MagickExport const MagicInfo **GetMagicInfoList(const char *pattern,
-  size_t *number_aliases,ExceptionInfo *magick_unused(exception))
+  size_t *number_aliases,ExceptionInfo *exception)
 {
   const MagicInfo
     **aliases;
@@ -483,13 +671,12 @@ MagickExport const MagicInfo **GetMagicInfoList(const char *pattern,
   ssize_t
     i;
 
-  magick_unreferenced(exception);
   assert(pattern != (char *) NULL);
   assert(number_aliases != (size_t *) NULL);
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",pattern);
   *number_aliases=0;
-  if (IsMagicCacheInstantiated() == MagickFalse)
+  if (IsMagicListInstantiated(exception) == MagickFalse)
     return((const MagicInfo **) NULL);
   aliases=(const MagicInfo **) AcquireQuantumMemory((size_t)
     GetNumberOfElementsInLinkedList(magic_list)+1UL,sizeof(*aliases));
@@ -569,7 +756,7 @@ static int MagicCompare(const void *x,const void *y)
 #endif
 
 MagickExport char **GetMagicList(const char *pattern,size_t *number_aliases,
-  ExceptionInfo *magick_unused(exception))
+  ExceptionInfo *exception)
 {
   char
     **aliases;
@@ -580,13 +767,12 @@ MagickExport char **GetMagicList(const char *pattern,size_t *number_aliases,
   ssize_t
     i;
   
-  magick_unreferenced(exception);
   assert(pattern != (char *) NULL);
   assert(number_aliases != (size_t *) NULL);
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",pattern);
   *number_aliases=0;
-  if (IsMagicCacheInstantiated() == MagickFalse)
+  if (IsMagicListInstantiated(exception) == MagickFalse)
     return((char **) NULL);
   aliases=(char **) AcquireQuantumMemory((size_t)
     GetNumberOfElementsInLinkedList(magic_list)+1UL,sizeof(*aliases));
@@ -678,7 +864,15 @@ static MagickBooleanType IsMagicListInstantiated(ExceptionInfo *exception)
         ActivateSemaphoreInfo(&magic_list_semaphore);
       LockSemaphoreInfo(magic_list_semaphore);
       if (magic_list == (LinkedListInfo *) NULL)
-        magic_list=AcquireMagicList(exception);
+        {
+          LinkedListInfo
+            *list;
+
+          list=AcquireMagicList(exception);
+          if (list != (LinkedListInfo *) NULL)
+            magic_index=AcquireMagicIndex(list);
+          magic_list=list;
+        }
       UnlockSemaphoreInfo(magic_list_semaphore);
     }
   return(magic_list != (LinkedListInfo *) NULL ? MagickTrue : MagickFalse);
@@ -809,15 +1003,10 @@ MagickPrivate void MagicComponentTerminus(void)
   if (magic_list_semaphore == (SemaphoreInfo *) NULL)
     ActivateSemaphoreInfo(&magic_list_semaphore);
   LockSemaphoreInfo(magic_list_semaphore);
+  if (magic_index != (MagicIndexInfo *) NULL)
+    magic_index=DestroyMagicIndex(magic_index);
   if (magic_list != (LinkedListInfo *) NULL)
     magic_list=DestroyLinkedList(magic_list,DestroyMagicElement);
   UnlockSemaphoreInfo(magic_list_semaphore);
   RelinquishSemaphoreInfo(&magic_list_semaphore);
-  if (magic_cache_semaphore == (SemaphoreInfo *) NULL)
-    ActivateSemaphoreInfo(&magic_cache_semaphore);
-  LockSemaphoreInfo(magic_cache_semaphore);
-  if (magic_cache != (LinkedListInfo *) NULL)
-    magic_cache=DestroyLinkedList(magic_cache,(void *(*)(void *)) NULL);
-  UnlockSemaphoreInfo(magic_cache_semaphore);
-  RelinquishSemaphoreInfo(&magic_cache_semaphore);
 }
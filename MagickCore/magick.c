@@ -55,6 +55,7 @@
 #include "MagickCore/draw.h"
 #include "MagickCore/exception.h"
 #include "MagickCore/exception-private.h"
+#include "MagickCore/list-private.h"
 #include "MagickCore/locale-private.h"
 #include "MagickCore/log-private.h"
 #include "MagickCore/magic-private.h"
@@ -1643,6 +1644,7 @@ MagickExport void MagickCoreTerminus(void)
     }
   MonitorComponentTerminus();
   RegistryComponentTerminus();
+  ListComponentTerminus();
   AnnotateComponentTerminus();
   MimeComponentTerminus();
   TypeComponentTerminus();
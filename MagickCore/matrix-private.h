@@ -26,6 +26,7 @@ extern MagickPrivate MagickBooleanType
   GaussJordanElimination(double **,double **,const size_t,const size_t);
 
 extern MagickPrivate void
+  *GetMatrixElements(const MatrixInfo *),
   LeastSquaresAddTerms(double **,double **,const double *,const double *,
     const size_t, const size_t);
 
@@ -728,6 +728,39 @@ MagickExport MagickBooleanType GetMatrixElement(const MatrixInfo *matrix_info,
   return(MagickTrue);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   G e t M a t r i x E l e m e n t s                                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  GetMatrixElements() returns the elements of the matrix, row by row, when
+%  they are held in memory or memory-mapped, so they can be accessed directly.
+%  NULL is returned if the matrix is cached on disk.
+%
+%  The format of the GetMatrixElements method is:
+%
+%      void *GetMatrixElements(const MatrixInfo *matrix_info)
+%
+%  A description of each parameter follows:
+%
+%    o matrix_info: the matrix.
+%
+*/
+MagickPrivate void *GetMatrixElements(const MatrixInfo *matrix_info)
+{
+  assert(matrix_info != (const MatrixInfo *) NULL);
+  assert(matrix_info->signature == MagickCoreSignature);
+  if (matrix_info->type == DiskCache)
+    return((void *) NULL);
+  return(matrix_info->elements);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -316,6 +316,7 @@ extern "C" {
 #define ErrorBlob  PrependMagickMethod(ErrorBlob)
 #define EscapeString  PrependMagickMethod(EscapeString)
 #define EvaluateImage  PrependMagickMethod(EvaluateImage)
+#define EvaluateImageOperators  PrependMagickMethod(EvaluateImageOperators)
 #define EvaluateImages  PrependMagickMethod(EvaluateImages)
 #define ExceptionComponentGenesis  PrependMagickMethod(ExceptionComponentGenesis)
 #define ExceptionComponentTerminus  PrependMagickMethod(ExceptionComponentTerminus)
@@ -1176,7 +1177,10 @@ extern "C" {
 #define SetResampleFilterVirtualPixelMethod  PrependMagickMethod(SetResampleFilterVirtualPixelMethod)
 #define SetSignatureDigest  PrependMagickMethod(SetSignatureDigest)
 #define SetStreamInfoClientData  PrependMagickMethod(SetStreamInfoClientData)
+#define SetStreamInfoColorspace  PrependMagickMethod(SetStreamInfoColorspace)
+#define SetStreamInfoLevel  PrependMagickMethod(SetStreamInfoLevel)
 #define SetStreamInfoMap  PrependMagickMethod(SetStreamInfoMap)
+#define SetStreamInfoResize  PrependMagickMethod(SetStreamInfoResize)
 #define SetStreamInfoStorageType  PrependMagickMethod(SetStreamInfoStorageType)
 #define SetStringInfoDatum  PrependMagickMethod(SetStringInfoDatum)
 #define SetStringInfoLength  PrependMagickMethod(SetStringInfoLength)
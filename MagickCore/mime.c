@@ -901,12 +901,15 @@ static MagickBooleanType LoadMimeCache(LinkedListInfo *cache,const char *xml,
         unsigned char
           *q;
 
-        token=AcquireString(attribute);
-        (void) SubstituteString((char **) &token,"&lt;","<");
-        (void) SubstituteString((char **) &token,"&amp;","&");
-        (void) SubstituteString((char **) &token,"&quot;","\"");
-        (void) SubstituteString((char **) &token,"&apos;","'");
-        mime_info->magic=(unsigned char *) AcquireString(token);
+        token=ConstantString(attribute);
+        if (strchr(token,'&') != (char *) NULL)
+          {
+            (void) SubstituteString((char **) &token,"&lt;","<");
+            (void) SubstituteString((char **) &token,"&amp;","&");
+            (void) SubstituteString((char **) &token,"&quot;","\"");
+            (void) SubstituteString((char **) &token,"&apos;","'");
+          }
+        mime_info->magic=(unsigned char *) ConstantString(token);
         q=mime_info->magic;
         for (p=token; *p != '\0'; )
         {
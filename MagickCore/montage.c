@@ -284,6 +284,51 @@ static void GetMontageGeometry(char *geometry,const size_t number_images,
     *tiles_per_row=(size_t) ceil((double) number_images/(*tiles_per_column));
 }
 
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+static int GetMontageNumberThreads(Image **image_list,
+  const size_t number_images,const size_t copies)
+{
+  MagickSizeType
+    available,
+    extent,
+    limit,
+    memory;
+
+  size_t
+    i,
+    number_threads;
+
+  /*
+    Each thread holds a few copies of the image it works on: bound the
+    threads by the images, the thread limit, and the memory left.
+  */
+  number_threads=(size_t) MagickMin((MagickSizeType) number_images,
+    GetMagickResourceLimit(ThreadResource));
+  extent=0;
+  for (i=0; i < number_images; i++)
+  {
+    const CacheType
+      type = (CacheType) GetImagePixelCacheType(image_list[i]);
+
+    MagickSizeType
+      length;
+
+    if ((type != MemoryCache) && (type != MapCache))
+      number_threads=MagickMin(number_threads,2);
+    length=(MagickSizeType) image_list[i]->columns*image_list[i]->rows*
+      image_list[i]->number_channels*sizeof(Quantum);
+    if (length > extent)
+      extent=length;
+  }
+  limit=GetMagickResourceLimit(MemoryResource);
+  memory=GetMagickResource(MemoryResource);
+  available=limit > memory ? limit-memory : 0;
+  if ((extent != 0) && ((available/(copies*extent)) < number_threads))
+    number_threads=(size_t) (available/(copies*extent));
+  return((int) MagickMax(number_threads,1));
+}
+#endif
+
 #if defined(__cplusplus) || defined(c_plusplus)
 extern "C" {
 #endif
@@ -343,8 +388,7 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
     **primary_list,
     *montage,
     *texture,
-    *tile_image,
-    *thumbnail;
+    **tile_images;
 
   ImageInfo
     *clone_info;
@@ -355,6 +399,7 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
     status;
 
   MagickOffsetType
+    progress,
     tiles;
 
   MagickProgressMonitor
@@ -368,8 +413,8 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
 
   RectangleInfo
     bounds,
-    geometry,
-    extract_info;
+    extract_info,
+    *tile_info;
 
   size_t
     border_width,
@@ -379,6 +424,7 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
     max_height,
     number_images,
     number_lines,
+    number_tiles,
     sans,
     tiles_per_column,
     tiles_per_page,
@@ -390,7 +436,6 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
   ssize_t
     bevel_width,
     tile,
-    x,
     x_offset,
     y,
     y_offset;
@@ -415,36 +460,76 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
     return((Image *) NULL);
   image_list=primary_list;
   image=image_list[0];
-  thumbnail=NewImageList();
+  status=MagickTrue;
+  progress=0;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(dynamic,1) shared(progress,status) \
+    num_threads(GetMontageNumberThreads(image_list,number_images,2))
+#endif
   for (i=0; i < (ssize_t) number_images; i++)
   {
-    image=CloneImage(image_list[i],0,0,MagickTrue,exception);
-    if (image == (Image *) NULL)
-      break;
-    (void) ParseAbsoluteGeometry("0x0+0+0",&image->page);
-    progress_monitor=SetImageProgressMonitor(image,(MagickProgressMonitor) NULL,
-      image->client_data);
-    flags=ParseRegionGeometry(image,montage_info->geometry,&geometry,exception);
-    thumbnail=ThumbnailImage(image,geometry.width,geometry.height,exception);
+    Image
+      *clone_image,
+      *thumbnail;
+
+    MagickProgressMonitor
+      clone_monitor;
+
+    RectangleInfo
+      thumbnail_geometry;
+
+    if (status == MagickFalse)
+      continue;
+    clone_image=CloneImage(image_list[i],0,0,MagickTrue,exception);
+    if (clone_image == (Image *) NULL)
+      {
+        status=MagickFalse;
+        continue;
+      }
+    (void) ParseAbsoluteGeometry("0x0+0+0",&clone_image->page);
+    clone_monitor=SetImageProgressMonitor(clone_image,(MagickProgressMonitor)
+      NULL,clone_image->client_data);
+    (void) ParseRegionGeometry(clone_image,montage_info->geometry,
+      &thumbnail_geometry,exception);
+    thumbnail=ThumbnailImage(clone_image,thumbnail_geometry.width,
+      thumbnail_geometry.height,exception);
     if (thumbnail == (Image *) NULL)
-      break;
+      {
+        clone_image=DestroyImage(clone_image);
+        status=MagickFalse;
+        continue;
+      }
     image_list[i]=thumbnail;
-    (void) SetImageProgressMonitor(image,progress_monitor,image->client_data);
-    proceed=SetImageProgress(image,TileImageTag,(MagickOffsetType) i,
-      number_images);
-    if (proceed == MagickFalse)
-      break;
-    image=DestroyImage(image);
+    (void) SetImageProgressMonitor(clone_image,clone_monitor,
+      clone_image->client_data);
+    if (clone_image->progress_monitor != (MagickProgressMonitor) NULL)
+      {
+        MagickBooleanType
+          proceed;
+
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+        #pragma omp atomic
+#endif
+        progress++;
+        proceed=SetImageProgress(clone_image,TileImageTag,progress,
+          number_images);
+        if (proceed == MagickFalse)
+          status=MagickFalse;
+      }
+    clone_image=DestroyImage(clone_image);
   }
-  if (i < (ssize_t) number_images)
+  if (status == MagickFalse)
     {
-      if (image != (Image *) NULL)
-        image=DestroyImage(image);
-      if (thumbnail == (Image *) NULL)
-        i--;
-      for (tile=0; (ssize_t) tile <= i; tile++)
-        if (image_list[tile] != (Image *) NULL)
-          image_list[tile]=DestroyImage(image_list[tile]);
+      /*
+        Release the thumbnails, the originals belong to the caller.
+      */
+      image=GetFirstImageInList(images);
+      for (i=0; i < (ssize_t) number_images; i++)
+      {
+        if (image_list[i] != image)
+          image_list[i]=DestroyImage(image_list[i]);
+        image=GetNextImageInList(image);
+      }
       primary_list=(Image **) RelinquishMagickMemory(primary_list);
       return((Image *) NULL);
     }
@@ -562,7 +647,20 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
   /*
     Allocate next structure.
   */
-  tile_image=AcquireImage((ImageInfo *) NULL,exception);
+  number_tiles=(size_t) MagickMin((ssize_t) (tiles_per_row*tiles_per_column),
+    (ssize_t) number_images);
+  tile_images=(Image **) AcquireQuantumMemory(number_tiles,
+    sizeof(*tile_images));
+  tile_info=(RectangleInfo *) AcquireQuantumMemory(number_tiles,
+    sizeof(*tile_info));
+  if ((tile_images == (Image **) NULL) || (tile_info == (RectangleInfo *) NULL))
+    {
+      if (tile_images != (Image **) NULL)
+        tile_images=(Image **) RelinquishMagickMemory(tile_images);
+      if (tile_info != (RectangleInfo *) NULL)
+        tile_info=(RectangleInfo *) RelinquishMagickMemory(tile_info);
+      ThrowImageException(ResourceLimitError,"MemoryAllocationFailed");
+    }
   montage=AcquireImage(clone_info,exception);
   montage->background_color=montage_info->background_color;
   montage->scene=0;
@@ -714,22 +812,59 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
         &sans,&sans);
     x_offset+=extract_info.x;
     y_offset+=(ssize_t) title_offset+extract_info.y;
-    max_height=0;
+    number_tiles=(size_t) MagickMin((ssize_t) tiles_per_page,(ssize_t)
+      number_images);
+    (void) memset(tile_images,0,number_tiles*sizeof(*tile_images));
     status=MagickTrue;
-    for (tile=0; tile < MagickMin((ssize_t) tiles_per_page,(ssize_t) number_images); tile++)
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+    #pragma omp parallel for schedule(dynamic,1) shared(status) \
+      num_threads(GetMontageNumberThreads(image_list,number_tiles,4))
+#endif
+    for (tile=0; tile < (ssize_t) number_tiles; tile++)
     {
+      const char
+        *label;
+
+      GravityType
+        gravity;
+
+      Image
+        *clone_image;
+
+      size_t
+        tile_height,
+        tile_width;
+
+      ssize_t
+        column;
+
       /*
-        Copy this tile to the composite.
+        Border, frame, and shadow this tile; tiles are independent.
       */
-      image=CloneImage(image_list[tile],0,0,MagickTrue,exception);
-      if (image == (Image *) NULL)
-        ThrowImageException(ResourceLimitError,"MemoryAllocationFailed");
-      progress_monitor=SetImageProgressMonitor(image,
-        (MagickProgressMonitor) NULL,image->client_data);
-      width=concatenate != MagickFalse ? image->columns : extract_info.width;
-      if (image->rows > max_height)
-        max_height=image->rows;
-      height=concatenate != MagickFalse ? max_height : extract_info.height;
+      if (status == MagickFalse)
+        continue;
+      clone_image=CloneImage(image_list[tile],0,0,MagickTrue,exception);
+      if (clone_image == (Image *) NULL)
+        {
+          status=MagickFalse;
+          continue;
+        }
+      (void) SetImageProgressMonitor(clone_image,(MagickProgressMonitor) NULL,
+        clone_image->client_data);
+      tile_width=concatenate != MagickFalse ? clone_image->columns :
+        extract_info.width;
+      tile_height=extract_info.height;
+      if (concatenate != MagickFalse)
+        {
+          /*
+            Tallest tile so far in this row.
+          */
+          tile_height=0;
+          for (column=tile-(tile % (ssize_t) tiles_per_row); column <= tile;
+               column++)
+            if (image_list[column]->rows > tile_height)
+              tile_height=image_list[column]->rows;
+        }
       if (border_width != 0)
         {
           Image
@@ -745,36 +880,34 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
           border_info.height=border_width;
           if (montage_info->frame != (char *) NULL)
             {
-              border_info.width=(width-image->columns+1)/2;
-              border_info.height=(height-image->rows+1)/2;
+              border_info.width=(tile_width-clone_image->columns+1)/2;
+              border_info.height=(tile_height-clone_image->rows+1)/2;
             }
-          border_image=BorderImage(image,&border_info,image->compose,exception);
+          border_image=BorderImage(clone_image,&border_info,
+            clone_image->compose,exception);
           if (border_image != (Image *) NULL)
             {
-              image=DestroyImage(image);
-              image=border_image;
+              clone_image=DestroyImage(clone_image);
+              clone_image=border_image;
             }
           if ((montage_info->frame != (char *) NULL) &&
-              (image->compose == DstOutCompositeOp))
+              (clone_image->compose == DstOutCompositeOp))
             {
-              (void) SetPixelChannelMask(image,AlphaChannel);
-              (void) NegateImage(image,MagickFalse,exception);
-              (void) SetPixelChannelMask(image,DefaultChannels);
+              (void) SetPixelChannelMask(clone_image,AlphaChannel);
+              (void) NegateImage(clone_image,MagickFalse,exception);
+              (void) SetPixelChannelMask(clone_image,DefaultChannels);
             }
         }
       /*
         Gravitate as specified by the tile gravity.
       */
-      tile_image->columns=width;
-      tile_image->rows=height;
-      tile_image->gravity=montage_info->gravity;
-      if (image->gravity != UndefinedGravity)
-        tile_image->gravity=image->gravity;
-      (void) FormatLocaleString(tile_geometry,MagickPathExtent,
-        "%.20gx%.20g+0+0",(double) image->columns,(double) image->rows);
-      flags=ParseGravityGeometry(tile_image,tile_geometry,&geometry,exception);
-      x=geometry.x+(ssize_t) border_width;
-      y=geometry.y+(ssize_t) border_width;
+      gravity=montage_info->gravity;
+      if (clone_image->gravity != UndefinedGravity)
+        gravity=clone_image->gravity;
+      SetGeometry(clone_image,&tile_info[tile]);
+      GravityAdjustGeometry(tile_width,tile_height,gravity,&tile_info[tile]);
+      tile_info[tile].x+=(ssize_t) border_width;
+      tile_info[tile].y+=(ssize_t) border_width;
       if ((montage_info->frame != (char *) NULL) && (bevel_width > 0))
         {
           FrameInfo
@@ -787,47 +920,70 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
             Put an ornamental border around this tile.
           */
           frame_clone=frame_info;
-          frame_clone.width=width+2*frame_info.width;
-          frame_clone.height=height+2*frame_info.height;
-          value=GetImageProperty(image,"label",exception);
-          if (value != (const char *) NULL)
+          frame_clone.width=tile_width+2*frame_info.width;
+          frame_clone.height=tile_height+2*frame_info.height;
+          label=GetImageProperty(clone_image,"label",exception);
+          if (label != (const char *) NULL)
             frame_clone.height+=(size_t) ((metrics.ascent-metrics.descent+4)*
-              MultilineCensus(value));
-          frame_image=FrameImage(image,&frame_clone,image->compose,exception);
+              MultilineCensus(label));
+          frame_image=FrameImage(clone_image,&frame_clone,clone_image->compose,
+            exception);
           if (frame_image != (Image *) NULL)
             {
-              image=DestroyImage(image);
-              image=frame_image;
+              clone_image=DestroyImage(clone_image);
+              clone_image=frame_image;
+            }
+          tile_info[tile].x=0;
+          tile_info[tile].y=0;
+        }
+      if ((LocaleCompare(clone_image->magick,"NULL") != 0) &&
+          (montage_info->shadow != MagickFalse))
+        {
+          Image
+            *shadow_image;
+
+          /*
+            Shadow image.
+          */
+          (void) QueryColorCompliance("#0000",AllCompliance,
+            &clone_image->background_color,exception);
+          shadow_image=ShadowImage(clone_image,30.0,5.0,5,5,exception);
+          if (shadow_image != (Image *) NULL)
+            {
+              (void) CompositeImage(shadow_image,clone_image,OverCompositeOp,
+                MagickTrue,0,0,exception);
+              clone_image=DestroyImage(clone_image);
+              clone_image=shadow_image;
             }
-          x=0;
-          y=0;
         }
+      tile_info[tile].width=tile_width;
+      tile_info[tile].height=tile_height;
+      tile_images[tile]=clone_image;
+    }
+    if (status == MagickFalse)
+      {
+        for (tile=0; tile < (ssize_t) number_tiles; tile++)
+          if (tile_images[tile] != (Image *) NULL)
+            tile_images[tile]=DestroyImage(tile_images[tile]);
+        tile_info=(RectangleInfo *) RelinquishMagickMemory(tile_info);
+        tile_images=(Image **) RelinquishMagickMemory(tile_images);
+        ThrowImageException(ResourceLimitError,"MemoryAllocationFailed");
+      }
+    for (tile=0; tile < (ssize_t) number_tiles; tile++)
+    {
+      /*
+        Copy this tile to the composite.
+      */
+      image=tile_images[tile];
+      width=tile_info[tile].width;
+      height=tile_info[tile].height;
       if (LocaleCompare(image->magick,"NULL") != 0)
         {
           /*
             Composite background with tile.
           */
-          if (montage_info->shadow != MagickFalse)
-            {
-              Image
-                *shadow_image;
-
-              /*
-                Shadow image.
-              */
-              (void) QueryColorCompliance("#0000",AllCompliance,
-                &image->background_color,exception);
-              shadow_image=ShadowImage(image,30.0,5.0,5,5,exception);
-              if (shadow_image != (Image *) NULL)
-                {
-                  (void) CompositeImage(shadow_image,image,OverCompositeOp,
-                    MagickTrue,0,0,exception);
-                  image=DestroyImage(image);
-                  image=shadow_image;
-                }
-          }
           (void) CompositeImage(montage,image,image->compose,MagickTrue,
-            x_offset+x,y_offset+y,exception);
+            x_offset+tile_info[tile].x,y_offset+tile_info[tile].y,exception);
           value=GetImageProperty(image,"label",exception);
           if (value != (const char *) NULL)
             {
@@ -856,7 +1012,6 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
           y_offset+=((ssize_t) height+(extract_info.y+(ssize_t) border_width)*2+
             (metrics.ascent-metrics.descent+4)*number_lines+
             (montage_info->shadow != MagickFalse ? 4 : 0));
-          max_height=0;
         }
       if (images->progress_monitor != (MagickProgressMonitor) NULL)
         {
@@ -886,7 +1041,8 @@ MagickExport Image *MontageImageList(const ImageInfo *image_info,
         number_images-=tiles_per_page;
       }
   }
-  tile_image=DestroyImage(tile_image);
+  tile_info=(RectangleInfo *) RelinquishMagickMemory(tile_info);
+  tile_images=(Image **) RelinquishMagickMemory(tile_images);
   if (texture != (Image *) NULL)
     texture=DestroyImage(texture);
   title=DestroyString(title);
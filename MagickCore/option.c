@@ -146,6 +146,7 @@ static const OptionInfo
     { "Map", MapCache, UndefinedOptionFlag, MagickFalse },
     { "Memory", MemoryCache, UndefinedOptionFlag, MagickFalse },
     { "Ping", PingCache, UndefinedOptionFlag, MagickFalse },
+    { "View", ViewCache, UndefinedOptionFlag, MagickFalse },
     { (char *) NULL, MagickFalse, UndefinedOptionFlag, MagickFalse }
   },
   ChannelOptions[] =
@@ -2281,6 +2282,7 @@ static const OptionInfo
     { "FormatsMemory", FormatsMemoryValidate, UndefinedOptionFlag, MagickFalse },
     { "Identify", IdentifyValidate, UndefinedOptionFlag, MagickFalse },
     { "ImportExport", ImportExportValidate, UndefinedOptionFlag, MagickFalse },
+    { "Magic", MagicValidate, UndefinedOptionFlag, MagickFalse },
     { "Magick", MagickValidate, UndefinedOptionFlag, MagickFalse },
     { "Montage", MontageValidate, UndefinedOptionFlag, MagickFalse },
     { "Stream", StreamValidate, UndefinedOptionFlag, MagickFalse },
@@ -126,6 +126,7 @@ typedef enum
   MontageValidate = 0x00200,
   StreamValidate = 0x00400,
   MagickValidate = 0x00800,
+  MagicValidate = 0x01000,
   AllValidate = 0x7fffffff
 } ValidateType;
 
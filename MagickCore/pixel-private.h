@@ -25,6 +25,10 @@ extern "C" {
 extern MagickPrivate MagickBooleanType
   ResetPixelChannelMap(Image *,ExceptionInfo *);
 
+extern MagickPrivate void
+  InterpolateBilinearPixelInfo(const Image *,const Quantum *,const ssize_t,
+    const PointInfo *,PixelInfo *);
+
 #if defined(__cplusplus) || defined(c_plusplus)
 }
 #endif
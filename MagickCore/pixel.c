@@ -5376,39 +5376,33 @@ MagickExport MagickBooleanType InterpolatePixelChannels(
 %                                                                             %
 %                                                                             %
 %                                                                             %
-%   I n t e r p o l a t e P i x e l I n f o                                   %
++   I n t e r p o l a t e B i l i n e a r P i x e l I n f o                   %
 %                                                                             %
 %                                                                             %
 %                                                                             %
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
-%  InterpolatePixelInfo() applies a pixel interpolation method between a
-%  floating point coordinate and the pixels surrounding that coordinate.  No
-%  pixel area resampling, or scaling of the result is performed.
+%  InterpolateBilinearPixelInfo() bilinearly interpolates the RGBKA channels
+%  of a 2x2 neighbourhood of pixels already in memory, as
+%  InterpolatePixelInfo() does for BilinearInterpolatePixel.
 %
-%  Interpolation is restricted to just RGBKA channels.
+%  The format of the InterpolateBilinearPixelInfo method is:
 %
-%  The format of the InterpolatePixelInfo method is:
-%
-%      MagickBooleanType InterpolatePixelInfo(const Image *image,
-%        const CacheView *image_view,const PixelInterpolateMethod method,
-%        const double x,const double y,PixelInfo *pixel,
-%        ExceptionInfo *exception)
+%      void InterpolateBilinearPixelInfo(const Image *image,const Quantum *p,
+%        const ssize_t stride,const PointInfo *delta,PixelInfo *pixel)
 %
 %  A description of each parameter follows:
 %
 %    o image: the image.
 %
-%    o image_view: the image view.
+%    o p: the top-left pixel of the neighbourhood.
 %
-%    o method: the pixel color interpolation method.
+%    o stride: the number of quantums from a pixel to the one below it.
 %
-%    o x,y: A double representing the current (x,y) position of the pixel.
+%    o delta: the fractional offset of the coordinate from p.
 %
 %    o pixel: return the interpolated pixel here.
 %
-%    o exception: return any errors or warnings in this structure.
-%
 */
 
 static inline void AlphaBlendPixelInfo(const Image *image,
@@ -5436,6 +5430,88 @@ static inline void AlphaBlendPixelInfo(const Image *image,
   pixel_info->alpha=(double) GetPixelAlpha(image,pixel);
 }
 
+MagickPrivate void InterpolateBilinearPixelInfo(const Image *image,
+  const Quantum *p,const ssize_t stride,const PointInfo *delta,
+  PixelInfo *pixel)
+{
+  double
+    alpha[4],
+    gamma;
+
+  PixelInfo
+    pixels[4];
+
+  PointInfo
+    epsilon;
+
+  AlphaBlendPixelInfo(image,p,pixels,alpha);
+  AlphaBlendPixelInfo(image,p+GetPixelChannels(image),pixels+1,alpha+1);
+  AlphaBlendPixelInfo(image,p+stride,pixels+2,alpha+2);
+  AlphaBlendPixelInfo(image,p+stride+GetPixelChannels(image),pixels+3,alpha+3);
+  epsilon.x=1.0-delta->x;
+  epsilon.y=1.0-delta->y;
+  gamma=((epsilon.y*(epsilon.x*alpha[0]+delta->x*alpha[1])+delta->y*
+    (epsilon.x*alpha[2]+delta->x*alpha[3])));
+  gamma=PerceptibleReciprocal(gamma);
+  pixel->red=gamma*(epsilon.y*(epsilon.x*pixels[0].red+delta->x*
+    pixels[1].red)+delta->y*(epsilon.x*pixels[2].red+delta->x*pixels[3].red));
+  pixel->green=gamma*(epsilon.y*(epsilon.x*pixels[0].green+delta->x*
+    pixels[1].green)+delta->y*(epsilon.x*pixels[2].green+delta->x*
+    pixels[3].green));
+  pixel->blue=gamma*(epsilon.y*(epsilon.x*pixels[0].blue+delta->x*
+    pixels[1].blue)+delta->y*(epsilon.x*pixels[2].blue+delta->x*
+    pixels[3].blue));
+  if (image->colorspace == CMYKColorspace)
+    pixel->black=gamma*(epsilon.y*(epsilon.x*pixels[0].black+delta->x*
+      pixels[1].black)+delta->y*(epsilon.x*pixels[2].black+delta->x*
+      pixels[3].black));
+  gamma=((epsilon.y*(epsilon.x+delta->x)+delta->y*(epsilon.x+delta->x)));
+  gamma=PerceptibleReciprocal(gamma);
+  pixel->alpha=gamma*(epsilon.y*(epsilon.x*pixels[0].alpha+delta->x*
+    pixels[1].alpha)+delta->y*(epsilon.x*pixels[2].alpha+delta->x*
+    pixels[3].alpha));
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   I n t e r p o l a t e P i x e l I n f o                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  InterpolatePixelInfo() applies a pixel interpolation method between a
+%  floating point coordinate and the pixels surrounding that coordinate.  No
+%  pixel area resampling, or scaling of the result is performed.
+%
+%  Interpolation is restricted to just RGBKA channels.
+%
+%  The format of the InterpolatePixelInfo method is:
+%
+%      MagickBooleanType InterpolatePixelInfo(const Image *image,
+%        const CacheView *image_view,const PixelInterpolateMethod method,
+%        const double x,const double y,PixelInfo *pixel,
+%        ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image: the image.
+%
+%    o image_view: the image view.
+%
+%    o method: the pixel color interpolation method.
+%
+%    o x,y: A double representing the current (x,y) position of the pixel.
+%
+%    o pixel: return the interpolated pixel here.
+%
+%    o exception: return any errors or warnings in this structure.
+%
+*/
+
 MagickExport MagickBooleanType InterpolatePixelInfo(const Image *image,
   const CacheView_ *image_view,const PixelInterpolateMethod method,
   const double x,const double y,PixelInfo *pixel,ExceptionInfo *exception)
@@ -5536,8 +5612,7 @@ MagickExport MagickBooleanType InterpolatePixelInfo(const Image *image,
     default:
     {
       PointInfo
-        delta,
-        epsilon;
+        delta;
 
       p=GetCacheViewVirtualPixels(image_view,x_offset,y_offset,2,2,exception);
       if (p == (const Quantum *) NULL)
@@ -5545,33 +5620,10 @@ MagickExport MagickBooleanType InterpolatePixelInfo(const Image *image,
           status=MagickFalse;
           break;
         }
-      for (i=0; i < 4L; i++)
-        AlphaBlendPixelInfo(image,p+i*(ssize_t) GetPixelChannels(image),
-          pixels+i,alpha+i);
       delta.x=x-x_offset;
       delta.y=y-y_offset;
-      epsilon.x=1.0-delta.x;
-      epsilon.y=1.0-delta.y;
-      gamma=((epsilon.y*(epsilon.x*alpha[0]+delta.x*alpha[1])+delta.y*
-        (epsilon.x*alpha[2]+delta.x*alpha[3])));
-      gamma=PerceptibleReciprocal(gamma);
-      pixel->red=gamma*(epsilon.y*(epsilon.x*pixels[0].red+delta.x*
-        pixels[1].red)+delta.y*(epsilon.x*pixels[2].red+delta.x*pixels[3].red));
-      pixel->green=gamma*(epsilon.y*(epsilon.x*pixels[0].green+delta.x*
-        pixels[1].green)+delta.y*(epsilon.x*pixels[2].green+delta.x*
-        pixels[3].green));
-      pixel->blue=gamma*(epsilon.y*(epsilon.x*pixels[0].blue+delta.x*
-        pixels[1].blue)+delta.y*(epsilon.x*pixels[2].blue+delta.x*
-        pixels[3].blue));
-      if (image->colorspace == CMYKColorspace)
-        pixel->black=gamma*(epsilon.y*(epsilon.x*pixels[0].black+delta.x*
-          pixels[1].black)+delta.y*(epsilon.x*pixels[2].black+delta.x*
-          pixels[3].black));
-      gamma=((epsilon.y*(epsilon.x+delta.x)+delta.y*(epsilon.x+delta.x)));
-      gamma=PerceptibleReciprocal(gamma);
-      pixel->alpha=gamma*(epsilon.y*(epsilon.x*pixels[0].alpha+delta.x*
-        pixels[1].alpha)+delta.y*(epsilon.x*pixels[2].alpha+delta.x*
-        pixels[3].alpha));
+      InterpolateBilinearPixelInfo(image,p,2*(ssize_t) GetPixelChannels(image),
+        &delta,pixel);
       break;
     }
     case BlendInterpolatePixel:
@@ -59,6 +59,7 @@
 #include "MagickCore/stream-private.h"
 #include "MagickCore/string_.h"
 #include "MagickCore/string-private.h"
+#include "MagickCore/thread_.h"
 #include "MagickCore/token.h"
 #include "MagickCore/timer-private.h"
 #include "MagickCore/utility.h"
@@ -73,6 +74,8 @@
 /*
   Define declarations.
 */
+#define MaxPolicyMemo  32
+#define MaxPolicyMemoPattern  64
 #define PolicyFilename  "policy.xml"
 
 /*
@@ -106,6 +109,76 @@ struct _PolicyInfo
     signature;
 };
 
+typedef struct _PolicyMemoInfo
+{
+  size_t
+    generation,
+    hash;
+
+  PolicyDomain
+    domain;
+
+  PolicyRights
+    rights;
+
+  MagickBooleanType
+    authorized;
+
+  char
+    pattern[MaxPolicyMemoPattern];
+} PolicyMemoInfo;
+
+typedef struct _PolicyRuleInfo
+{
+  PolicyDomain
+    domain;
+
+  PolicyRights
+    rights;
+
+  const char
+    *pattern;
+
+  MagickBooleanType
+    literal;
+
+  size_t
+    hash;
+} PolicyRuleInfo;
+
+typedef struct _PolicySnapshotInfo
+{
+  size_t
+    generation,
+    reference_count;
+
+  PolicyRuleInfo
+    *rules;
+
+  size_t
+    number_rules;
+
+  ssize_t
+    *literals;
+
+  size_t
+    extent,
+    *globs,
+    glob_offsets[ModulePolicyDomain+2];
+
+  struct _PolicySnapshotInfo
+    *next;
+} PolicySnapshotInfo;
+
+typedef struct _PolicyThreadInfo
+{
+  PolicySnapshotInfo
+    *snapshot;
+
+  PolicyMemoInfo
+    memo[MaxPolicyMemo];
+} PolicyThreadInfo;
+
 typedef struct _PolicyMapInfo
 {
   const PolicyDomain
@@ -133,8 +206,21 @@ static const PolicyMapInfo
 static LinkedListInfo
   *policy_cache = (LinkedListInfo *) NULL;
 
+static MagickBooleanType
+  policy_memo_instantiated = MagickFalse;
+
+static MagickThreadKey
+  policy_memo_key;
+
+static PolicySnapshotInfo
+  *policy_snapshot = (PolicySnapshotInfo *) NULL,
+  *policy_snapshots = (PolicySnapshotInfo *) NULL;
+
 static SemaphoreInfo
   *policy_semaphore = (SemaphoreInfo *) NULL;
+
+static size_t
+  policy_generation = 0;
 
 /*
   Forward declarations.
@@ -143,6 +229,9 @@ static MagickBooleanType
   IsPolicyCacheInstantiated(ExceptionInfo *),
   LoadPolicyCache(LinkedListInfo *,const char *,const char *,const size_t,
     ExceptionInfo *);
+
+static void
+  ResetPolicySnapshot(void);
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -351,7 +440,12 @@ static PolicyInfo *GetPolicyInfo(const char *name,ExceptionInfo *exception)
   if (p == (ElementInfo *) NULL)
     policy=(PolicyInfo *) NULL;
   else
-    (void) SetHeadElementInLinkedList(policy_cache,p);
+    {
+      if ((policy->pattern != (char *) NULL) &&
+          (p != GetHeadElementInLinkedList(policy_cache)))
+        ResetPolicySnapshot();
+      (void) SetHeadElementInLinkedList(policy_cache,p);
+    }
   UnlockSemaphoreInfo(policy_semaphore);
   return(policy);
 }
@@ -637,59 +731,423 @@ static MagickBooleanType IsPolicyCacheInstantiated(ExceptionInfo *exception)
 %    o pattern: the coder, delegate, filter, or path pattern.
 %
 */
-MagickExport MagickBooleanType IsRightsAuthorized(const PolicyDomain domain,
-  const PolicyRights rights,const char *pattern)
+
+static inline size_t HashPolicyPattern(const PolicyDomain domain,
+  const char *pattern)
 {
-  const PolicyInfo
-    *policy_info;
+  const unsigned char
+    *p;
 
-  ExceptionInfo
-    *exception;
+  size_t
+    hash;
 
-  MagickBooleanType
-    authorized;
+  /*
+    FNV-1a hash of the pattern, seeded with the domain.
+  */
+  hash=(size_t) 2166136261U ^ (size_t) domain;
+  for (p=(const unsigned char *) pattern; *p != '\0'; p++)
+    hash=(hash ^ (size_t) *p)*(size_t) 16777619U;
+  return(hash);
+}
+
+static inline MagickBooleanType IsPolicyPatternLiteral(const char *pattern)
+{
+  const char
+    *p;
+
+  if ((pattern == (const char *) NULL) || (*pattern == '\0'))
+    return(MagickFalse);
+  for (p=pattern; *p != '\0'; p++)
+  {
+    if (((unsigned char) *p) >= 0x80)
+      return(MagickFalse);
+    switch (*p)
+    {
+      case '*':
+      case '?':
+      case '[':
+      case '{':
+      case '\\':
+        return(MagickFalse);
+      default:
+        break;
+    }
+  }
+  return(MagickTrue);
+}
 
+static PolicySnapshotInfo *AcquirePolicySnapshot(void)
+{
   ElementInfo
     *p;
 
-  if ((GetLogEventMask() & PolicyEvent) != 0)
-    (void) LogMagickEvent(PolicyEvent,GetMagickModule(),
-      "Domain: %s; rights=%s; pattern=\"%s\" ...",
-      CommandOptionToMnemonic(MagickPolicyDomainOptions,domain),
-      CommandOptionToMnemonic(MagickPolicyRightsOptions,rights),pattern);
-  exception=AcquireExceptionInfo();
-  policy_info=GetPolicyInfo("*",exception);
-  exception=DestroyExceptionInfo(exception);
-  if (policy_info == (PolicyInfo *) NULL)
-    return(MagickTrue);
-  authorized=MagickTrue;
-  LockSemaphoreInfo(policy_semaphore);
-  p=GetHeadElementInLinkedList(policy_cache);
-  while (p != (ElementInfo *) NULL)
+  PolicySnapshotInfo
+    *snapshot;
+
+  size_t
+    domain,
+    number_globs,
+    number_policies;
+
+  ssize_t
+    i;
+
+  /*
+    Compile the rights policies into literal and glob matchers.
+  */
+  snapshot=(PolicySnapshotInfo *) AcquireCriticalMemory(sizeof(*snapshot));
+  (void) memset(snapshot,0,sizeof(*snapshot));
+  snapshot->generation=(++policy_generation);
+  number_policies=GetNumberOfElementsInLinkedList(policy_cache);
+  snapshot->rules=(PolicyRuleInfo *) AcquireQuantumMemory(number_policies+1,
+    sizeof(*snapshot->rules));
+  snapshot->globs=(size_t *) AcquireQuantumMemory(number_policies+1,
+    sizeof(*snapshot->globs));
+  snapshot->extent=1;
+  while (snapshot->extent < (2*number_policies+2))
+    snapshot->extent<<=1;
+  snapshot->literals=(ssize_t *) AcquireQuantumMemory(snapshot->extent,
+    sizeof(*snapshot->literals));
+  if ((snapshot->rules == (PolicyRuleInfo *) NULL) ||
+      (snapshot->globs == (size_t *) NULL) ||
+      (snapshot->literals == (ssize_t *) NULL))
+    ThrowFatalException(ResourceLimitFatalError,"MemoryAllocationFailed");
+  for (i=0; i < (ssize_t) snapshot->extent; i++)
+    snapshot->literals[i]=(-1);
+  for (p=GetHeadElementInLinkedList(policy_cache); p != (ElementInfo *) NULL; )
   {
     const PolicyInfo
       *policy;
 
+    PolicyRuleInfo
+      *rule;
+
     policy=(const PolicyInfo *) p->value;
-    if ((policy->domain == domain) &&
-        (GlobExpression(pattern,policy->pattern,MagickFalse) != MagickFalse))
+    p=p->next;
+    if ((size_t) policy->domain > (size_t) ModulePolicyDomain)
+      continue;
+    rule=snapshot->rules+snapshot->number_rules;
+    rule->domain=policy->domain;
+    rule->rights=policy->rights;
+    rule->pattern=policy->pattern;
+    rule->literal=IsPolicyPatternLiteral(policy->pattern);
+    rule->hash=0;
+    if (rule->literal != MagickFalse)
       {
-        if ((rights & ReadPolicyRights) != 0)
-          authorized=(policy->rights & ReadPolicyRights) != 0 ? MagickTrue :
-            MagickFalse;
-        if ((rights & WritePolicyRights) != 0)
-          authorized=(policy->rights & WritePolicyRights) != 0 ? MagickTrue :
-            MagickFalse;
-        if ((rights & ExecutePolicyRights) != 0)
-          authorized=(policy->rights & ExecutePolicyRights) != 0 ? MagickTrue :
-            MagickFalse;
+        size_t
+          j;
+
+        /*
+          Later policies override earlier ones: keep the last occurrence.
+        */
+        rule->hash=HashPolicyPattern(rule->domain,rule->pattern);
+        j=rule->hash & (snapshot->extent-1);
+        while (snapshot->literals[j] >= 0)
+        {
+          const PolicyRuleInfo
+            *q;
+
+          q=snapshot->rules+snapshot->literals[j];
+          if ((q->hash == rule->hash) && (q->domain == rule->domain) &&
+              (strcmp(q->pattern,rule->pattern) == 0))
+            break;
+          j=(j+1) & (snapshot->extent-1);
+        }
+        snapshot->literals[j]=(ssize_t) snapshot->number_rules;
       }
-    p=p->next;
+    snapshot->number_rules++;
+  }
+  number_globs=0;
+  for (domain=0; domain <= (size_t) ModulePolicyDomain; domain++)
+  {
+    snapshot->glob_offsets[domain]=number_globs;
+    for (i=0; i < (ssize_t) snapshot->number_rules; i++)
+      if (((size_t) snapshot->rules[i].domain == domain) &&
+          (snapshot->rules[i].literal == MagickFalse))
+        snapshot->globs[number_globs++]=(size_t) i;
+  }
+  snapshot->glob_offsets[ModulePolicyDomain+1]=number_globs;
+  return(snapshot);
+}
+
+static PolicySnapshotInfo *DestroyPolicySnapshot(PolicySnapshotInfo *snapshot)
+{
+  snapshot->literals=(ssize_t *) RelinquishMagickMemory(snapshot->literals);
+  snapshot->globs=(size_t *) RelinquishMagickMemory(snapshot->globs);
+  snapshot->rules=(PolicyRuleInfo *) RelinquishMagickMemory(snapshot->rules);
+  snapshot=(PolicySnapshotInfo *) RelinquishMagickMemory(snapshot);
+  return(snapshot);
+}
+
+static void RelinquishPolicySnapshot(PolicySnapshotInfo *snapshot)
+{
+  PolicySnapshotInfo
+    **p;
+
+  /*
+    Drop a reference; the last one frees a superseded snapshot.  The caller
+    holds the policy semaphore.
+  */
+  snapshot->reference_count--;
+  if (snapshot->reference_count != 0)
+    return;
+  for (p=(&policy_snapshots); *p != (PolicySnapshotInfo *) NULL; )
+  {
+    if (*p == snapshot)
+      {
+        *p=snapshot->next;
+        break;
+      }
+    p=(&(*p)->next);
   }
+  snapshot=DestroyPolicySnapshot(snapshot);
+}
+
+static void ResetPolicySnapshot(void)
+{
+  PolicySnapshotInfo
+    *snapshot;
+
+  /*
+    Supersede the current snapshot; the caller holds the policy semaphore.
+  */
+  snapshot=policy_snapshot;
+  if (snapshot == (PolicySnapshotInfo *) NULL)
+    return;
+  policy_snapshot=(PolicySnapshotInfo *) NULL;
+  RelinquishPolicySnapshot(snapshot);
+}
+
+static void DestroyPolicyMemo(void *memo)
+{
+  PolicyThreadInfo
+    *thread_info;
+
+  thread_info=(PolicyThreadInfo *) memo;
+  if (thread_info->snapshot != (PolicySnapshotInfo *) NULL)
+    {
+      LockSemaphoreInfo(policy_semaphore);
+      RelinquishPolicySnapshot(thread_info->snapshot);
+      UnlockSemaphoreInfo(policy_semaphore);
+    }
+  thread_info=(PolicyThreadInfo *) RelinquishMagickMemory(thread_info);
+}
+
+static PolicyThreadInfo *GetPolicyThreadInfo(void)
+{
+  PolicyThreadInfo
+    *thread_info;
+
+  if (policy_memo_instantiated == MagickFalse)
+    return((PolicyThreadInfo *) NULL);
+  thread_info=(PolicyThreadInfo *) GetMagickThreadValue(policy_memo_key);
+  if (thread_info != (PolicyThreadInfo *) NULL)
+    return(thread_info);
+  thread_info=(PolicyThreadInfo *) AcquireMagickMemory(sizeof(*thread_info));
+  if (thread_info == (PolicyThreadInfo *) NULL)
+    return(thread_info);
+  (void) memset(thread_info,0,sizeof(*thread_info));
+  if (SetMagickThreadValue(policy_memo_key,thread_info) == MagickFalse)
+    thread_info=(PolicyThreadInfo *) RelinquishMagickMemory(thread_info);
+  return(thread_info);
+}
+
+static PolicySnapshotInfo *GetPolicySnapshot(PolicyThreadInfo *thread_info)
+{
+  PolicySnapshotInfo
+    *snapshot;
+
+  /*
+    A thread keeps a reference to the snapshot it last used, so while that
+    snapshot is current it is read without locking.  Otherwise take a
+    reference under the semaphore: the thread's, or one the caller returns
+    with ReleasePolicySnapshot().
+  */
+  snapshot=policy_snapshot;
+  if ((thread_info != (PolicyThreadInfo *) NULL) &&
+      (snapshot != (PolicySnapshotInfo *) NULL) &&
+      (snapshot == thread_info->snapshot))
+    return(snapshot);
+  LockSemaphoreInfo(policy_semaphore);
+  if (policy_snapshot == (PolicySnapshotInfo *) NULL)
+    {
+      snapshot=AcquirePolicySnapshot();
+      snapshot->reference_count=1;
+      snapshot->next=policy_snapshots;
+      policy_snapshots=snapshot;
+      policy_snapshot=snapshot;
+    }
+  snapshot=policy_snapshot;
+  snapshot->reference_count++;
+  if (thread_info != (PolicyThreadInfo *) NULL)
+    {
+      if (thread_info->snapshot != (PolicySnapshotInfo *) NULL)
+        RelinquishPolicySnapshot(thread_info->snapshot);
+      thread_info->snapshot=snapshot;
+    }
   UnlockSemaphoreInfo(policy_semaphore);
+  return(snapshot);
+}
+
+static void ReleasePolicySnapshot(PolicyThreadInfo *thread_info,
+  PolicySnapshotInfo *snapshot)
+{
+  if (thread_info != (PolicyThreadInfo *) NULL)
+    return;
+  LockSemaphoreInfo(policy_semaphore);
+  RelinquishPolicySnapshot(snapshot);
+  UnlockSemaphoreInfo(policy_semaphore);
+}
+
+static MagickBooleanType GetPolicyRights(const PolicyRights rights,
+  const PolicyRuleInfo *rule)
+{
+  MagickBooleanType
+    authorized;
+
+  authorized=MagickTrue;
+  if ((rights & ReadPolicyRights) != 0)
+    authorized=(rule->rights & ReadPolicyRights) != 0 ? MagickTrue :
+      MagickFalse;
+  if ((rights & WritePolicyRights) != 0)
+    authorized=(rule->rights & WritePolicyRights) != 0 ? MagickTrue :
+      MagickFalse;
+  if ((rights & ExecutePolicyRights) != 0)
+    authorized=(rule->rights & ExecutePolicyRights) != 0 ? MagickTrue :
+      MagickFalse;
   return(authorized);
 }
-
+
+static MagickBooleanType IsSnapshotAuthorized(
+  const PolicySnapshotInfo *snapshot,PolicyThreadInfo *thread_info,
+  const PolicyDomain domain,const PolicyRights rights,const char *pattern)
+{
+  MagickBooleanType
+    authorized;
+
+  PolicyMemoInfo
+    *memo;
+
+  size_t
+    hash;
+
+  ssize_t
+    i,
+    match;
+
+  if ((snapshot->number_rules == 0) ||
+      ((size_t) domain > (size_t) ModulePolicyDomain))
+    return(MagickTrue);
+  /*
+    Consult this thread's memo of recent decisions; it only pays off when
+    glob patterns must be evaluated.
+  */
+  memo=(PolicyMemoInfo *) NULL;
+  hash=0;
+  if (pattern != (const char *) NULL)
+    {
+      hash=HashPolicyPattern(domain,pattern);
+      if ((thread_info != (PolicyThreadInfo *) NULL) &&
+          (snapshot->glob_offsets[domain+1] > snapshot->glob_offsets[domain]) &&
+          (strlen(pattern) < MaxPolicyMemoPattern))
+        {
+          memo=thread_info->memo+((hash ^ (size_t) rights) % MaxPolicyMemo);
+          if ((memo->generation == snapshot->generation) &&
+              (memo->hash == hash) && (memo->domain == domain) &&
+              (memo->rights == rights) && (strcmp(memo->pattern,pattern) == 0))
+            return(memo->authorized);
+        }
+    }
+  /*
+    The last policy that matches the pattern decides: look up the literal
+    patterns, then scan the globs backwards for a later match.
+  */
+  match=(-1);
+  if (pattern != (const char *) NULL)
+    for (i=(ssize_t) (hash & (snapshot->extent-1)); ; )
+    {
+      const PolicyRuleInfo
+        *rule;
+
+      if (snapshot->literals[i] < 0)
+        break;
+      rule=snapshot->rules+snapshot->literals[i];
+      if ((rule->hash == hash) && (rule->domain == domain) &&
+          (strcmp(rule->pattern,pattern) == 0))
+        {
+          match=snapshot->literals[i];
+          break;
+        }
+      i=(ssize_t) (((size_t) i+1) & (snapshot->extent-1));
+    }
+  for (i=(ssize_t) snapshot->glob_offsets[domain+1]-1;
+       i >= (ssize_t) snapshot->glob_offsets[domain]; i--)
+  {
+    const PolicyRuleInfo
+      *rule;
+
+    if ((ssize_t) snapshot->globs[i] <= match)
+      break;
+    rule=snapshot->rules+snapshot->globs[i];
+    if (GlobExpression(pattern,rule->pattern,MagickFalse) != MagickFalse)
+      {
+        match=(ssize_t) snapshot->globs[i];
+        break;
+      }
+  }
+  authorized=MagickTrue;
+  if (match >= 0)
+    authorized=GetPolicyRights(rights,snapshot->rules+match);
+  if (memo != (PolicyMemoInfo *) NULL)
+    {
+      memo->generation=snapshot->generation;
+      memo->hash=hash;
+      memo->domain=domain;
+      memo->rights=rights;
+      memo->authorized=authorized;
+      (void) CopyMagickString(memo->pattern,pattern,MaxPolicyMemoPattern);
+    }
+  return(authorized);
+}
+
+MagickExport MagickBooleanType IsRightsAuthorized(const PolicyDomain domain,
+  const PolicyRights rights,const char *pattern)
+{
+  MagickBooleanType
+    authorized;
+
+  PolicySnapshotInfo
+    *snapshot;
+
+  PolicyThreadInfo
+    *thread_info;
+
+  if ((GetLogEventMask() & PolicyEvent) != 0)
+    (void) LogMagickEvent(PolicyEvent,GetMagickModule(),
+      "Domain: %s; rights=%s; pattern=\"%s\" ...",
+      CommandOptionToMnemonic(MagickPolicyDomainOptions,domain),
+      CommandOptionToMnemonic(MagickPolicyRightsOptions,rights),pattern);
+  if (policy_cache == (LinkedListInfo *) NULL)
+    {
+      ExceptionInfo
+        *exception;
+
+      MagickBooleanType
+        status;
+
+      exception=AcquireExceptionInfo();
+      status=IsPolicyCacheInstantiated(exception);
+      exception=DestroyExceptionInfo(exception);
+      if (status == MagickFalse)
+        return(MagickTrue);
+    }
+  thread_info=GetPolicyThreadInfo();
+  snapshot=GetPolicySnapshot(thread_info);
+  authorized=IsSnapshotAuthorized(snapshot,thread_info,domain,rights,pattern);
+  ReleasePolicySnapshot(thread_info,snapshot);
+  return(authorized);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1038,6 +1496,9 @@ MagickPrivate MagickBooleanType PolicyComponentGenesis(void)
 {
   if (policy_semaphore == (SemaphoreInfo *) NULL)
     policy_semaphore=AcquireSemaphoreInfo();
+  if (policy_memo_instantiated == MagickFalse)
+    policy_memo_instantiated=CreateMagickThreadKey(&policy_memo_key,
+      DestroyPolicyMemo);
   return(MagickTrue);
 }
 
@@ -1086,6 +1547,30 @@ MagickPrivate void PolicyComponentTerminus(void)
   if (policy_semaphore == (SemaphoreInfo *) NULL)
     ActivateSemaphoreInfo(&policy_semaphore);
   LockSemaphoreInfo(policy_semaphore);
+  if (policy_memo_instantiated != MagickFalse)
+    {
+      void
+        *memo;
+
+      /*
+        The snapshot this thread references is destroyed below.
+      */
+      memo=GetMagickThreadValue(policy_memo_key);
+      if (memo != (void *) NULL)
+        memo=RelinquishMagickMemory(memo);
+      (void) DeleteMagickThreadKey(policy_memo_key);
+      policy_memo_instantiated=MagickFalse;
+    }
+  policy_snapshot=(PolicySnapshotInfo *) NULL;
+  while (policy_snapshots != (PolicySnapshotInfo *) NULL)
+  {
+    PolicySnapshotInfo
+      *snapshot;
+
+    snapshot=policy_snapshots;
+    policy_snapshots=snapshot->next;
+    snapshot=DestroyPolicySnapshot(snapshot);
+  }
   if (policy_cache != (LinkedListInfo *) NULL)
     policy_cache=DestroyLinkedList(policy_cache,DestroyPolicyElement);
   UnlockSemaphoreInfo(policy_semaphore);
@@ -1167,6 +1652,9 @@ MagickExport MagickBooleanType SetMagickSecurityPolicy(const char *policy,
   if (ValidateSecurityPolicy(policy,PolicyFilename,exception) == MagickFalse)
     return(MagickFalse);
   status=LoadPolicyCache(policy_cache,policy,"[user-policy]",0,exception);
+  LockSemaphoreInfo(policy_semaphore);
+  ResetPolicySnapshot();
+  UnlockSemaphoreInfo(policy_semaphore);
   if (status == MagickFalse)
     return(status);
   /*
@@ -44,6 +44,7 @@
 #include "MagickCore/artifact.h"
 #include "MagickCore/color-private.h"
 #include "MagickCore/cache.h"
+#include "MagickCore/cache-private.h"
 #include "MagickCore/draw.h"
 #include "MagickCore/exception-private.h"
 #include "MagickCore/gem.h"
@@ -55,6 +56,7 @@
 #include "MagickCore/memory-private.h"
 #include "MagickCore/pixel.h"
 #include "MagickCore/pixel-accessor.h"
+#include "MagickCore/pixel-private.h"
 #include "MagickCore/quantum.h"
 #include "MagickCore/random_.h"
 #include "MagickCore/resample.h"
@@ -312,6 +314,90 @@ MagickExport ResampleFilter *DestroyResampleFilter(
 %    o exception: return any errors or warnings in this structure.
 %
 */
+static inline const Quantum *GetResamplePixels(const Image *image)
+{
+  const CacheInfo
+    *cache_info;
+
+  /*
+    The source pixels, read in place, when the image has an unmasked memory
+    based pixel cache that matches its geometry.  Looked up on every call so
+    a pixel cache replaced since the filter was acquired is never read.
+  */
+  if (((image->channels & WriteMaskChannel) != 0) ||
+      ((image->channels & CompositeMaskChannel) != 0))
+    return((const Quantum *) NULL);
+  cache_info=(const CacheInfo *) image->cache;
+  if (((cache_info->type != MemoryCache) && (cache_info->type != MapCache)) ||
+      (cache_info->columns != image->columns) ||
+      (cache_info->rows != image->rows) ||
+      (cache_info->number_channels != GetPixelChannels(image)))
+    return((const Quantum *) NULL);
+  return(cache_info->pixels);
+}
+
+static MagickBooleanType ResampleBilinearPixelInfo(
+  const ResampleFilter *resample_filter,const double x,const double y,
+  PixelInfo *pixel)
+{
+  const Image
+    *image;
+
+  const Quantum
+    *p;
+
+  PixelInterpolateMethod
+    interpolate;
+
+  PointInfo
+    delta;
+
+  ssize_t
+    x_offset,
+    y_offset;
+
+  /*
+    Bilinear interpolation of a 2x2 neighbourhood read in place from a memory
+    based pixel cache.
+  */
+  image=resample_filter->image;
+  interpolate=resample_filter->interpolate;
+  if (interpolate == UndefinedInterpolatePixel)
+    interpolate=image->interpolate;
+  if ((interpolate != UndefinedInterpolatePixel) &&
+      (interpolate != BilinearInterpolatePixel))
+    return(MagickFalse);
+  if ((IsNaN(x) != 0) || (IsNaN(y) != 0) || (x < 0.0) || (y < 0.0) ||
+      (x >= ((double) image->columns-1.0)) || (y >= ((double) image->rows-1.0)))
+    return(MagickFalse);
+  p=GetResamplePixels(image);
+  if (p == (const Quantum *) NULL)
+    return(MagickFalse);
+  x_offset=CastDoubleToLong(floor(x));
+  y_offset=CastDoubleToLong(floor(y));
+  p+=(ptrdiff_t) GetPixelChannels(image)*(y_offset*(ssize_t) image->columns+
+    x_offset);
+  GetPixelInfoPixel(image,(const Quantum *) NULL,pixel);
+  delta.x=x-x_offset;
+  delta.y=y-y_offset;
+  InterpolateBilinearPixelInfo(image,p,(ssize_t) (GetPixelChannels(image)*
+    image->columns),&delta,pixel);
+  return(MagickTrue);
+}
+
+static inline MagickBooleanType EWAQuotientInside(const double Q,
+  const double F)
+{
+#if FILTER_LUT
+  if (((int) Q >= 0) && ((int) Q < (int) F))
+    return(MagickTrue);
+#else
+  if ((Q >= 0.0) && (Q < F))
+    return(MagickTrue);
+#endif
+  return(MagickFalse);
+}
+
 MagickExport MagickBooleanType ResamplePixelColor(
   ResampleFilter *resample_filter,const double u0,const double v0,
   PixelInfo *pixel,ExceptionInfo *exception)
@@ -323,14 +409,20 @@ MagickExport MagickBooleanType ResamplePixelColor(
   double u1;
   double U,V,Q,DQ,DDQ;
   double divisor_c,divisor_m;
-  double weight;
-  const Quantum *pixels;
+  double weight,F;
+  double sum_alpha,sum_red,sum_green,sum_blue,sum_black;
+  ssize_t channels,red_offset,green_offset,blue_offset,alpha_offset,
+    black_offset;
+  const Image *image;
+  const Quantum *image_pixels,*pixels;
   assert(resample_filter != (ResampleFilter *) NULL);
   assert(resample_filter->signature == MagickCoreSignature);
 
   status=MagickTrue;
   /* GetPixelInfo(resample_filter->image,pixel); */
   if ( resample_filter->do_interpolate ) {
+    if (ResampleBilinearPixelInfo(resample_filter,u0,v0,pixel) != MagickFalse)
+      return(MagickTrue);
     status=InterpolatePixelInfo(resample_filter->image,resample_filter->view,
       resample_filter->interpolate,u0,v0,pixel,resample_filter->exception);
     return(status);
@@ -547,6 +639,28 @@ MagickExport MagickBooleanType ResamplePixelColor(
   if (pixel->alpha_trait != UndefinedPixelTrait)
     pixel->alpha = 0.0;
 
+  /*
+    Channel offsets of the image being resampled, so all channels of a
+    pixel are accumulated at once, in registers.
+  */
+  image=resample_filter->image;
+  channels=(ssize_t) GetPixelChannels(image);
+  image_pixels=GetResamplePixels(image);
+  red_offset=image->channel_map[RedPixelChannel].offset;
+  green_offset=image->channel_map[GreenPixelChannel].offset;
+  blue_offset=image->channel_map[BluePixelChannel].offset;
+  alpha_offset=(-1);
+  if (image->channel_map[AlphaPixelChannel].traits != UndefinedPixelTrait)
+    alpha_offset=image->channel_map[AlphaPixelChannel].offset;
+  black_offset=(-1);
+  if (image->channel_map[BlackPixelChannel].traits != UndefinedPixelTrait)
+    black_offset=image->channel_map[BlackPixelChannel].offset;
+  sum_alpha=pixel->alpha;
+  sum_red=pixel->red;
+  sum_green=pixel->green;
+  sum_blue=pixel->blue;
+  sum_black=pixel->black;
+
   /*
     Determine the parallelogram bounding box fitted to the ellipse
     centered at u0,v0.  This area is bounding by the lines...
@@ -570,11 +684,17 @@ MagickExport MagickBooleanType ResamplePixelColor(
     bound by a Parallelogram fitted to the ellipse.
   */
   DDQ = 2*resample_filter->A;
-  for( v=v1; v<=v2;  v++ ) {
-#if DEBUG_HIT_MISS
-    long uu = ceil(u1);   /* actual pixel location (for debug only) */
-    (void) FormatLocaleFile(stderr, "# scan line from pixel %ld, %ld\n", (long)uu, (long)v);
+#if FILTER_LUT
+  F = (double) WLUT_WIDTH;  /* the ellipse has been pre-scaled to the LUT */
+#else
+  F = resample_filter->F;   /* the ellipse has been pre-scaled to support^2 */
 #endif
+  for( v=v1; v<=v2;  v++ ) {
+    ssize_t
+      span_start,
+      span_stop,
+      x;
+
     u = (ssize_t)ceil(u1);        /* first pixel in scanline */
     u1 += resample_filter->slope; /* start of next scan line */
 
@@ -587,42 +707,96 @@ MagickExport MagickBooleanType ResamplePixelColor(
     Q = (resample_filter->A*U + resample_filter->B*V)*U + resample_filter->C*V*V;
     DQ = resample_filter->A*(2.0*U+1) + resample_filter->B*V;
 
-    /* get the scanline of pixels for this v */
-    pixels=GetCacheViewVirtualPixels(resample_filter->view,u,v,(size_t) uw,
-      1,resample_filter->exception);
+    /*
+      Find the span of the scanline that falls within the ellipse, so only
+      those pixels are read.  DQ never decreases, so once Q is past the
+      ellipse and rising no further pixel can hit.  Random virtual pixels
+      are always read across the full width to keep the same sequence.
+    */
+    span_start=0;
+    span_stop=uw;
+    if (resample_filter->virtual_pixel != RandomVirtualPixelMethod)
+      {
+        double
+          span_Q = Q,
+          span_DQ = DQ;
+
+        span_start=uw;
+        span_stop=0;
+        for (x=0; x < uw; x++)
+        {
+          if (EWAQuotientInside(span_Q,F) != MagickFalse)
+            {
+              if (span_start == uw)
+                {
+                  span_start=x;
+                  Q=span_Q;
+                  DQ=span_DQ;
+                }
+              span_stop=x+1;
+            }
+          else
+            if ((span_Q > 0.0) && (span_DQ >= 0.0))
+              break;
+          span_Q+=span_DQ;
+          span_DQ+=DDQ;
+        }
+        if (span_start >= span_stop)
+          continue;  /* scanline misses the ellipse */
+      }
+    u+=span_start;
+#if DEBUG_HIT_MISS
+    long uu = u;   /* actual pixel location (for debug only) */
+    (void) FormatLocaleFile(stderr, "# scan line from pixel %ld, %ld\n", (long)uu, (long)v);
+#endif
+
+    /* get the scanline of pixels for this v, in place if within the image */
+    if ((image_pixels != (const Quantum *) NULL) && (u >= 0) &&
+        ((u+span_stop-span_start) <= (ssize_t) image->columns) &&
+        (v >= 0) && (v < (ssize_t) image->rows))
+      pixels=image_pixels+channels*(v*(ssize_t) image->columns+u);
+    else
+      pixels=GetCacheViewVirtualPixels(resample_filter->view,u,v,(size_t)
+        (span_stop-span_start),1,resample_filter->exception);
     if (pixels == (const Quantum *) NULL)
-      return(MagickFalse);
+      {
+        pixel->alpha=sum_alpha;
+        pixel->red=sum_red;
+        pixel->green=sum_green;
+        pixel->blue=sum_blue;
+        if (pixel->colorspace == CMYKColorspace)
+          pixel->black=sum_black;
+        return(MagickFalse);
+      }
 
     /* count up the weighted pixel colors */
-    for( u=0; u<uw; u++ ) {
+    for( x=span_start; x<span_stop; x++ ) {
       weight = 0.0;
+      if (EWAQuotientInside(Q,F) != MagickFalse) {
+        double
+          alpha;
+
 #if FILTER_LUT
-      /* Note that the ellipse has been pre-scaled so F = WLUT_WIDTH */
-      if (((int) Q >= 0) && ((int) Q < WLUT_WIDTH)) {
         weight = resample_filter->filter_lut[(int) Q];
 #else
-      /* Note that the ellipse has been pre-scaled so F = support^2 */
-      if ((Q >= 0.0) && (Q < resample_filter->F)) {
         weight = GetResizeFilterWeight(resample_filter->filter_def,
              sqrt(Q));    /* a SquareRoot!  Arrggghhhhh... */
 #endif
 
-        pixel->alpha+=weight*(double)
-          GetPixelAlpha(resample_filter->image,pixels);
+        alpha=(double) OpaqueAlpha;
+        if (alpha_offset >= 0)
+          alpha=(double) pixels[alpha_offset];
+        sum_alpha+=weight*alpha;
         divisor_m += weight;
 
         if (pixel->alpha_trait != UndefinedPixelTrait)
-          weight*=QuantumScale*((double)
-            GetPixelAlpha(resample_filter->image,pixels));
-        pixel->red+=weight*(double)
-          GetPixelRed(resample_filter->image,pixels);
-        pixel->green+=weight*(double)
-          GetPixelGreen(resample_filter->image,pixels);
-        pixel->blue+=weight*(double)
-          GetPixelBlue(resample_filter->image,pixels);
+          weight*=QuantumScale*alpha;
+        sum_red+=weight*(double) pixels[red_offset];
+        sum_green+=weight*(double) pixels[green_offset];
+        sum_blue+=weight*(double) pixels[blue_offset];
         if (pixel->colorspace == CMYKColorspace)
-          pixel->black+=weight*(double)
-            GetPixelBlack(resample_filter->image,pixels);
+          sum_black+=weight*(black_offset < 0 ? 0.0 :
+            (double) pixels[black_offset]);
         divisor_c += weight;
 
         hit++;
@@ -642,11 +816,17 @@ MagickExport MagickBooleanType ResamplePixelColor(
 #else
       }
 #endif
-      pixels+=(ptrdiff_t) GetPixelChannels(resample_filter->image);
+      pixels+=(ptrdiff_t) channels;
       Q += DQ;
       DQ += DDQ;
     }
   }
+  pixel->alpha=sum_alpha;
+  pixel->red=sum_red;
+  pixel->green=sum_green;
+  pixel->blue=sum_blue;
+  if (pixel->colorspace == CMYKColorspace)
+    pixel->black=sum_black;
 #if DEBUG_ELLIPSE
   (void) FormatLocaleFile(stderr, "Hit=%ld;  Total=%ld;\n", (long)hit, (long)uw*(v2-v1) );
 #endif
@@ -64,6 +64,7 @@
 #include "MagickCore/image.h"
 #include "MagickCore/image-private.h"
 #include "MagickCore/matrix.h"
+#include "MagickCore/matrix-private.h"
 #include "MagickCore/memory_.h"
 #include "MagickCore/list.h"
 #include "MagickCore/monitor.h"
@@ -79,6 +80,7 @@
 #include "MagickCore/thread-private.h"
 #include "MagickCore/threshold.h"
 #include "MagickCore/transform.h"
+#include "MagickCore/transform-private.h"
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -216,12 +218,17 @@ static MagickBooleanType CropToFitImage(Image **image,
 static void RadonProjection(MatrixInfo *source_matrices,
   MatrixInfo *destination_matrices,const ssize_t sign,size_t *projection)
 {
+  const unsigned short
+    *magick_restrict elements;
+
   MatrixInfo
     *p,
     *q,
     *swap;
 
   size_t
+    columns,
+    rows,
     step;
 
   ssize_t
@@ -229,8 +236,76 @@ static void RadonProjection(MatrixInfo *source_matrices,
 
   p=source_matrices;
   q=destination_matrices;
-  for (step=1; step < GetMatrixColumns(p); step*=2)
+  columns=GetMatrixColumns(p);
+  rows=GetMatrixRows(p);
+  for (step=1; step < columns; step*=2)
   {
+    unsigned short
+      *magick_restrict projections;
+
+    elements=(const unsigned short *) GetMatrixElements(p);
+    projections=(unsigned short *) GetMatrixElements(q);
+    if ((elements != (const unsigned short *) NULL) &&
+        (projections != (unsigned short *) NULL))
+      {
+        ssize_t
+          y;
+
+        /*
+          The matrices are in memory: combine each pair of column groups a
+          row at a time, with the rows in parallel.
+        */
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+        #pragma omp parallel for schedule(static) \
+          num_threads(GetMagickResourceLimit(ThreadResource))
+#endif
+        for (y=0; y < (ssize_t) rows; y++)
+        {
+          const unsigned short
+            *magick_restrict r;
+
+          ssize_t
+            i,
+            j,
+            n;
+
+          unsigned short
+            *magick_restrict d;
+
+          r=elements+y*(ssize_t) columns;
+          d=projections+y*(ssize_t) columns;
+          n=(ssize_t) rows-y-1;
+          for (j=0; j < (ssize_t) columns; j+=2*(ssize_t) step)
+          {
+            const unsigned short
+              *magick_restrict neighbors;
+
+            neighbors=elements+y*(ssize_t) columns+j+(ssize_t) step;
+            for (i=0; i < MagickMin((ssize_t) step,n); i++)
+            {
+              d[j+2*i]=(unsigned short) (r[j+i]+neighbors[i*(ssize_t)
+                (columns+1)]);
+              d[j+2*i+1]=(unsigned short) (r[j+i]+neighbors[i*(ssize_t)
+                (columns+1)+(ssize_t) columns]);
+            }
+            if (n < (ssize_t) step)
+              {
+                d[j+2*n]=(unsigned short) (r[j+n]+neighbors[n*(ssize_t)
+                  (columns+1)]);
+                d[j+2*n+1]=r[j+n];
+              }
+            for (i=n+1; i < (ssize_t) step; i++)
+            {
+              d[j+2*i]=r[j+i];
+              d[j+2*i+1]=r[j+i];
+            }
+          }
+        }
+        swap=p;
+        p=q;
+        q=swap;
+        continue;
+      }
     for (x=0; x < (ssize_t) GetMatrixColumns(p); x+=2*(ssize_t) step)
     {
       ssize_t
@@ -285,6 +360,7 @@ static void RadonProjection(MatrixInfo *source_matrices,
     p=q;
     q=swap;
   }
+  elements=(const unsigned short *) GetMatrixElements(p);
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
   #pragma omp parallel for schedule(static) \
     num_threads(GetMagickResourceLimit(ThreadResource))
@@ -298,6 +374,24 @@ static void RadonProjection(MatrixInfo *source_matrices,
       y;
 
     sum=0;
+    if (elements != (const unsigned short *) NULL)
+      {
+        const unsigned short
+          *magick_restrict r;
+
+        r=elements+x;
+        for (y=0; y < (ssize_t) (rows-1); y++)
+        {
+          ssize_t
+            delta;
+
+          delta=(ssize_t) r[0]-(ssize_t) r[columns];
+          sum+=(size_t) (delta*delta);
+          r+=(ptrdiff_t) columns;
+        }
+        projection[(ssize_t) columns+sign*x-1]=sum;
+        continue;
+      }
     for (y=0; y < (ssize_t) (GetMatrixRows(p)-1); y++)
     {
       ssize_t
@@ -761,118 +855,11 @@ MagickExport Image *IntegralRotateImage(const Image *image,size_t rotations,
   {
     case 1:
     {
-      size_t
-        tile_height,
-        tile_width;
-
-      ssize_t
-        tile_y;
-
       /*
         Rotate 90 degrees.
       */
-      GetPixelCacheTileSize(image,&tile_width,&tile_height);
-      tile_width=image->columns;
-#if defined(MAGICKCORE_OPENMP_SUPPORT)
-      #pragma omp parallel for schedule(static) shared(status) \
-        magick_number_threads(image,rotate_image,image->rows/tile_height,2)
-#endif
-      for (tile_y=0; tile_y < (ssize_t) image->rows; tile_y+=(ssize_t) tile_height)
-      {
-        ssize_t
-          tile_x;
-
-        if (status == MagickFalse)
-          continue;
-        tile_x=0;
-        for ( ; tile_x < (ssize_t) image->columns; tile_x+=(ssize_t) tile_width)
-        {
-          const Quantum
-            *magick_restrict p;
-
-          MagickBooleanType
-            sync;
-
-          Quantum
-            *magick_restrict q;
-
-          size_t
-            height,
-            width;
-
-          ssize_t
-            y;
-
-          width=tile_width;
-          if ((tile_width+(size_t) tile_x) > image->columns)
-            width=(size_t) ((ssize_t) tile_width-(tile_x+(ssize_t) tile_width-
-              (ssize_t) image->columns));
-          height=tile_height;
-          if ((tile_height+(size_t) tile_y) > image->rows)
-            height=(size_t) ((ssize_t) tile_height-(tile_y+(ssize_t)
-              tile_height-(ssize_t) image->rows));
-          p=GetCacheViewVirtualPixels(image_view,tile_x,tile_y,width,height,
-            exception);
-          if (p == (const Quantum *) NULL)
-            {
-              status=MagickFalse;
-              break;
-            }
-          for (y=0; y < (ssize_t) width; y++)
-          {
-            const Quantum
-              *magick_restrict tile_pixels;
-
-            ssize_t
-              x;
-
-            if (status == MagickFalse)
-              continue;
-            q=QueueCacheViewAuthenticPixels(rotate_view,(ssize_t)
-              rotate_image->columns-(tile_y+(ssize_t) height),y+tile_x,height,
-              1,exception);
-            if (q == (Quantum *) NULL)
-              {
-                status=MagickFalse;
-                continue;
-              }
-            tile_pixels=p+(((ssize_t) height-1)*(ssize_t) width+y)*(ssize_t)
-              GetPixelChannels(image);
-            for (x=0; x < (ssize_t) height; x++)
-            {
-              ssize_t
-                i;
-
-              for (i=0; i < (ssize_t) GetPixelChannels(image); i++)
-              {
-                PixelChannel channel = GetPixelChannelChannel(image,i);
-                PixelTrait traits = GetPixelChannelTraits(image,channel);
-                PixelTrait rotate_traits = GetPixelChannelTraits(rotate_image,
-                  channel);
-                if ((traits == UndefinedPixelTrait) ||
-                    (rotate_traits == UndefinedPixelTrait))
-                  continue;
-                SetPixelChannel(rotate_image,channel,tile_pixels[i],q);
-              }
-              tile_pixels-=width*GetPixelChannels(image);
-              q+=(ptrdiff_t) GetPixelChannels(rotate_image);
-            }
-            sync=SyncCacheViewAuthenticPixels(rotate_view,exception);
-            if (sync == MagickFalse)
-              status=MagickFalse;
-          }
-        }
-        if (image->progress_monitor != (MagickProgressMonitor) NULL)
-          {
-            MagickBooleanType
-              proceed;
-
-            proceed=SetImageProgress(image,RotateImageTag,
-              progress+=(MagickOffsetType) tile_height,image->rows);
-            if (proceed == MagickFalse)
-              status=MagickFalse;
-          }
-      }
+      status=TransposeImagePixels(image,MagickFalse,MagickTrue,RotateImageTag,
+        rotate_image,exception);
       (void) SetImageProgress(image,RotateImageTag,(MagickOffsetType)
         image->rows-1,image->rows);
       Swap(page.width,page.height);
@@ -961,120 +948,11 @@ MagickExport Image *IntegralRotateImage(const Image *image,size_t rotations,
     }
     case 3:
     {
-      size_t
-        tile_height,
-        tile_width;
-
-      ssize_t
-        tile_y;
-
       /*
         Rotate 270 degrees.
       */
-      GetPixelCacheTileSize(image,&tile_width,&tile_height);
-      tile_width=image->columns;
-#if defined(MAGICKCORE_OPENMP_SUPPORT)
-      #pragma omp parallel for schedule(static) shared(status) \
-        magick_number_threads(image,rotate_image,image->rows/tile_height,2)
-#endif
-      for (tile_y=0; tile_y < (ssize_t) image->rows; tile_y+=(ssize_t) tile_height)
-      {
-        ssize_t
-          tile_x;
-
-        if (status == MagickFalse)
-          continue;
-        tile_x=0;
-        for ( ; tile_x < (ssize_t) image->columns; tile_x+=(ssize_t) tile_width)
-        {
-          MagickBooleanType
-            sync;
-
-          const Quantum
-            *magick_restrict p;
-
-          Quantum
-            *magick_restrict q;
-
-          size_t
-            height,
-            width;
-
-          ssize_t
-            y;
-
-          width=tile_width;
-          if ((tile_width+(size_t) tile_x) > image->columns)
-            width=(size_t) ((ssize_t) tile_width-(tile_x+(ssize_t) tile_width-
-              (ssize_t) image->columns));
-          height=tile_height;
-          if ((tile_height+(size_t) tile_y) > image->rows)
-            height=(size_t) ((ssize_t) tile_height-(tile_y+(ssize_t)
-              tile_height-(ssize_t) image->rows));
-          p=GetCacheViewVirtualPixels(image_view,tile_x,tile_y,width,height,
-            exception);
-          if (p == (const Quantum *) NULL)
-            {
-              status=MagickFalse;
-              break;
-            }
-          for (y=0; y < (ssize_t) width; y++)
-          {
-            const Quantum
-              *magick_restrict tile_pixels;
-
-            ssize_t
-              x;
-
-            if (status == MagickFalse)
-              continue;
-            q=QueueCacheViewAuthenticPixels(rotate_view,tile_y,y+(ssize_t)
-              rotate_image->rows-(tile_x+(ssize_t) width),height,1,exception);
-            if (q == (Quantum *) NULL)
-              {
-                status=MagickFalse;
-                continue;
-              }
-            tile_pixels=p+(((ssize_t) width-1)-y)*(ssize_t)
-              GetPixelChannels(image);
-            for (x=0; x < (ssize_t) height; x++)
-            {
-              ssize_t
-                i;
-
-              for (i=0; i < (ssize_t) GetPixelChannels(image); i++)
-              {
-                PixelChannel channel = GetPixelChannelChannel(image,i);
-                PixelTrait traits = GetPixelChannelTraits(image,channel);
-                PixelTrait rotate_traits = GetPixelChannelTraits(rotate_image,
-                  channel);
-                if ((traits == UndefinedPixelTrait) ||
-                    (rotate_traits == UndefinedPixelTrait))
-                  continue;
-                SetPixelChannel(rotate_image,channel,tile_pixels[i],q);
-              }
-              tile_pixels+=width*GetPixelChannels(image);
-              q+=(ptrdiff_t) GetPixelChannels(rotate_image);
-            }
-#if defined(MAGICKCORE_OPENMP_SUPPORT)
-            #pragma omp critical (MagickCore_IntegralRotateImage)
-#endif
-            sync=SyncCacheViewAuthenticPixels(rotate_view,exception);
-            if (sync == MagickFalse)
-              status=MagickFalse;
-          }
-        }
-        if (image->progress_monitor != (MagickProgressMonitor) NULL)
-          {
-            MagickBooleanType
-              proceed;
-
-            proceed=SetImageProgress(image,RotateImageTag,
-              progress+=(MagickOffsetType) tile_height,image->rows);
-            if (proceed == MagickFalse)
-              status=MagickFalse;
-          }
-      }
+      status=TransposeImagePixels(image,MagickTrue,MagickFalse,RotateImageTag,
+        rotate_image,exception);
       (void) SetImageProgress(image,RotateImageTag,(MagickOffsetType)
         image->rows-1,image->rows);
       Swap(page.width,page.height);
@@ -1131,18 +1009,129 @@ MagickExport Image *IntegralRotateImage(const Image *image,size_t rotations,
 %    o exception: return any errors or warnings in this structure.
 %
 */
+static void ShearPixels(const Image *image,const PixelInfo *background,
+  const double displacement,const ssize_t offset,const size_t length,
+  const size_t extent,const ssize_t stride,Quantum *magick_restrict pixels)
+{
+  double
+    area;
+
+  PixelInfo
+    destination,
+    *magick_restrict pixel,
+    *magick_restrict source,
+    shear_pixels[2];
+
+  Quantum
+    *magick_restrict p,
+    *magick_restrict q;
+
+  ssize_t
+    i,
+    step;
+
+  /*
+    Shear a row or a column of pixels, stride quanta apart, by the
+    displacement: each pixel is blended with its neighbor by the fractional
+    part of the displacement, working directly on the quanta.
+  */
+  if (displacement == 0.0)
+    return;
+  step=CastDoubleToLong(floor(fabs(displacement)));
+  area=(double) (fabs(displacement)-step);
+  step++;
+  GetPixelInfo(image,shear_pixels);
+  GetPixelInfo(image,shear_pixels+1);
+  GetPixelInfo(image,&destination);
+  pixel=shear_pixels;
+  source=shear_pixels+1;
+  pixel->red=background->red;
+  pixel->green=background->green;
+  pixel->blue=background->blue;
+  pixel->black=background->black;
+  pixel->alpha=background->alpha;
+  if (displacement < 0.0)
+    {
+      /*
+        Transfer pixels left-to-right.
+      */
+      if (step > offset)
+        return;
+      p=pixels+offset*stride;
+      q=p-step*stride;
+      for (i=0; i < (ssize_t) length; i++)
+      {
+        PixelInfo
+          *swap;
+
+        source->red=(MagickRealType) GetPixelRed(image,p);
+        source->green=(MagickRealType) GetPixelGreen(image,p);
+        source->blue=(MagickRealType) GetPixelBlue(image,p);
+        source->black=(MagickRealType) GetPixelBlack(image,p);
+        source->alpha=(MagickRealType) GetPixelAlpha(image,p);
+        CompositePixelInfoAreaBlend(pixel,(double) pixel->alpha,source,
+          (double) source->alpha,area,&destination);
+        SetPixelViaPixelInfo(image,&destination,q);
+        swap=pixel;
+        pixel=source;
+        source=swap;
+        p+=(ptrdiff_t) stride;
+        q+=(ptrdiff_t) stride;
+      }
+      CompositePixelInfoAreaBlend(pixel,(double) pixel->alpha,background,
+        (double) background->alpha,area,&destination);
+      SetPixelViaPixelInfo(image,&destination,q);
+      q+=(ptrdiff_t) stride;
+      for (i=0; i < (step-1); i++)
+      {
+        SetPixelViaPixelInfo(image,background,q);
+        q+=(ptrdiff_t) stride;
+      }
+      return;
+    }
+  /*
+    Transfer pixels right-to-left.
+  */
+  p=pixels+(offset+(ssize_t) length)*stride;
+  q=p+step*stride;
+  for (i=0; i < (ssize_t) length; i++)
+  {
+    PixelInfo
+      *swap;
+
+    p-=(ptrdiff_t) stride;
+    q-=(ptrdiff_t) stride;
+    if ((size_t) (offset+(ssize_t) length+step-i) > extent)
+      continue;
+    source->red=(MagickRealType) GetPixelRed(image,p);
+    source->green=(MagickRealType) GetPixelGreen(image,p);
+    source->blue=(MagickRealType) GetPixelBlue(image,p);
+    source->black=(MagickRealType) GetPixelBlack(image,p);
+    source->alpha=(MagickRealType) GetPixelAlpha(image,p);
+    CompositePixelInfoAreaBlend(pixel,(double) pixel->alpha,source,
+      (double) source->alpha,area,&destination);
+    SetPixelViaPixelInfo(image,&destination,q);
+    swap=pixel;
+    pixel=source;
+    source=swap;
+  }
+  CompositePixelInfoAreaBlend(pixel,(double) pixel->alpha,background,
+    (double) background->alpha,area,&destination);
+  q-=(ptrdiff_t) stride;
+  SetPixelViaPixelInfo(image,&destination,q);
+  for (i=0; i < (step-1); i++)
+  {
+    q-=(ptrdiff_t) stride;
+    SetPixelViaPixelInfo(image,background,q);
+  }
+}
+
 static MagickBooleanType XShearImage(Image *image,const double degrees,
   const size_t width,const size_t height,const ssize_t x_offset,
   const ssize_t y_offset,ExceptionInfo *exception)
 {
 #define XShearImageTag  "XShear/Image"
 
-  typedef enum
-  {
-    LEFT,
-    RIGHT
-  } ShearDirection;
-
   CacheView
     *image_view;
 
@@ -1176,27 +1165,16 @@ static MagickBooleanType XShearImage(Image *image,const double degrees,
   for (y=0; y < (ssize_t) height; y++)
   {
     double
-      area,
       displacement;
 
-    PixelInfo
-      pixel,
-      source,
-      destination;
-
     Quantum
-      *magick_restrict p,
-      *magick_restrict q;
-
-    ShearDirection
-      direction;
-
-    ssize_t
-      i,
-      step;
+      *magick_restrict p;
 
     if (status == MagickFalse)
       continue;
+    displacement=degrees*(double) (y-height/2.0);
+    if (displacement == 0.0)
+      continue;
     p=GetCacheViewAuthenticPixels(image_view,0,y_offset+y,image->columns,1,
       exception);
     if (p == (Quantum *) NULL)
@@ -1204,92 +1182,8 @@ static MagickBooleanType XShearImage(Image *image,const double degrees,
         status=MagickFalse;
         continue;
       }
-    p+=(ptrdiff_t) x_offset*(ssize_t) GetPixelChannels(image);
-    displacement=degrees*(double) (y-height/2.0);
-    if (displacement == 0.0)
-      continue;
-    if (displacement > 0.0)
-      direction=RIGHT;
-    else
-      {
-        displacement*=(-1.0);
-        direction=LEFT;
-      }
-    step=CastDoubleToLong(floor((double) displacement));
-    area=(double) (displacement-step);
-    step++;
-    pixel=background;
-    GetPixelInfo(image,&source);
-    GetPixelInfo(image,&destination);
-    switch (direction)
-    {
-      case LEFT:
-      {
-        /*
-          Transfer pixels left-to-right.
-        */
-        if (step > x_offset)
-          break;
-        q=p-step*(ssize_t) GetPixelChannels(image);
-        for (i=0; i < (ssize_t) width; i++)
-        {
-          if ((x_offset+i) < step)
-            {
-              p+=(ptrdiff_t) GetPixelChannels(image);
-              GetPixelInfoPixel(image,p,&pixel);
-              q+=(ptrdiff_t) GetPixelChannels(image);
-              continue;
-            }
-          GetPixelInfoPixel(image,p,&source);
-          CompositePixelInfoAreaBlend(&pixel,(double) pixel.alpha,
-            &source,(double) GetPixelAlpha(image,p),area,&destination);
-          SetPixelViaPixelInfo(image,&destination,q);
-          GetPixelInfoPixel(image,p,&pixel);
-          p+=(ptrdiff_t) GetPixelChannels(image);
-          q+=(ptrdiff_t) GetPixelChannels(image);
-        }
-        CompositePixelInfoAreaBlend(&pixel,(double) pixel.alpha,
-          &background,(double) background.alpha,area,&destination);
-        SetPixelViaPixelInfo(image,&destination,q);
-        q+=(ptrdiff_t) GetPixelChannels(image);
-        for (i=0; i < (step-1); i++)
-        {
-          SetPixelViaPixelInfo(image,&background,q);
-          q+=(ptrdiff_t) GetPixelChannels(image);
-        }
-        break;
-      }
-      case RIGHT:
-      {
-        /*
-          Transfer pixels right-to-left.
-        */
-        p+=(ptrdiff_t) width*GetPixelChannels(image);
-        q=p+step*(ssize_t) GetPixelChannels(image);
-        for (i=0; i < (ssize_t) width; i++)
-        {
-          p-=(ptrdiff_t)GetPixelChannels(image);
-          q-=GetPixelChannels(image);
-          if ((size_t) (x_offset+(ssize_t) width+step-i) > image->columns)
-            continue;
-          GetPixelInfoPixel(image,p,&source);
-          CompositePixelInfoAreaBlend(&pixel,(double) pixel.alpha,
-            &source,(double) GetPixelAlpha(image,p),area,&destination);
-          SetPixelViaPixelInfo(image,&destination,q);
-          GetPixelInfoPixel(image,p,&pixel);
-        }
-        CompositePixelInfoAreaBlend(&pixel,(double) pixel.alpha,
-          &background,(double) background.alpha,area,&destination);
-        q-=GetPixelChannels(image);
-        SetPixelViaPixelInfo(image,&destination,q);
-        for (i=0; i < (step-1); i++)
-        {
-          q-=GetPixelChannels(image);
-          SetPixelViaPixelInfo(image,&background,q);
-        }
-        break;
-      }
-    }
+    ShearPixels(image,&background,displacement,x_offset,width,image->columns,
+      (ssize_t) GetPixelChannels(image),p);
     if (SyncCacheViewAuthenticPixels(image_view,exception) == MagickFalse)
       status=MagickFalse;
     if (image->progress_monitor != (MagickProgressMonitor) NULL)
@@ -1351,12 +1245,7 @@ static MagickBooleanType YShearImage(Image *image,const double degrees,
   const ssize_t y_offset,ExceptionInfo *exception)
 {
 #define YShearImageTag  "YShear/Image"
-
-  typedef enum
-  {
-    UP,
-    DOWN
-  } ShearDirection;
+#define YShearTileWidth  32
 
   CacheView
     *image_view;
@@ -1371,7 +1260,7 @@ static MagickBooleanType YShearImage(Image *image,const double degrees,
     background;
 
   ssize_t
-    x;
+    tile_x;
 
   /*
     Y Shear image.
@@ -1384,129 +1273,39 @@ static MagickBooleanType YShearImage(Image *image,const double degrees,
   progress=0;
   background=image->background_color;
   image_view=AcquireAuthenticCacheView(image,exception);
+  /*
+    Columns are sheared a tile of adjacent columns at a time, so each column
+    is read from rows already in cache rather than one pixel per row.
+  */
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
   #pragma omp parallel for schedule(static) shared(progress,status) \
-    magick_number_threads(image,image,width,1)
+    magick_number_threads(image,image,width/YShearTileWidth,1)
 #endif
-  for (x=0; x < (ssize_t) width; x++)
+  for (tile_x=0; tile_x < (ssize_t) width; tile_x+=YShearTileWidth)
   {
-    double
-      area,
-      displacement;
-
-    PixelInfo
-      pixel,
-      source,
-      destination;
-
     Quantum
-      *magick_restrict p,
-      *magick_restrict q;
+      *magick_restrict p;
 
-    ShearDirection
-      direction;
+    size_t
+      columns;
 
     ssize_t
-      i,
-      step;
+      x;
 
     if (status == MagickFalse)
       continue;
-    p=GetCacheViewAuthenticPixels(image_view,x_offset+x,0,1,image->rows,
-      exception);
+    columns=MagickMin(width-(size_t) tile_x,YShearTileWidth);
+    p=GetCacheViewAuthenticPixels(image_view,x_offset+tile_x,0,columns,
+      image->rows,exception);
     if (p == (Quantum *) NULL)
       {
         status=MagickFalse;
         continue;
       }
-    p+=(ptrdiff_t) y_offset*(ssize_t) GetPixelChannels(image);
-    displacement=degrees*(double) (x-width/2.0);
-    if (displacement == 0.0)
-      continue;
-    if (displacement > 0.0)
-      direction=DOWN;
-    else
-      {
-        displacement*=(-1.0);
-        direction=UP;
-      }
-    step=CastDoubleToLong(floor((double) displacement));
-    area=(double) (displacement-step);
-    step++;
-    pixel=background;
-    GetPixelInfo(image,&source);
-    GetPixelInfo(image,&destination);
-    switch (direction)
-    {
-      case UP:
-      {
-        /*
-          Transfer pixels top-to-bottom.
-        */
-        if (step > y_offset)
-          break;
-        q=p-step*(ssize_t) GetPixelChannels(image);
-        for (i=0; i < (ssize_t) height; i++)
-        {
-          if ((y_offset+i) < step)
-            {
-              p+=(ptrdiff_t) GetPixelChannels(image);
-              GetPixelInfoPixel(image,p,&pixel);
-              q+=(ptrdiff_t) GetPixelChannels(image);
-              continue;
-            }
-          GetPixelInfoPixel(image,p,&source);
-          CompositePixelInfoAreaBlend(&pixel,(double) pixel.alpha,
-            &source,(double) GetPixelAlpha(image,p),area,
-            &destination);
-          SetPixelViaPixelInfo(image,&destination,q);
-          GetPixelInfoPixel(image,p,&pixel);
-          p+=(ptrdiff_t) GetPixelChannels(image);
-          q+=(ptrdiff_t) GetPixelChannels(image);
-        }
-        CompositePixelInfoAreaBlend(&pixel,(double) pixel.alpha,
-          &background,(double) background.alpha,area,&destination);
-        SetPixelViaPixelInfo(image,&destination,q);
-        q+=(ptrdiff_t) GetPixelChannels(image);
-        for (i=0; i < (step-1); i++)
-        {
-          SetPixelViaPixelInfo(image,&background,q);
-          q+=(ptrdiff_t) GetPixelChannels(image);
-        }
-        break;
-      }
-      case DOWN:
-      {
-        /*
-          Transfer pixels bottom-to-top.
-        */
-        p+=(ptrdiff_t) height*GetPixelChannels(image);
-        q=p+step*(ssize_t) GetPixelChannels(image);
-        for (i=0; i < (ssize_t) height; i++)
-        {
-          p-=(ptrdiff_t)GetPixelChannels(image);
-          q-=GetPixelChannels(image);
-          if ((size_t) (y_offset+(ssize_t) height+step-i) > image->rows)
-            continue;
-          GetPixelInfoPixel(image,p,&source);
-          CompositePixelInfoAreaBlend(&pixel,(double) pixel.alpha,
-            &source,(double) GetPixelAlpha(image,p),area,
-            &destination);
-          SetPixelViaPixelInfo(image,&destination,q);
-          GetPixelInfoPixel(image,p,&pixel);
-        }
-        CompositePixelInfoAreaBlend(&pixel,(double) pixel.alpha,
-          &background,(double) background.alpha,area,&destination);
-        q-=GetPixelChannels(image);
-        SetPixelViaPixelInfo(image,&destination,q);
-        for (i=0; i < (step-1); i++)
-        {
-          q-=GetPixelChannels(image);
-          SetPixelViaPixelInfo(image,&background,q);
-        }
-        break;
-      }
-    }
+    for (x=0; x < (ssize_t) columns; x++)
+      ShearPixels(image,&background,degrees*(double) (tile_x+x-width/2.0),
+        y_offset,height,image->rows,(ssize_t) (columns*
+        GetPixelChannels(image)),p+x*(ssize_t) GetPixelChannels(image));
     if (SyncCacheViewAuthenticPixels(image_view,exception) == MagickFalse)
       status=MagickFalse;
     if (image->progress_monitor != (MagickProgressMonitor) NULL)
@@ -1517,8 +1316,8 @@ static MagickBooleanType YShearImage(Image *image,const double degrees,
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
         #pragma omp atomic
 #endif
-        progress++;
-        proceed=SetImageProgress(image,YShearImageTag,progress,image->rows);
+        progress+=(MagickOffsetType) columns;
+        proceed=SetImageProgress(image,YShearImageTag,progress,width);
         if (proceed == MagickFalse)
           status=MagickFalse;
       }
@@ -928,6 +928,166 @@ MagickExport MagickBooleanType EvaluateImage(Image *image,
         MagickBooleanType
           proceed;
 
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+        #pragma omp atomic
+#endif
+        progress++;
+        proceed=SetImageProgress(image,EvaluateImageTag,progress,image->rows);
+        if (proceed == MagickFalse)
+          status=MagickFalse;
+      }
+  }
+  image_view=DestroyCacheView(image_view);
+  random_info=DestroyRandomInfoTLS(random_info);
+  return(status);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%     E v a l u a t e I m a g e O p e r a t o r s                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  EvaluateImageOperators() applies a sequence of arithmetic, relational, or
+%  logical operators to an image in a single pass over its pixels.  The result
+%  is the same as calling EvaluateImage() once for each operator in turn, but
+%  each pixel is read and written only once.
+%
+%  The format of the EvaluateImageOperators method is:
+%
+%      MagickBooleanType EvaluateImageOperators(Image *image,
+%        const size_t number_operators,const MagickEvaluateOperator *op,
+%        const double *values,ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image: the image.
+%
+%    o number_operators: the number of operators in the sequence.
+%
+%    o op: the channel operators, applied in order.
+%
+%    o values: the value for each operator.
+%
+%    o exception: return any errors or warnings in this structure.
+%
+*/
+MagickExport MagickBooleanType EvaluateImageOperators(Image *image,
+  const size_t number_operators,const MagickEvaluateOperator *op,
+  const double *values,ExceptionInfo *exception)
+{
+  CacheView
+    *image_view;
+
+  const char
+    *artifact;
+
+  MagickBooleanType
+    clamp,
+    status;
+
+  MagickOffsetType
+    progress;
+
+  RandomInfo
+    **magick_restrict random_info;
+
+  ssize_t
+    y;
+
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  unsigned long
+    key;
+#endif
+
+  assert(image != (Image *) NULL);
+  assert(image->signature == MagickCoreSignature);
+  assert(op != (const MagickEvaluateOperator *) NULL);
+  assert(values != (const double *) NULL);
+  assert(exception != (ExceptionInfo *) NULL);
+  assert(exception->signature == MagickCoreSignature);
+  if (IsEventLogging() != MagickFalse)
+    (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",image->filename);
+  if (number_operators == 0)
+    return(MagickTrue);
+  if (number_operators == 1)
+    return(EvaluateImage(image,op[0],values[0],exception));
+  if (SetImageStorageClass(image,DirectClass,exception) == MagickFalse)
+    return(MagickFalse);
+  status=MagickTrue;
+  progress=0;
+  clamp=MagickFalse;
+  artifact=GetImageArtifact(image,"evaluate:clamp");
+  if (artifact != (const char *) NULL)
+    clamp=IsStringTrue(artifact);
+  random_info=AcquireRandomInfoTLS();
+  image_view=AcquireAuthenticCacheView(image,exception);
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  key=GetRandomSecretKey(random_info[0]);
+  #pragma omp parallel for schedule(static) shared(progress,status) \
+    magick_number_threads(image,image,image->rows,key == ~0UL)
+#endif
+  for (y=0; y < (ssize_t) image->rows; y++)
+  {
+    const int
+      id = GetOpenMPThreadId();
+
+    Quantum
+      *magick_restrict q;
+
+    ssize_t
+      x;
+
+    if (status == MagickFalse)
+      continue;
+    q=GetCacheViewAuthenticPixels(image_view,0,y,image->columns,1,exception);
+    if (q == (Quantum *) NULL)
+      {
+        status=MagickFalse;
+        continue;
+      }
+    for (x=0; x < (ssize_t) image->columns; x++)
+    {
+      double
+        result;
+
+      ssize_t
+        i,
+        j;
+
+      for (i=0; i < (ssize_t) GetPixelChannels(image); i++)
+      {
+        PixelChannel channel = GetPixelChannelChannel(image,i);
+        PixelTrait traits = GetPixelChannelTraits(image,channel);
+        if (traits == UndefinedPixelTrait)
+          continue;
+        if ((traits & CopyPixelTrait) != 0)
+          continue;
+        if ((traits & UpdatePixelTrait) == 0)
+          continue;
+        for (j=0; j < (ssize_t) number_operators; j++)
+        {
+          result=ApplyEvaluateOperator(random_info[id],q[i],op[j],values[j]);
+          if (op[j] == MeanEvaluateOperator)
+            result/=2.0;
+          q[i]=clamp != MagickFalse ? ClampPixel(result) :
+            ClampToQuantum(result);
+        }
+      }
+      q+=(ptrdiff_t) GetPixelChannels(image);
+    }
+    if (SyncCacheViewAuthenticPixels(image_view,exception) == MagickFalse)
+      status=MagickFalse;
+    if (image->progress_monitor != (MagickProgressMonitor) NULL)
+      {
+        MagickBooleanType
+          proceed;
+
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
         #pragma omp atomic
 #endif
@@ -1854,6 +2014,9 @@ MagickExport MagickBooleanType GetImageRange(const Image *image,double *minima,
   CacheView
     *image_view;
 
+  double
+    range[2];
+
   MagickBooleanType
     status;
 
@@ -1864,6 +2027,13 @@ MagickExport MagickBooleanType GetImageRange(const Image *image,double *minima,
   assert(image->signature == MagickCoreSignature);
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",image->filename);
+  if (GetPixelCacheMemo(image,"statistic:range",range,sizeof(range)) !=
+      MagickFalse)
+    {
+      *minima=range[0];
+      *maxima=range[1];
+      return(MagickTrue);
+    }
   status=MagickTrue;
   *maxima=MagickMinimumValue;
   *minima=MagickMaximumValue;
@@ -1925,6 +2095,12 @@ MagickExport MagickBooleanType GetImageRange(const Image *image,double *minima,
     }
   }
   image_view=DestroyCacheView(image_view);
+  if (status != MagickFalse)
+    {
+      range[0]=(*minima);
+      range[1]=(*maxima);
+      (void) SetPixelCacheMemo(image,"statistic:range",range,sizeof(range));
+    }
   return(status);
 }
 
@@ -2040,6 +2216,9 @@ MagickExport ChannelStatistics *GetImageStatistics(const Image *image,
     area,
     channels;
 
+  MagickBooleanType
+    memoize;
+
   MagickStatusType
     status;
 
@@ -2063,10 +2242,14 @@ MagickExport ChannelStatistics *GetImageStatistics(const Image *image,
   assert(image->signature == MagickCoreSignature);
   if (IsEventLogging() != MagickFalse)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",image->filename);
-  histogram=(double *) AcquireQuantumMemory(MaxMap+1UL,
-    MagickMax(GetPixelChannels(image),1)*sizeof(*histogram));
   channel_statistics=(ChannelStatistics *) AcquireQuantumMemory(
     MaxPixelChannels+1,sizeof(*channel_statistics));
+  if ((channel_statistics != (ChannelStatistics *) NULL) &&
+      (GetPixelCacheMemo(image,"statistic:channels",channel_statistics,
+       (MaxPixelChannels+1)*sizeof(*channel_statistics)) != MagickFalse))
+    return(channel_statistics);
+  histogram=(double *) AcquireQuantumMemory(MaxMap+1UL,
+    MagickMax(GetPixelChannels(image),1)*sizeof(*histogram));
   if ((channel_statistics == (ChannelStatistics *) NULL) ||
       (histogram == (double *) NULL))
     {
@@ -2267,10 +2450,14 @@ MagickExport ChannelStatistics *GetImageStatistics(const Image *image,
     }
   }
   histogram=(double *) RelinquishMagickMemory(histogram);
+  memoize=MagickTrue;
   median_info=AcquireVirtualMemory(image->columns,image->rows*sizeof(*median));
   if (median_info == (MemoryInfo *) NULL)
-    (void) ThrowMagickException(exception,GetMagickModule(),
-      ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
+    {
+      (void) ThrowMagickException(exception,GetMagickModule(),
+        ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
+      memoize=MagickFalse;
+    }
   else
     {
       median=(Quantum *) GetVirtualMemoryBlob(median_info);
@@ -2377,6 +2564,10 @@ MagickExport ChannelStatistics *GetImageStatistics(const Image *image,
   if (y < (ssize_t) image->rows)
     channel_statistics=(ChannelStatistics *) RelinquishMagickMemory(
       channel_statistics);
+  else
+    if (memoize != MagickFalse)
+      (void) SetPixelCacheMemo(image,"statistic:channels",channel_statistics,
+        (MaxPixelChannels+1)*sizeof(*channel_statistics));
   return(channel_statistics);
 }
 
@@ -169,6 +169,8 @@ extern MagickExport Image
 extern MagickExport MagickBooleanType
   EvaluateImage(Image *,const MagickEvaluateOperator,const double,
     ExceptionInfo *),
+  EvaluateImageOperators(Image *,const size_t,const MagickEvaluateOperator *,
+    const double *,ExceptionInfo *),
   FunctionImage(Image *,const MagickFunction,const size_t,const double *,
     ExceptionInfo *),
   GetImageEntropy(const Image *,double *,ExceptionInfo *),
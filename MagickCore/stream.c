@@ -46,6 +46,7 @@
 #include "MagickCore/cache.h"
 #include "MagickCore/cache-private.h"
 #include "MagickCore/color-private.h"
+#include "MagickCore/colorspace-private.h"
 #include "MagickCore/composite-private.h"
 #include "MagickCore/constitute.h"
 #include "MagickCore/exception.h"
@@ -53,20 +54,82 @@
 #include "MagickCore/geometry.h"
 #include "MagickCore/memory_.h"
 #include "MagickCore/memory-private.h"
+#include "MagickCore/option.h"
 #include "MagickCore/pixel.h"
 #include "MagickCore/pixel-accessor.h"
 #include "MagickCore/pixel-private.h"
 #include "MagickCore/policy.h"
 #include "MagickCore/quantum.h"
 #include "MagickCore/quantum-private.h"
+#include "MagickCore/resize-private.h"
 #include "MagickCore/semaphore.h"
 #include "MagickCore/stream.h"
 #include "MagickCore/stream-private.h"
 #include "MagickCore/string_.h"
 
+/*
+  Define declarations.
+*/
+#define MaxStreamLevels  8
+
 /*
   Typedef declarations.
 */
+typedef struct _StreamLevelInfo
+{
+  double
+    black_point,
+    white_point,
+    gamma;
+} StreamLevelInfo;
+
+typedef struct _StreamContributionInfo
+{
+  ssize_t
+    start,
+    nearest;
+
+  size_t
+    number_weights;
+} StreamContributionInfo;
+
+typedef struct _StreamResizeInfo
+{
+  Image
+    *image;
+
+  ResizeFilter
+    *filter;
+
+  double
+    x_factor,
+    y_factor,
+    y_scale,
+    y_support;
+
+  StreamContributionInfo
+    *contributions;
+
+  double
+    *weights,
+    *y_weights;
+
+  size_t
+    span;
+
+  Quantum
+    *rows;
+
+  size_t
+    number_rows,
+    extent,
+    height;
+
+  ssize_t
+    y,
+    resize_y;
+} StreamResizeInfo;
+
 struct _StreamInfo
 {
   const ImageInfo
@@ -87,6 +150,21 @@ struct _StreamInfo
   StorageType
     storage_type;
 
+  ColorspaceType
+    colorspace;
+
+  StreamLevelInfo
+    levels[MaxStreamLevels];
+
+  size_t
+    number_levels;
+
+  char
+    *resize;
+
+  StreamResizeInfo
+    *resize_info;
+
   unsigned char
     *pixels;
 
@@ -271,6 +349,29 @@ static void DestroyPixelStream(Image *image)
 %    o stream_info: the stream info.
 %
 */
+
+static StreamResizeInfo *DestroyStreamResizeInfo(StreamResizeInfo *resize_info)
+{
+  assert(resize_info != (StreamResizeInfo *) NULL);
+  if (resize_info->rows != (Quantum *) NULL)
+    resize_info->rows=(Quantum *) RelinquishMagickMemory(resize_info->rows);
+  if (resize_info->y_weights != (double *) NULL)
+    resize_info->y_weights=(double *) RelinquishMagickMemory(
+      resize_info->y_weights);
+  if (resize_info->weights != (double *) NULL)
+    resize_info->weights=(double *) RelinquishMagickMemory(
+      resize_info->weights);
+  if (resize_info->contributions != (StreamContributionInfo *) NULL)
+    resize_info->contributions=(StreamContributionInfo *)
+      RelinquishMagickMemory(resize_info->contributions);
+  if (resize_info->filter != (ResizeFilter *) NULL)
+    resize_info->filter=DestroyResizeFilter(resize_info->filter);
+  if (resize_info->image != (Image *) NULL)
+    resize_info->image=DestroyImage(resize_info->image);
+  resize_info=(StreamResizeInfo *) RelinquishMagickMemory(resize_info);
+  return(resize_info);
+}
+
 MagickExport StreamInfo *DestroyStreamInfo(StreamInfo *stream_info)
 {
   assert(stream_info != (StreamInfo *) NULL);
@@ -279,6 +380,10 @@ MagickExport StreamInfo *DestroyStreamInfo(StreamInfo *stream_info)
     (void) LogMagickEvent(TraceEvent,GetMagickModule(),"...");
   if (stream_info->map != (char *) NULL)
     stream_info->map=DestroyString(stream_info->map);
+  if (stream_info->resize != (char *) NULL)
+    stream_info->resize=DestroyString(stream_info->resize);
+  if (stream_info->resize_info != (StreamResizeInfo *) NULL)
+    stream_info->resize_info=DestroyStreamResizeInfo(stream_info->resize_info);
   if (stream_info->pixels != (unsigned char *) NULL)
     stream_info->pixels=(unsigned char *) RelinquishAlignedMemory(
       stream_info->pixels);
@@ -1120,6 +1225,93 @@ MagickPrivate void SetStreamInfoClientData(StreamInfo *stream_info,
 %                                                                             %
 %                                                                             %
 %                                                                             %
+-   S e t S t r e a m I n f o C o l o r s p a c e                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  SetStreamInfoColorspace() sets the colorspace each streamed row is
+%  converted to before it is written.  Rows are converted from sRGB to gray or
+%  to any of the colorspaces TransformImageColorspace() converts pixel by
+%  pixel (e.g. Lab, HSL, YCbCr), so no pixel cache is needed.
+%
+%  The format of the SetStreamInfoColorspace method is:
+%
+%      void SetStreamInfoColorspace(StreamInfo *stream_info,
+%        const ColorspaceType colorspace)
+%
+%  A description of each parameter follows:
+%
+%    o stream_info: the stream info.
+%
+%    o colorspace: the colorspace.
+%
+*/
+MagickExport void SetStreamInfoColorspace(StreamInfo *stream_info,
+  const ColorspaceType colorspace)
+{
+  assert(stream_info != (StreamInfo *) NULL);
+  assert(stream_info->signature == MagickCoreSignature);
+  stream_info->colorspace=colorspace;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+-   S e t S t r e a m I n f o L e v e l                                       %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  SetStreamInfoLevel() appends a level adjustment, as LevelImage() applies
+%  it, to the point operations performed on each streamed row.  Gamma
+%  correction is a level of 0 to QuantumRange and a negation is a level of
+%  QuantumRange to 0.  Up to eight levels are applied in the order given,
+%  after any colorspace conversion.
+%
+%  The format of the SetStreamInfoLevel method is:
+%
+%      MagickBooleanType SetStreamInfoLevel(StreamInfo *stream_info,
+%        const double black_point,const double white_point,const double gamma)
+%
+%  A description of each parameter follows:
+%
+%    o stream_info: the stream info.
+%
+%    o black_point: the level which is to be mapped to zero (black)
+%
+%    o white_point: the level which is to be mapped to QuantumRange (white)
+%
+%    o gamma: adjust gamma by this factor before mapping values.
+%
+*/
+MagickExport MagickBooleanType SetStreamInfoLevel(StreamInfo *stream_info,
+  const double black_point,const double white_point,const double gamma)
+{
+  StreamLevelInfo
+    *level;
+
+  assert(stream_info != (StreamInfo *) NULL);
+  assert(stream_info->signature == MagickCoreSignature);
+  if (stream_info->number_levels >= MaxStreamLevels)
+    return(MagickFalse);
+  level=stream_info->levels+stream_info->number_levels;
+  level->black_point=black_point;
+  level->white_point=white_point;
+  level->gamma=gamma;
+  stream_info->number_levels++;
+  return(MagickTrue);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
 +   S e t S t r e a m I n f o M a p                                           %
 %                                                                             %
 %                                                                             %
@@ -1146,6 +1338,45 @@ MagickExport void SetStreamInfoMap(StreamInfo *stream_info,const char *map)
   (void) CloneString(&stream_info->map,map);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+-   S e t S t r e a m I n f o R e s i z e                                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  SetStreamInfoResize() sets the geometry streamed rows are resized to, as
+%  ResizeImage() would resize the image.  Each row is filtered horizontally
+%  as it arrives and kept in a ring of rows as tall as the vertical filter,
+%  so memory does not depend on the image height.  Any colorspace conversion
+%  and levels are applied to the resized rows.
+%
+%  The format of the SetStreamInfoResize method is:
+%
+%      void SetStreamInfoResize(StreamInfo *stream_info,const char *geometry)
+%
+%  A description of each parameter follows:
+%
+%    o stream_info: the stream info.
+%
+%    o geometry: the resize geometry, e.g. 50% or 1024x1024.
+%
+*/
+MagickExport void SetStreamInfoResize(StreamInfo *stream_info,
+  const char *geometry)
+{
+  assert(stream_info != (StreamInfo *) NULL);
+  assert(stream_info->signature == MagickCoreSignature);
+  if (stream_info->resize != (char *) NULL)
+    stream_info->resize=DestroyString(stream_info->resize);
+  if (geometry != (const char *) NULL)
+    stream_info->resize=ConstantString(geometry);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1212,27 +1443,570 @@ MagickExport void SetStreamInfoStorageType(StreamInfo *stream_info,
 extern "C" {
 #endif
 
+static inline double LevelStreamPixel(const StreamLevelInfo *level,
+  const double pixel)
+{
+  double
+    level_pixel,
+    scale;
+
+  scale=PerceptibleReciprocal(level->white_point-level->black_point);
+  level_pixel=scale*(pixel-level->black_point);
+  if (level_pixel >= 0.0)
+    level_pixel=pow(level_pixel,PerceptibleReciprocal(level->gamma));
+  return((double) QuantumRange*level_pixel);
+}
+
+static void TransformStreamPixels(const StreamInfo *stream_info,
+  const Image *image)
+{
+  const char
+    *artifact;
+
+  ColorspaceType
+    colorspace;
+
+  IlluminantType
+    illuminant = D65Illuminant;
+
+  Quantum
+    *q;
+
+  ssize_t
+    x;
+
+  /*
+    Apply the colorspace conversion and levels to the row in place.
+  */
+  colorspace=stream_info->colorspace;
+  if ((colorspace == image->colorspace) ||
+      (IssRGBCompatibleColorspace(image->colorspace) == MagickFalse))
+    colorspace=UndefinedColorspace;
+  switch (colorspace)
+  {
+    case CMYKColorspace:
+    case LogColorspace:
+    case RGBColorspace:
+    case scRGBColorspace:
+    case sRGBColorspace:
+    case TransparentColorspace:
+    {
+      colorspace=UndefinedColorspace;
+      break;
+    }
+    default:
+      break;
+  }
+  if ((colorspace == UndefinedColorspace) && (stream_info->number_levels == 0))
+    return;
+  q=GetAuthenticPixelQueue(image);
+  if (q == (Quantum *) NULL)
+    return;
+  artifact=GetImageArtifact(image,"color:illuminant");
+  if (artifact != (const char *) NULL)
+    {
+      ssize_t
+        illuminant_type;
+
+      illuminant_type=ParseCommandOption(MagickIlluminantOptions,MagickFalse,
+        artifact);
+      if (illuminant_type < 0)
+        illuminant=UndefinedIlluminant;
+      else
+        illuminant=(IlluminantType) illuminant_type;
+    }
+  for (x=0; x < (ssize_t) image->columns; x++)
+  {
+    ssize_t
+      i,
+      j;
+
+    switch (colorspace)
+    {
+      case UndefinedColorspace:
+        break;
+      case GRAYColorspace:
+      case LinearGRAYColorspace:
+      {
+        MagickRealType
+          gray;
+
+        if (colorspace == GRAYColorspace)
+          gray=0.212656*(double) GetPixelRed(image,q)+0.715158*(double)
+            GetPixelGreen(image,q)+0.072186*(double) GetPixelBlue(image,q);
+        else
+          gray=0.212656*DecodePixelGamma(GetPixelRed(image,q))+0.715158*
+            DecodePixelGamma(GetPixelGreen(image,q))+0.072186*
+            DecodePixelGamma(GetPixelBlue(image,q));
+        SetPixelRed(image,ClampToQuantum(gray),q);
+        SetPixelGreen(image,ClampToQuantum(gray),q);
+        SetPixelBlue(image,ClampToQuantum(gray),q);
+        break;
+      }
+      default:
+      {
+        double
+          X,
+          Y,
+          Z;
+
+        ConvertRGBToGeneric(colorspace,(double) GetPixelRed(image,q),
+          (double) GetPixelGreen(image,q),(double) GetPixelBlue(image,q),
+          10000.0,illuminant,&X,&Y,&Z);
+        SetPixelRed(image,ClampToQuantum((double) QuantumRange*X),q);
+        SetPixelGreen(image,ClampToQuantum((double) QuantumRange*Y),q);
+        SetPixelBlue(image,ClampToQuantum((double) QuantumRange*Z),q);
+        break;
+      }
+    }
+    for (i=0; i < (ssize_t) GetPixelChannels(image); i++)
+    {
+      PixelChannel channel = GetPixelChannelChannel(image,i);
+      PixelTrait traits = GetPixelChannelTraits(image,channel);
+      if ((traits & UpdatePixelTrait) == 0)
+        continue;
+      for (j=0; j < (ssize_t) stream_info->number_levels; j++)
+        q[i]=ClampToQuantum(LevelStreamPixel(stream_info->levels+j,(double)
+          q[i]));
+    }
+    q+=(ptrdiff_t) GetPixelChannels(image);
+  }
+}
+
+static MagickBooleanType AcquireStreamResize(StreamInfo *stream_info,
+  const Image *image,ExceptionInfo *exception)
+{
+  double
+    scale,
+    support;
+
+  FilterType
+    filter_type;
+
+  RectangleInfo
+    geometry;
+
+  StreamResizeInfo
+    *resize_info;
+
+  ssize_t
+    x;
+
+  /*
+    Compute the horizontal filter contributions once per image, and allocate
+    a ring of rows as tall as the vertical filter support.
+  */
+  if (stream_info->resize_info != (StreamResizeInfo *) NULL)
+    stream_info->resize_info=DestroyStreamResizeInfo(stream_info->resize_info);
+  SetGeometry(image,&geometry);
+  (void) ParseRegionGeometry(image,stream_info->resize,&geometry,exception);
+  if ((geometry.width == 0) || (geometry.height == 0))
+    {
+      (void) ThrowMagickException(exception,GetMagickModule(),ImageError,
+        "NegativeOrZeroImageSize","`%s'",image->filename);
+      return(MagickFalse);
+    }
+  if ((geometry.width == image->columns) && (geometry.height == image->rows) &&
+      (image->filter == UndefinedFilter))
+    return(MagickTrue);
+  resize_info=(StreamResizeInfo *) AcquireCriticalMemory(sizeof(*resize_info));
+  (void) memset(resize_info,0,sizeof(*resize_info));
+  stream_info->resize_info=resize_info;
+  resize_info->height=geometry.height;
+  resize_info->x_factor=(double) (geometry.width*PerceptibleReciprocal((double)
+    image->columns));
+  resize_info->y_factor=(double) (geometry.height*PerceptibleReciprocal(
+    (double) image->rows));
+  filter_type=LanczosFilter;
+  if (image->filter != UndefinedFilter)
+    filter_type=image->filter;
+  else
+    if ((resize_info->x_factor == 1.0) && (resize_info->y_factor == 1.0))
+      filter_type=PointFilter;
+    else
+      if ((image->storage_class == PseudoClass) ||
+          (image->alpha_trait != UndefinedPixelTrait) ||
+          ((resize_info->x_factor*resize_info->y_factor) > 1.0))
+        filter_type=MitchellFilter;
+  resize_info->filter=AcquireResizeFilter(image,filter_type,MagickFalse,
+    exception);
+  resize_info->image=AcquireImage((ImageInfo *) NULL,exception);
+  resize_info->image->colorspace=image->colorspace;
+  resize_info->image->alpha_trait=image->alpha_trait;
+  resize_info->image->depth=image->depth;
+  if ((resize_info->filter == (ResizeFilter *) NULL) ||
+      (SetImageExtent(resize_info->image,geometry.width,1,exception) ==
+       MagickFalse))
+    return(MagickFalse);
+  /*
+    Horizontal contributions, as HorizontalFilter() computes them.
+  */
+  scale=MagickMax(1.0/resize_info->x_factor+MagickEpsilon,1.0);
+  support=scale*GetResizeFilterSupport(resize_info->filter);
+  if (support < 0.5)
+    {
+      support=(double) 0.5;
+      scale=1.0;
+    }
+  scale=PerceptibleReciprocal(scale);
+  resize_info->span=(size_t) (2.0*support+3.0);
+  resize_info->contributions=(StreamContributionInfo *) AcquireQuantumMemory(
+    geometry.width,sizeof(*resize_info->contributions));
+  resize_info->weights=(double *) AcquireQuantumMemory(geometry.width,
+    resize_info->span*sizeof(*resize_info->weights));
+  if ((resize_info->contributions == (StreamContributionInfo *) NULL) ||
+      (resize_info->weights == (double *) NULL))
+    {
+      (void) ThrowMagickException(exception,GetMagickModule(),
+        ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
+      return(MagickFalse);
+    }
+  for (x=0; x < (ssize_t) geometry.width; x++)
+  {
+    double
+      bisect,
+      density,
+      *weights;
+
+    ssize_t
+      n,
+      start,
+      stop;
+
+    bisect=(double) (x+0.5)/resize_info->x_factor+MagickEpsilon;
+    start=(ssize_t) MagickMax(bisect-support+0.5,0.0);
+    stop=(ssize_t) MagickMin(bisect+support+0.5,(double) image->columns);
+    weights=resize_info->weights+x*(ssize_t) resize_info->span;
+    density=0.0;
+    for (n=0; n < (stop-start); n++)
+    {
+      weights[n]=GetResizeFilterWeight(resize_info->filter,scale*
+        ((double) (start+n)-bisect+0.5));
+      density+=weights[n];
+    }
+    if ((n != 0) && (density != 0.0) && (density != 1.0))
+      {
+        ssize_t
+          i;
+
+        /*
+          Normalize.
+        */
+        density=PerceptibleReciprocal(density);
+        for (i=0; i < n; i++)
+          weights[i]*=density;
+      }
+    resize_info->contributions[x].start=start;
+    resize_info->contributions[x].nearest=(ssize_t) (MagickMin(MagickMax(
+      bisect,(double) start),(double) stop-1.0)+0.5)-start;
+    resize_info->contributions[x].number_weights=(size_t) MagickMax(n,0);
+  }
+  /*
+    Vertical support, as VerticalFilter() computes it.
+  */
+  scale=MagickMax(1.0/resize_info->y_factor+MagickEpsilon,1.0);
+  support=scale*GetResizeFilterSupport(resize_info->filter);
+  if (support < 0.5)
+    {
+      support=(double) 0.5;
+      scale=1.0;
+    }
+  resize_info->y_scale=PerceptibleReciprocal(scale);
+  resize_info->y_support=support;
+  resize_info->number_rows=(size_t) (2.0*support+3.0);
+  resize_info->extent=geometry.width*GetPixelChannels(image);
+  resize_info->rows=(Quantum *) AcquireQuantumMemory(resize_info->number_rows,
+    resize_info->extent*sizeof(*resize_info->rows));
+  resize_info->y_weights=(double *) AcquireQuantumMemory(
+    resize_info->number_rows,sizeof(*resize_info->y_weights));
+  if ((resize_info->rows == (Quantum *) NULL) ||
+      (resize_info->y_weights == (double *) NULL))
+    {
+      (void) ThrowMagickException(exception,GetMagickModule(),
+        ResourceLimitError,"MemoryAllocationFailed","`%s'",image->filename);
+      return(MagickFalse);
+    }
+  (void) memset(resize_info->rows,0,resize_info->number_rows*
+    resize_info->extent*sizeof(*resize_info->rows));
+  return(MagickTrue);
+}
+
+static void ResizeStreamRowHorizontally(StreamResizeInfo *resize_info,
+  const Image *image,const Quantum *p)
+{
+  Quantum
+    *q;
+
+  ssize_t
+    x;
+
+  /*
+    Filter a source row horizontally into the ring.
+  */
+  q=resize_info->rows+(resize_info->y % (ssize_t) resize_info->number_rows)*
+    (ssize_t) resize_info->extent;
+  for (x=0; x < (ssize_t) resize_info->image->columns; x++)
+  {
+    const double
+      *weights;
+
+    const Quantum
+      *r;
+
+    ssize_t
+      i,
+      n;
+
+    n=(ssize_t) resize_info->contributions[x].number_weights;
+    if (n == 0)
+      {
+        q+=(ptrdiff_t) GetPixelChannels(image);
+        continue;
+      }
+    weights=resize_info->weights+x*(ssize_t) resize_info->span;
+    r=p+resize_info->contributions[x].start*(ssize_t) GetPixelChannels(image);
+    for (i=0; i < (ssize_t) GetPixelChannels(image); i++)
+    {
+      double
+        alpha,
+        gamma,
+        pixel;
+
+      PixelChannel
+        channel;
+
+      PixelTrait
+        resize_traits,
+        traits;
+
+      ssize_t
+        j;
+
+      channel=GetPixelChannelChannel(image,i);
+      traits=GetPixelChannelTraits(image,channel);
+      resize_traits=GetPixelChannelTraits(resize_info->image,channel);
+      if ((traits == UndefinedPixelTrait) ||
+          (resize_traits == UndefinedPixelTrait))
+        continue;
+      if ((resize_traits & CopyPixelTrait) != 0)
+        {
+          q[i]=r[resize_info->contributions[x].nearest*(ssize_t)
+            GetPixelChannels(image)+i];
+          continue;
+        }
+      pixel=0.0;
+      if ((resize_traits & BlendPixelTrait) == 0)
+        {
+          for (j=0; j < n; j++)
+            pixel+=weights[j]*(double) r[j*(ssize_t) GetPixelChannels(image)+
+              i];
+          q[i]=ClampToQuantum(pixel);
+          continue;
+        }
+      gamma=0.0;
+      for (j=0; j < n; j++)
+      {
+        alpha=weights[j]*QuantumScale*(double) GetPixelAlpha(image,r+j*
+          (ssize_t) GetPixelChannels(image));
+        pixel+=alpha*(double) r[j*(ssize_t) GetPixelChannels(image)+i];
+        gamma+=alpha;
+      }
+      gamma=PerceptibleReciprocal(gamma);
+      q[i]=ClampToQuantum(gamma*pixel);
+    }
+    q+=(ptrdiff_t) GetPixelChannels(image);
+  }
+  resize_info->y++;
+}
+
+static MagickBooleanType ResizeStreamRowVertically(
+  StreamResizeInfo *resize_info,const Image *image,ExceptionInfo *exception)
+{
+  double
+    bisect,
+    density,
+    *weights;
+
+  Quantum
+    *q;
+
+  ssize_t
+    n,
+    nearest,
+    start,
+    stop,
+    x;
+
+  /*
+    Filter the next resized row vertically from the ring, once all the source
+    rows it needs have arrived.
+  */
+  if (resize_info->resize_y >= (ssize_t) resize_info->height)
+    return(MagickFalse);
+  bisect=(double) (resize_info->resize_y+0.5)/resize_info->y_factor+
+    MagickEpsilon;
+  start=(ssize_t) MagickMax(bisect-resize_info->y_support+0.5,0.0);
+  stop=(ssize_t) MagickMin(bisect+resize_info->y_support+0.5,(double)
+    image->rows);
+  if ((stop > resize_info->y) || (stop <= start))
+    return(MagickFalse);
+  weights=resize_info->y_weights;
+  density=0.0;
+  for (n=0; n < (stop-start); n++)
+  {
+    weights[n]=GetResizeFilterWeight(resize_info->filter,resize_info->y_scale*
+      ((double) (start+n)-bisect+0.5));
+    density+=weights[n];
+  }
+  if ((density != 0.0) && (density != 1.0))
+    {
+      ssize_t
+        i;
+
+      /*
+        Normalize.
+      */
+      density=PerceptibleReciprocal(density);
+      for (i=0; i < n; i++)
+        weights[i]*=density;
+    }
+  nearest=(ssize_t) (MagickMin(MagickMax(bisect,(double) start),(double)
+    stop-1.0)+0.5);
+  q=QueueAuthenticPixels(resize_info->image,0,0,resize_info->image->columns,1,
+    exception);
+  if (q == (Quantum *) NULL)
+    return(MagickFalse);
+  for (x=0; x < (ssize_t) resize_info->image->columns; x++)
+  {
+    ssize_t
+      i;
+
+    for (i=0; i < (ssize_t) GetPixelChannels(image); i++)
+    {
+      const Quantum
+        *p;
+
+      double
+        alpha,
+        gamma,
+        pixel;
+
+      PixelChannel
+        channel;
+
+      PixelTrait
+        resize_traits,
+        traits;
+
+      ssize_t
+        j;
+
+      channel=GetPixelChannelChannel(image,i);
+      traits=GetPixelChannelTraits(image,channel);
+      resize_traits=GetPixelChannelTraits(resize_info->image,channel);
+      if ((traits == UndefinedPixelTrait) ||
+          (resize_traits == UndefinedPixelTrait))
+        continue;
+      if ((resize_traits & CopyPixelTrait) != 0)
+        {
+          p=resize_info->rows+(nearest % (ssize_t) resize_info->number_rows)*
+            (ssize_t) resize_info->extent+x*(ssize_t) GetPixelChannels(image);
+          SetPixelChannel(resize_info->image,channel,p[i],q);
+          continue;
+        }
+      pixel=0.0;
+      if ((resize_traits & BlendPixelTrait) == 0)
+        {
+          for (j=0; j < n; j++)
+          {
+            p=resize_info->rows+((start+j) % (ssize_t)
+              resize_info->number_rows)*(ssize_t) resize_info->extent+x*
+              (ssize_t) GetPixelChannels(image);
+            pixel+=weights[j]*(double) p[i];
+          }
+          SetPixelChannel(resize_info->image,channel,ClampToQuantum(pixel),q);
+          continue;
+        }
+      gamma=0.0;
+      for (j=0; j < n; j++)
+      {
+        p=resize_info->rows+((start+j) % (ssize_t) resize_info->number_rows)*
+          (ssize_t) resize_info->extent+x*(ssize_t) GetPixelChannels(image);
+        alpha=weights[j]*QuantumScale*(double) GetPixelAlpha(image,p);
+        pixel+=alpha*(double) p[i];
+        gamma+=alpha;
+      }
+      gamma=PerceptibleReciprocal(gamma);
+      SetPixelChannel(resize_info->image,channel,ClampToQuantum(gamma*pixel),
+        q);
+    }
+    q+=(ptrdiff_t) GetPixelChannels(resize_info->image);
+  }
+  resize_info->resize_y++;
+  return(MagickTrue);
+}
+
+static MagickBooleanType WriteStreamRow(StreamInfo *stream_info,
+  const Image *image,const size_t packet_size,const size_t length)
+{
+  RectangleInfo
+    extract_info;
+
+  ssize_t
+    count;
+
+  extract_info=stream_info->extract_info;
+  if ((extract_info.width == 0) || (extract_info.height == 0))
+    {
+      /*
+        Write all pixels to stream.
+      */
+      TransformStreamPixels(stream_info,image);
+      (void) StreamImagePixels(stream_info,image,stream_info->exception);
+      count=WriteBlob(stream_info->stream,length,stream_info->pixels);
+      stream_info->y++;
+      return(count == 0 ? MagickFalse : MagickTrue);
+    }
+  if ((stream_info->y < extract_info.y) ||
+      (stream_info->y >= (extract_info.y+(ssize_t) extract_info.height)))
+    {
+      stream_info->y++;
+      return(MagickTrue);
+    }
+  /*
+    Write a portion of the pixel row to the stream.
+  */
+  TransformStreamPixels(stream_info,image);
+  (void) StreamImagePixels(stream_info,image,stream_info->exception);
+  count=WriteBlob(stream_info->stream,packet_size*extract_info.width,
+    stream_info->pixels+(ssize_t) packet_size*extract_info.x);
+  stream_info->y++;
+  return(count == 0 ? MagickFalse : MagickTrue);
+}
+
 static size_t WriteStreamImage(const Image *image,const void *pixels,
   const size_t columns)
 {
   CacheInfo
     *cache_info;
 
-  RectangleInfo
-    extract_info;
-
   size_t
     length,
     packet_size;
 
   ssize_t
-    count;
+    y;
 
   StreamInfo
     *stream_info;
 
-  (void) pixels;
+  StreamResizeInfo
+    *resize_info;
+
   stream_info=(StreamInfo *) image->client_data;
+  if ((stream_info->resize != (char *) NULL) &&
+      (pixels == (const void *) NULL))
+    return(0);
   switch (stream_info->storage_type)
   {
     default: packet_size=sizeof(unsigned char); break;
@@ -1253,14 +2027,27 @@ static size_t WriteStreamImage(const Image *image,const void *pixels,
       ImageInfo
         *write_info;
 
+      size_t
+        extent;
+
       /*
         Prepare stream for writing.
       */
+      extent=length;
+      if (stream_info->resize != (char *) NULL)
+        {
+          if (AcquireStreamResize(stream_info,image,stream_info->exception) ==
+              MagickFalse)
+            return(0);
+          if (stream_info->resize_info != (StreamResizeInfo *) NULL)
+            extent=MagickMax(extent,packet_size*
+              stream_info->resize_info->image->columns);
+        }
       (void) RelinquishAlignedMemory(stream_info->pixels);
-      stream_info->pixels=(unsigned char *) AcquireAlignedMemory(1,length);
+      stream_info->pixels=(unsigned char *) AcquireAlignedMemory(1,extent);
       if (stream_info->pixels == (unsigned char *) NULL)
         return(0);
-      (void) memset(stream_info->pixels,0,length);
+      (void) memset(stream_info->pixels,0,extent);
       stream_info->image=image;
       write_info=CloneImageInfo(stream_info->image_info);
       (void) SetImageInfo(write_info,1,stream_info->exception);
@@ -1270,32 +2057,28 @@ static size_t WriteStreamImage(const Image *image,const void *pixels,
       stream_info->y=0;
       write_info=DestroyImageInfo(write_info);
     }
-  extract_info=stream_info->extract_info;
-  if ((extract_info.width == 0) || (extract_info.height == 0))
-    {
-      /*
-        Write all pixels to stream.
-      */
-      (void) StreamImagePixels(stream_info,image,stream_info->exception);
-      count=WriteBlob(stream_info->stream,length,stream_info->pixels);
-      stream_info->y++;
-      return(count == 0 ? 0 : columns);
-    }
-  if ((stream_info->y < extract_info.y) ||
-      (stream_info->y >= (extract_info.y+(ssize_t) extract_info.height)))
-    {
-      stream_info->y++;
-      return(columns);
-    }
+  resize_info=stream_info->resize_info;
+  if ((stream_info->resize == (char *) NULL) ||
+      (resize_info == (StreamResizeInfo *) NULL))
+    return(WriteStreamRow(stream_info,image,packet_size,length) == MagickFalse ?
+      0 : columns);
   /*
-    Write a portion of the pixel row to the stream.
+    Filter each source row into the ring, then write every resized row whose
+    vertical support is now complete.
   */
-  (void) StreamImagePixels(stream_info,image,stream_info->exception);
-  length=packet_size*extract_info.width;
-  count=WriteBlob(stream_info->stream,length,stream_info->pixels+(ssize_t)
-    packet_size*extract_info.x);
-  stream_info->y++;
-  return(count == 0 ? 0 : columns);
+  if (cache_info->columns != image->columns)
+    return(0);
+  for (y=0; y < (ssize_t) cache_info->rows; y++)
+  {
+    ResizeStreamRowHorizontally(resize_info,image,(const Quantum *) pixels+y*
+      (ssize_t) (image->columns*GetPixelChannels(image)));
+    while (ResizeStreamRowVertically(resize_info,image,
+           stream_info->exception) != MagickFalse)
+      if (WriteStreamRow(stream_info,resize_info->image,packet_size,
+          packet_size*resize_info->image->columns) == MagickFalse)
+        return(0);
+  }
+  return(columns);
 }
 
 #if defined(__cplusplus) || defined(c_plusplus)
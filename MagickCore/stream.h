@@ -36,6 +36,7 @@ extern MagickExport Image
 
 extern MagickExport MagickBooleanType
   OpenStream(const ImageInfo *,StreamInfo *,const char *,ExceptionInfo *),
+  SetStreamInfoLevel(StreamInfo *,const double,const double,const double),
   WriteStream(const ImageInfo *,Image *,StreamHandler,ExceptionInfo *);
 
 extern MagickExport StreamInfo
@@ -43,7 +44,9 @@ extern MagickExport StreamInfo
   *DestroyStreamInfo(StreamInfo *);
 
 extern MagickExport void
+  SetStreamInfoColorspace(StreamInfo *,const ColorspaceType),
   SetStreamInfoMap(StreamInfo *,const char *),
+  SetStreamInfoResize(StreamInfo *,const char *),
   SetStreamInfoStorageType(StreamInfo *,const StorageType);
 
 #if defined(__cplusplus) || defined(c_plusplus)
@@ -23,7 +23,9 @@ extern "C" {
 #endif
 
 extern MagickPrivate MagickBooleanType
-  TransformImage(Image **,const char *,const char *,ExceptionInfo *);
+  TransformImage(Image **,const char *,const char *,ExceptionInfo *),
+  TransposeImagePixels(const Image *,const MagickBooleanType,
+    const MagickBooleanType,const char *,Image *,ExceptionInfo *);
 
 #if defined(__cplusplus) || defined(c_plusplus)
 }
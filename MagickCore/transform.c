@@ -43,6 +43,7 @@
 #include "MagickCore/attribute.h"
 #include "MagickCore/artifact.h"
 #include "MagickCore/cache.h"
+#include "MagickCore/cache-private.h"
 #include "MagickCore/cache-view.h"
 #include "MagickCore/color.h"
 #include "MagickCore/color-private.h"
@@ -539,7 +540,9 @@ MagickExport Image *ConsolidateCMYKImages(const Image *images,
 %    o exception: return any errors or warnings in this structure.
 %
 */
-MagickExport Image *CropImage(const Image *image,const RectangleInfo *geometry,
+
+static Image *CropImageRegion(const Image *image,
+  const RectangleInfo *geometry,const MagickBooleanType view,
   ExceptionInfo *exception)
 {
 #define CropImageTag  "Crop/Image"
@@ -675,6 +678,15 @@ MagickExport Image *CropImage(const Image *image,const RectangleInfo *geometry,
     }
   crop_image->page.x=bounding_box.x;
   crop_image->page.y=bounding_box.y;
+  if ((view != MagickFalse) &&
+      (ReferencePixelCacheRegion(crop_image,image,&page) != MagickFalse))
+    {
+      /*
+        Crop is a read-only view of the image pixels, copied on first write.
+      */
+      crop_image->type=image->type;
+      return(crop_image);
+    }
   /*
     Crop image.
   */
@@ -749,6 +761,12 @@ MagickExport Image *CropImage(const Image *image,const RectangleInfo *geometry,
     crop_image=DestroyImage(crop_image);
   return(crop_image);
 }
+
+MagickExport Image *CropImage(const Image *image,const RectangleInfo *geometry,
+  ExceptionInfo *exception)
+{
+  return(CropImageRegion(image,geometry,MagickFalse,exception));
+}
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -887,7 +905,7 @@ MagickExport Image *CropImageToTiles(const Image *image,
             }
           crop.width=(size_t) ((ssize_t) crop.width-crop.x);
           crop.x+=image->page.x;
-          next=CropImage(image,&crop,exception);
+          next=CropImageRegion(image,&crop,MagickTrue,exception);
           if (next != (Image *) NULL)
             AppendImageToList(&crop_image,next);
         }
@@ -948,7 +966,7 @@ MagickExport Image *CropImageToTiles(const Image *image,
           geometry.height=height;
           geometry.x=x;
           geometry.y=y;
-          next=CropImage(image,&geometry,exception);
+          next=CropImageRegion(image,&geometry,MagickTrue,exception);
           if (next == (Image *) NULL)
             break;
           AppendImageToList(&crop_image,next);
@@ -1024,6 +1042,14 @@ MagickExport Image *ExcerptImage(const Image *image,
     exception);
   if (excerpt_image == (Image *) NULL)
     return((Image *) NULL);
+  if (ReferencePixelCacheRegion(excerpt_image,image,geometry) != MagickFalse)
+    {
+      /*
+        Excerpt is a read-only view of the image pixels, copied on first write.
+      */
+      excerpt_image->type=image->type;
+      return(excerpt_image);
+    }
   /*
     Excerpt each row.
   */
@@ -2104,36 +2130,95 @@ MagickPrivate MagickBooleanType TransformImage(Image **image,
 %                                                                             %
 %                                                                             %
 %                                                                             %
-%   T r a n s p o s e I m a g e                                               %
++   T r a n s p o s e I m a g e P i x e l s                                   %
 %                                                                             %
 %                                                                             %
 %                                                                             %
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
-%  TransposeImage() creates a horizontal mirror image by reflecting the pixels
-%  around the central y-axis while rotating them by 90 degrees.
+%  TransposeImagePixels() copies the image pixels to a destination image with
+%  rows and columns exchanged, optionally mirroring either source axis.  The
+%  destination pixel at (x,y) is the source pixel at (y,x), with the source
+%  column measured from the right if flop is true and the source row measured
+%  from the bottom if flip is true.  This covers transpose, transverse, and
+%  rotations of 90 and 270 degrees.
 %
-%  The format of the TransposeImage method is:
+%  The pixels are exchanged in square tiles so both the source and the
+%  destination are accessed a cache line at a time.  Threads work on bands of
+%  destination rows; in-core source images are read in place, a band of whole
+%  rows at a time.
 %
-%      Image *TransposeImage(const Image *image,ExceptionInfo *exception)
+%  The format of the TransposeImagePixels method is:
+%
+%      MagickBooleanType TransposeImagePixels(const Image *image,
+%        const MagickBooleanType flop,const MagickBooleanType flip,
+%        const char *tag,Image *transpose_image,ExceptionInfo *exception)
 %
 %  A description of each parameter follows:
 %
 %    o image: the image.
 %
+%    o flop: mirror the source columns.
+%
+%    o flip: mirror the source rows.
+%
+%    o tag: the progress monitor tag.
+%
+%    o transpose_image: the destination image, image->rows wide and
+%      image->columns high, with the same pixel channels as the image.
+%
 %    o exception: return any errors or warnings in this structure.
 %
 */
-MagickExport Image *TransposeImage(const Image *image,ExceptionInfo *exception)
+
+static inline void TransposePixelTile(const Quantum *magick_restrict p,
+  const ssize_t column_offset,const ssize_t row_offset,
+  Quantum *magick_restrict q,const ssize_t stride,const size_t width,
+  const size_t height,const size_t channels)
 {
-#define TransposeImageTag  "Transpose/Image"
+  ssize_t
+    y;
+
+  /*
+    Gather each destination row from a source column; a constant channel
+    count lets the compiler unroll the pixel copy.
+  */
+  for (y=0; y < (ssize_t) height; y++)
+  {
+    const Quantum
+      *magick_restrict s;
+
+    Quantum
+      *magick_restrict d;
+
+    ssize_t
+      x;
+
+    s=p+y*column_offset;
+    d=q+y*stride;
+    for (x=0; x < (ssize_t) width; x++)
+    {
+      ssize_t
+        i;
 
+      for (i=0; i < (ssize_t) channels; i++)
+        d[i]=s[i];
+      s+=(ptrdiff_t) row_offset;
+      d+=(ptrdiff_t) channels;
+    }
+  }
+}
+
+MagickPrivate MagickBooleanType TransposeImagePixels(const Image *image,
+  const MagickBooleanType flop,const MagickBooleanType flip,const char *tag,
+  Image *transpose_image,ExceptionInfo *exception)
+{
   CacheView
     *image_view,
     *transpose_view;
 
-  Image
-    *transpose_image;
+  CacheType
+    type;
 
   MagickBooleanType
     status;
@@ -2141,73 +2226,143 @@ MagickExport Image *TransposeImage(const Image *image,ExceptionInfo *exception)
   MagickOffsetType
     progress;
 
-  RectangleInfo
-    page;
+  size_t
+    channels,
+    tile_height,
+    tile_width;
 
   ssize_t
-    y;
+    tile_y;
 
   assert(image != (const Image *) NULL);
-  assert(image->signature == MagickCoreSignature);
-  assert(exception != (ExceptionInfo *) NULL);
-  assert(exception->signature == MagickCoreSignature);
-  if (IsEventLogging() != MagickFalse)
-    (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",image->filename);
-  transpose_image=CloneImage(image,image->rows,image->columns,MagickTrue,
-    exception);
-  if (transpose_image == (Image *) NULL)
-    return((Image *) NULL);
-  /*
-    Transpose image.
-  */
+  assert(transpose_image != (Image *) NULL);
+  if ((transpose_image->columns != image->rows) ||
+      (transpose_image->rows != image->columns) ||
+      (GetPixelChannels(transpose_image) != GetPixelChannels(image)))
+    ThrowBinaryException(ImageError,"ImageSizeDiffers",image->filename);
+  channels=GetPixelChannels(image);
+  GetPixelCacheTileSize(image,&tile_width,&tile_height);
+  type=GetImagePixelCacheType(image);
   status=MagickTrue;
   progress=0;
   image_view=AcquireVirtualCacheView(image,exception);
   transpose_view=AcquireAuthenticCacheView(transpose_image,exception);
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
   #pragma omp parallel for schedule(static) shared(progress,status) \
-    magick_number_threads(image,transpose_image,image->rows,2)
+    magick_number_threads(image,transpose_image,transpose_image->rows/ \
+      tile_height,2)
 #endif
-  for (y=0; y < (ssize_t) image->rows; y++)
+  for (tile_y=0; tile_y < (ssize_t) transpose_image->rows;
+       tile_y+=(ssize_t) tile_height)
   {
-    const Quantum
-      *magick_restrict p;
-
     Quantum
       *magick_restrict q;
 
+    size_t
+      height;
+
     ssize_t
-      x;
+      column,
+      tile_x;
 
     if (status == MagickFalse)
       continue;
-    p=GetCacheViewVirtualPixels(image_view,0,(ssize_t) image->rows-y-1,
-      image->columns,1,exception);
-    q=QueueCacheViewAuthenticPixels(transpose_view,(ssize_t) image->rows-y-1,
-      0,1,transpose_image->rows,exception);
-    if ((p == (const Quantum *) NULL) || (q == (Quantum *) NULL))
+    height=MagickMin(tile_height,transpose_image->rows-(size_t) tile_y);
+    q=QueueCacheViewAuthenticPixels(transpose_view,0,tile_y,
+      transpose_image->columns,height,exception);
+    if (q == (Quantum *) NULL)
       {
         status=MagickFalse;
         continue;
       }
-    for (x=0; x < (ssize_t) image->columns; x++)
+    column=tile_y;
+    if (flop != MagickFalse)
+      column=(ssize_t) image->columns-tile_y-(ssize_t) height;
+    for (tile_x=0; tile_x < (ssize_t) transpose_image->columns;
+         tile_x+=(ssize_t) tile_width)
     {
-      ssize_t
-        i;
+      const Quantum
+        *magick_restrict p;
 
-      for (i=0; i < (ssize_t) GetPixelChannels(image); i++)
+      size_t
+        width;
+
+      ssize_t
+        column_offset,
+        row,
+        row_offset;
+
+      width=MagickMin(tile_width,transpose_image->columns-(size_t) tile_x);
+      row=tile_x;
+      if (flip != MagickFalse)
+        row=(ssize_t) image->rows-tile_x-(ssize_t) width;
+      if ((type == MemoryCache) || (type == MapCache))
+        {
+          /*
+            Whole source rows are addressed in place.
+          */
+          p=GetCacheViewVirtualPixels(image_view,0,row,image->columns,width,
+            exception);
+          if (p != (const Quantum *) NULL)
+            p+=(ptrdiff_t) column*(ssize_t) channels;
+          row_offset=(ssize_t) (image->columns*channels);
+        }
+      else
+        {
+          p=GetCacheViewVirtualPixels(image_view,column,row,height,width,
+            exception);
+          row_offset=(ssize_t) (height*channels);
+        }
+      if (p == (const Quantum *) NULL)
+        {
+          status=MagickFalse;
+          break;
+        }
+      column_offset=(ssize_t) channels;
+      if (flop != MagickFalse)
+        {
+          p+=(ptrdiff_t) (height-1)*channels;
+          column_offset=(-column_offset);
+        }
+      if (flip != MagickFalse)
+        {
+          p+=(ptrdiff_t) (width-1)*row_offset;
+          row_offset=(-row_offset);
+        }
+      switch (channels)
       {
-        PixelChannel channel = GetPixelChannelChannel(image,i);
-        PixelTrait traits = GetPixelChannelTraits(image,channel);
-        PixelTrait transpose_traits=GetPixelChannelTraits(transpose_image,
-          channel);
-        if ((traits == UndefinedPixelTrait) ||
-            (transpose_traits == UndefinedPixelTrait))
-          continue;
-        SetPixelChannel(transpose_image,channel,p[i],q);
+        case 1:
+        {
+          TransposePixelTile(p,column_offset,row_offset,q+tile_x,(ssize_t)
+            transpose_image->columns,width,height,1);
+          break;
+        }
+        case 2:
+        {
+          TransposePixelTile(p,column_offset,row_offset,q+2*tile_x,(ssize_t)
+            (2*transpose_image->columns),width,height,2);
+          break;
+        }
+        case 3:
+        {
+          TransposePixelTile(p,column_offset,row_offset,q+3*tile_x,(ssize_t)
+            (3*transpose_image->columns),width,height,3);
+          break;
+        }
+        case 4:
+        {
+          TransposePixelTile(p,column_offset,row_offset,q+4*tile_x,(ssize_t)
+            (4*transpose_image->columns),width,height,4);
+          break;
+        }
+        default:
+        {
+          TransposePixelTile(p,column_offset,row_offset,q+(ssize_t) channels*
+            tile_x,(ssize_t) (channels*transpose_image->columns),width,height,
+            channels);
+          break;
+        }
       }
-      p+=(ptrdiff_t) GetPixelChannels(image);
-      q+=(ptrdiff_t) GetPixelChannels(transpose_image);
     }
     if (SyncCacheViewAuthenticPixels(transpose_view,exception) == MagickFalse)
       status=MagickFalse;
@@ -2219,14 +2374,70 @@ MagickExport Image *TransposeImage(const Image *image,ExceptionInfo *exception)
 #if defined(MAGICKCORE_OPENMP_SUPPORT)
         #pragma omp atomic
 #endif
-        progress++;
-        proceed=SetImageProgress(image,TransposeImageTag,progress,image->rows);
+        progress+=(MagickOffsetType) height;
+        proceed=SetImageProgress(image,tag,progress,transpose_image->rows);
         if (proceed == MagickFalse)
           status=MagickFalse;
       }
   }
   transpose_view=DestroyCacheView(transpose_view);
   image_view=DestroyCacheView(image_view);
+  return(status);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   T r a n s p o s e I m a g e                                               %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  TransposeImage() creates a horizontal mirror image by reflecting the pixels
+%  around the central y-axis while rotating them by 90 degrees.
+%
+%  The format of the TransposeImage method is:
+%
+%      Image *TransposeImage(const Image *image,ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image: the image.
+%
+%    o exception: return any errors or warnings in this structure.
+%
+*/
+MagickExport Image *TransposeImage(const Image *image,ExceptionInfo *exception)
+{
+#define TransposeImageTag  "Transpose/Image"
+
+  Image
+    *transpose_image;
+
+  MagickBooleanType
+    status;
+
+  RectangleInfo
+    page;
+
+  assert(image != (const Image *) NULL);
+  assert(image->signature == MagickCoreSignature);
+  assert(exception != (ExceptionInfo *) NULL);
+  assert(exception->signature == MagickCoreSignature);
+  if (IsEventLogging() != MagickFalse)
+    (void) LogMagickEvent(TraceEvent,GetMagickModule(),"%s",image->filename);
+  transpose_image=CloneImage(image,image->rows,image->columns,MagickTrue,
+    exception);
+  if (transpose_image == (Image *) NULL)
+    return((Image *) NULL);
+  /*
+    Transpose image.
+  */
+  status=TransposeImagePixels(image,MagickFalse,MagickFalse,TransposeImageTag,
+    transpose_image,exception);
   transpose_image->type=image->type;
   page=transpose_image->page;
   Swap(page.width,page.height);
@@ -2266,25 +2477,15 @@ MagickExport Image *TransverseImage(const Image *image,ExceptionInfo *exception)
 {
 #define TransverseImageTag  "Transverse/Image"
 
-  CacheView
-    *image_view,
-    *transverse_view;
-
   Image
     *transverse_image;
 
   MagickBooleanType
     status;
 
-  MagickOffsetType
-    progress;
-
   RectangleInfo
     page;
 
-  ssize_t
-    y;
-
   assert(image != (const Image *) NULL);
   assert(image->signature == MagickCoreSignature);
   assert(exception != (ExceptionInfo *) NULL);
@@ -2298,77 +2499,8 @@ MagickExport Image *TransverseImage(const Image *image,ExceptionInfo *exception)
   /*
     Transverse image.
   */
-  status=MagickTrue;
-  progress=0;
-  image_view=AcquireVirtualCacheView(image,exception);
-  transverse_view=AcquireAuthenticCacheView(transverse_image,exception);
-#if defined(MAGICKCORE_OPENMP_SUPPORT)
-  #pragma omp parallel for schedule(static) shared(progress,status) \
-    magick_number_threads(image,transverse_image,image->rows,2)
-#endif
-  for (y=0; y < (ssize_t) image->rows; y++)
-  {
-    MagickBooleanType
-      sync;
-
-    const Quantum
-      *magick_restrict p;
-
-    Quantum
-      *magick_restrict q;
-
-    ssize_t
-      x;
-
-    if (status == MagickFalse)
-      continue;
-    p=GetCacheViewVirtualPixels(image_view,0,y,image->columns,1,exception);
-    q=QueueCacheViewAuthenticPixels(transverse_view,(ssize_t) image->rows-y-1,
-      0,1,transverse_image->rows,exception);
-    if ((p == (const Quantum *) NULL) || (q == (Quantum *) NULL))
-      {
-        status=MagickFalse;
-        continue;
-      }
-    q+=(ptrdiff_t) GetPixelChannels(transverse_image)*image->columns;
-    for (x=0; x < (ssize_t) image->columns; x++)
-    {
-      ssize_t
-        i;
-
-      q-=GetPixelChannels(transverse_image);
-      for (i=0; i < (ssize_t) GetPixelChannels(image); i++)
-      {
-        PixelChannel channel = GetPixelChannelChannel(image,i);
-        PixelTrait traits = GetPixelChannelTraits(image,channel);
-        PixelTrait transverse_traits=GetPixelChannelTraits(transverse_image,
-          channel);
-        if ((traits == UndefinedPixelTrait) ||
-            (transverse_traits == UndefinedPixelTrait))
-          continue;
-        SetPixelChannel(transverse_image,channel,p[i],q);
-      }
-      p+=(ptrdiff_t) GetPixelChannels(image);
-    }
-    sync=SyncCacheViewAuthenticPixels(transverse_view,exception);
-    if (sync == MagickFalse)
-      status=MagickFalse;
-    if (image->progress_monitor != (MagickProgressMonitor) NULL)
-      {
-        MagickBooleanType
-          proceed;
-
-#if defined(MAGICKCORE_OPENMP_SUPPORT)
-        #pragma omp atomic
-#endif
-        progress++;
-        proceed=SetImageProgress(image,TransverseImageTag,progress,image->rows);
-        if (proceed == MagickFalse)
-          status=MagickFalse;
-      }
-  }
-  transverse_view=DestroyCacheView(transverse_view);
-  image_view=DestroyCacheView(image_view);
+  status=TransposeImagePixels(image,MagickTrue,MagickTrue,TransverseImageTag,
+    transverse_image,exception);
   transverse_image->type=image->type;
   page=transverse_image->page;
   Swap(page.width,page.height);
@@ -41,6 +41,7 @@
 */
 #include "MagickCore/studio.h"
 #include "MagickCore/blob.h"
+#include "MagickCore/blob-private.h"
 #include "MagickCore/client.h"
 #include "MagickCore/configure.h"
 #include "MagickCore/draw.h"
@@ -63,6 +64,7 @@
 #include "MagickCore/token.h"
 #include "MagickCore/utility.h"
 #include "MagickCore/utility-private.h"
+#include "MagickCore/version.h"
 #include "MagickCore/xml-tree.h"
 #if defined(MAGICKCORE_FONTCONFIG_DELEGATE)
 # include "fontconfig/fontconfig.h"
@@ -103,6 +105,9 @@
 /*
   Define declarations.
 */
+#define MagickFontConfigSnapshot  "fontconfig.cache"
+#define MagickFontConfigSignature  0x4d494643UL
+#define MagickFontConfigVersion  1UL
 #define MagickTypeFilename  "type.xml"
 
 /*
@@ -712,6 +717,380 @@ MagickExport char **GetTypeList(const char *pattern,size_t *number_fonts,
 */
 
 #if defined(MAGICKCORE_FONTCONFIG_DELEGATE)
+static const char
+  *FontConfigEnvironment[] =
+  {
+    "FONTCONFIG_FILE",
+    "FONTCONFIG_PATH",
+    "FONTCONFIG_SYSROOT",
+    "HOME",
+    "XDG_CONFIG_HOME",
+    "XDG_DATA_HOME",
+    (const char *) NULL
+  };
+
+static MagickBooleanType GetFontConfigSnapshotPath(char *path)
+{
+  char
+    *directory;
+
+  struct stat
+    attributes;
+
+  /*
+    The snapshot is opt-in: it lives in $MAGICK_FONT_CACHE_PATH when set.
+  */
+  *path='\0';
+  directory=GetEnvironmentValue("MAGICK_FONT_CACHE_PATH");
+  if (directory == (char *) NULL)
+    return(MagickFalse);
+  (void) CopyMagickString(path,directory,MagickPathExtent);
+  directory=DestroyString(directory);
+  if (*path == '\0')
+    return(MagickFalse);
+  if (GetPathAttributes(path,&attributes) == MagickFalse)
+    {
+      char
+        parent[MagickPathExtent];
+
+      GetPathComponent(path,HeadPath,parent);
+      if ((*parent == '\0') || (IsPathAccessible(parent) == MagickFalse))
+        return(MagickFalse);
+#if defined(MAGICKCORE_WINDOWS_SUPPORT)
+      if (mkdir(path) != 0)
+#else
+      if (mkdir(path,0700) != 0)
+#endif
+        return(MagickFalse);
+    }
+  (void) ConcatenateMagickString(path,DirectorySeparator,MagickPathExtent);
+  (void) ConcatenateMagickString(path,MagickFontConfigSnapshot,
+    MagickPathExtent);
+  return(MagickTrue);
+}
+
+static inline MagickBooleanType ReadFontConfigValue(const unsigned char **p,
+  const unsigned char *q,void *value,const size_t length)
+{
+  if ((size_t) (q-(*p)) < length)
+    return(MagickFalse);
+  (void) memcpy(value,*p,length);
+  *p+=length;
+  return(MagickTrue);
+}
+
+static MagickBooleanType ReadFontConfigString(const unsigned char **p,
+  const unsigned char *q,char *value,MagickBooleanType *defined)
+{
+  unsigned int
+    length;
+
+  if (ReadFontConfigValue(p,q,&length,sizeof(length)) == MagickFalse)
+    return(MagickFalse);
+  *defined=MagickTrue;
+  *value='\0';
+  if (length == ~0U)
+    {
+      *defined=MagickFalse;
+      return(MagickTrue);
+    }
+  if ((length >= MagickPathExtent) ||
+      (ReadFontConfigValue(p,q,value,length) == MagickFalse))
+    return(MagickFalse);
+  value[length]='\0';
+  return(MagickTrue);
+}
+
+static inline void WriteFontConfigString(FILE *file,const char *value)
+{
+  unsigned int
+    length;
+
+  length=(value == (const char *) NULL) ? ~0U : (unsigned int)
+    MagickMin(strlen(value),MagickPathExtent-1);
+  (void) fwrite(&length,sizeof(length),1,file);
+  if (value != (const char *) NULL)
+    (void) fwrite(value,1,length,file);
+}
+
+static void WriteFontConfigPath(FILE *file,const char *path)
+{
+  MagickOffsetType
+    extent,
+    modified;
+
+  struct stat
+    attributes;
+
+  extent=(-1);
+  modified=(-1);
+  if (GetPathAttributes(path,&attributes) != MagickFalse)
+    {
+      extent=(MagickOffsetType) attributes.st_size;
+      modified=(MagickOffsetType) attributes.st_mtime;
+    }
+  WriteFontConfigString(file,path);
+  (void) fwrite(&extent,sizeof(extent),1,file);
+  (void) fwrite(&modified,sizeof(modified),1,file);
+}
+
+static MagickBooleanType LoadFontConfigSnapshot(SplayTreeInfo *type_cache,
+  const char *filename)
+{
+  char
+    family[MagickPathExtent],
+    glyphs[MagickPathExtent],
+    name[MagickPathExtent],
+    value[MagickPathExtent];
+
+  const unsigned char
+    *fonts,
+    *p,
+    *q;
+
+  int
+    file;
+
+  MagickBooleanType
+    defined,
+    status;
+
+  size_t
+    length;
+
+  ssize_t
+    i,
+    pass;
+
+  struct stat
+    attributes;
+
+  unsigned char
+    *map;
+
+  unsigned int
+    number_paths,
+    signature,
+    version;
+
+  /*
+    Memory-map the snapshot and confirm it still describes the system fonts.
+  */
+  file=open_utf8(filename,O_RDONLY | O_BINARY,0);
+  if (file == -1)
+    return(MagickFalse);
+  if ((fstat(file,&attributes) != 0) || (attributes.st_size <= 0))
+    {
+      (void) close(file);
+      return(MagickFalse);
+    }
+  length=(size_t) attributes.st_size;
+  map=(unsigned char *) MapBlob(file,ReadMode,0,length);
+  (void) close(file);
+  if (map == (unsigned char *) NULL)
+    return(MagickFalse);
+  p=map;
+  q=map+length;
+  status=ReadFontConfigValue(&p,q,&signature,sizeof(signature));
+  if ((status == MagickFalse) || (signature != MagickFontConfigSignature))
+    status=MagickFalse;
+  if (status != MagickFalse)
+    status=ReadFontConfigValue(&p,q,&version,sizeof(version));
+  if (status != MagickFalse)
+    {
+      if ((version != MagickFontConfigVersion) ||
+          (ReadFontConfigValue(&p,q,&signature,sizeof(signature)) ==
+           MagickFalse) || (signature != (unsigned int) MagickLibVersion) ||
+          (ReadFontConfigValue(&p,q,&version,sizeof(version)) ==
+           MagickFalse) || (version != (unsigned int) FcGetVersion()))
+        status=MagickFalse;
+    }
+  for (i=0; FontConfigEnvironment[i] != (const char *) NULL; i++)
+  {
+    char
+      *environment;
+
+    if (status == MagickFalse)
+      break;
+    status=ReadFontConfigString(&p,q,value,&defined);
+    if (status == MagickFalse)
+      break;
+    environment=GetEnvironmentValue(FontConfigEnvironment[i]);
+    if ((environment == (char *) NULL) ? (defined != MagickFalse) :
+        ((defined == MagickFalse) || (strcmp(environment,value) != 0)))
+      status=MagickFalse;
+    if (environment != (char *) NULL)
+      environment=DestroyString(environment);
+  }
+  if (status != MagickFalse)
+    status=ReadFontConfigValue(&p,q,&number_paths,sizeof(number_paths));
+  for (i=0; (status != MagickFalse) && (i < (ssize_t) number_paths); i++)
+  {
+    MagickOffsetType
+      extent,
+      modified;
+
+    if ((ReadFontConfigString(&p,q,value,&defined) == MagickFalse) ||
+        (ReadFontConfigValue(&p,q,&extent,sizeof(extent)) == MagickFalse) ||
+        (ReadFontConfigValue(&p,q,&modified,sizeof(modified)) == MagickFalse))
+      {
+        status=MagickFalse;
+        break;
+      }
+    if (GetPathAttributes(value,&attributes) == MagickFalse)
+      {
+        if (modified != -1)
+          status=MagickFalse;
+        continue;
+      }
+    if ((extent != (MagickOffsetType) attributes.st_size) ||
+        (modified != (MagickOffsetType) attributes.st_mtime))
+      status=MagickFalse;
+  }
+  /*
+    Validate the font records, then replay them in enumeration order.
+  */
+  fonts=p;
+  for (pass=0; (status != MagickFalse) && (pass < 2); pass++)
+  for (p=fonts; (status != MagickFalse) && (p < q); )
+  {
+    TypeInfo
+      *type_info;
+
+    unsigned int
+      face,
+      stretch,
+      style,
+      weight;
+
+    if ((ReadFontConfigString(&p,q,name,&defined) == MagickFalse) ||
+        (ReadFontConfigString(&p,q,family,&defined) == MagickFalse) ||
+        (ReadFontConfigString(&p,q,glyphs,&defined) == MagickFalse) ||
+        (ReadFontConfigValue(&p,q,&face,sizeof(face)) == MagickFalse) ||
+        (ReadFontConfigValue(&p,q,&style,sizeof(style)) == MagickFalse) ||
+        (ReadFontConfigValue(&p,q,&stretch,sizeof(stretch)) == MagickFalse) ||
+        (ReadFontConfigValue(&p,q,&weight,sizeof(weight)) == MagickFalse))
+      {
+        status=MagickFalse;
+        break;
+      }
+    if (pass == 0)
+      continue;
+    type_info=(TypeInfo *) AcquireMagickMemory(sizeof(*type_info));
+    if (type_info == (TypeInfo *) NULL)
+      continue;
+    (void) memset(type_info,0,sizeof(*type_info));
+    type_info->path=ConstantString("System Fonts");
+    type_info->signature=MagickCoreSignature;
+    type_info->name=ConstantString(name);
+    type_info->family=ConstantString(family);
+    type_info->glyphs=ConstantString(glyphs);
+    type_info->face=(size_t) face;
+    type_info->style=(StyleType) style;
+    type_info->stretch=(StretchType) stretch;
+    type_info->weight=(size_t) weight;
+    (void) AddValueToSplayTree(type_cache,type_info->name,type_info);
+  }
+  (void) UnmapBlob(map,length);
+  return(status);
+}
+
+static FILE *OpenFontConfigSnapshot(FcConfig *font_config,const char *filename,
+  char *path)
+{
+  FcStrList
+    *list;
+
+  FcChar8
+    *entry;
+
+  FILE
+    *file;
+
+  MagickOffsetType
+    offset;
+
+  ssize_t
+    i;
+
+  unsigned int
+    number_paths,
+    value;
+
+  /*
+    Record the fontconfig configuration files and font directories along with
+    their timestamps so a stale snapshot is detected.
+  */
+  (void) FormatLocaleString(path,MagickPathExtent,"%s.%.20g",filename,
+    (double) getpid());
+  file=fopen_utf8(path,"wb");
+  if (file == (FILE *) NULL)
+    return(file);
+  value=(unsigned int) MagickFontConfigSignature;
+  (void) fwrite(&value,sizeof(value),1,file);
+  value=(unsigned int) MagickFontConfigVersion;
+  (void) fwrite(&value,sizeof(value),1,file);
+  value=(unsigned int) MagickLibVersion;
+  (void) fwrite(&value,sizeof(value),1,file);
+  value=(unsigned int) FcGetVersion();
+  (void) fwrite(&value,sizeof(value),1,file);
+  for (i=0; FontConfigEnvironment[i] != (const char *) NULL; i++)
+  {
+    char
+      *environment;
+
+    environment=GetEnvironmentValue(FontConfigEnvironment[i]);
+    WriteFontConfigString(file,environment);
+    if (environment != (char *) NULL)
+      environment=DestroyString(environment);
+  }
+  offset=(MagickOffsetType) ftell(file);
+  number_paths=0;
+  (void) fwrite(&number_paths,sizeof(number_paths),1,file);
+  list=FcConfigGetConfigFiles(font_config);
+  if (list != (FcStrList *) NULL)
+    {
+      while ((entry=FcStrListNext(list)) != (FcChar8 *) NULL)
+      {
+        WriteFontConfigPath(file,(const char *) entry);
+        number_paths++;
+      }
+      FcStrListDone(list);
+    }
+  list=FcConfigGetFontDirs(font_config);
+  if (list != (FcStrList *) NULL)
+    {
+      while ((entry=FcStrListNext(list)) != (FcChar8 *) NULL)
+      {
+        WriteFontConfigPath(file,(const char *) entry);
+        number_paths++;
+      }
+      FcStrListDone(list);
+    }
+  (void) fseek(file,(off_t) offset,SEEK_SET);
+  (void) fwrite(&number_paths,sizeof(number_paths),1,file);
+  (void) fseek(file,0,SEEK_END);
+  return(file);
+}
+
+static void WriteFontConfigSnapshot(FILE *file,const TypeInfo *type_info)
+{
+  unsigned int
+    value;
+
+  WriteFontConfigString(file,type_info->name);
+  WriteFontConfigString(file,type_info->family);
+  WriteFontConfigString(file,type_info->glyphs);
+  value=(unsigned int) type_info->face;
+  (void) fwrite(&value,sizeof(value),1,file);
+  value=(unsigned int) type_info->style;
+  (void) fwrite(&value,sizeof(value),1,file);
+  value=(unsigned int) type_info->stretch;
+  (void) fwrite(&value,sizeof(value),1,file);
+  value=(unsigned int) type_info->weight;
+  (void) fwrite(&value,sizeof(value),1,file);
+}
+
 MagickExport MagickBooleanType LoadFontConfigFonts(SplayTreeInfo *type_cache,
   ExceptionInfo *exception)
 {
@@ -721,15 +1100,17 @@ MagickExport MagickBooleanType LoadFontConfigFonts(SplayTreeInfo *type_cache,
 
   char
     extension[MagickPathExtent],
-    name[MagickPathExtent];
+    name[MagickPathExtent],
+    path[MagickPathExtent],
+    snapshot[MagickPathExtent];
 
   FcBool
     result;
 
   FcChar8
     *family,
-    *file,
     *fullname,
+    *glyphs,
     *style;
 
   FcConfig
@@ -747,6 +1128,9 @@ MagickExport MagickBooleanType LoadFontConfigFonts(SplayTreeInfo *type_cache,
   FcResult
     status;
 
+  FILE
+    *file;
+
   int
     index,
     slant,
@@ -760,9 +1144,19 @@ MagickExport MagickBooleanType LoadFontConfigFonts(SplayTreeInfo *type_cache,
     *type_info;
 
   /*
-    Load system fonts.
+    Load system fonts, preferably from the snapshot of a prior enumeration.
   */
   (void) exception;
+  *snapshot='\0';
+  if (GetFontConfigSnapshotPath(snapshot) != MagickFalse)
+    {
+      if (LoadFontConfigSnapshot(type_cache,snapshot) != MagickFalse)
+        {
+          (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
+            "Loading font snapshot \"%s\" ...",snapshot);
+          return(MagickTrue);
+        }
+    }
   result=FcInit();
   if (result == 0)
     return(MagickFalse);
@@ -788,16 +1182,19 @@ MagickExport MagickBooleanType LoadFontConfigFonts(SplayTreeInfo *type_cache,
       FcConfigDestroy(font_config);
       return(MagickFalse);
     }
+  file=(FILE *) NULL;
+  if (*snapshot != '\0')
+    file=OpenFontConfigSnapshot(font_config,snapshot,path);
   for (i=0; i < (ssize_t) font_set->nfont; i++)
   {
     status=FcPatternGetString(font_set->fonts[i],FC_FAMILY,0,&family);
     if (status != FcResultMatch)
       continue;
-    status=FcPatternGetString(font_set->fonts[i],FC_FILE,0,&file);
+    status=FcPatternGetString(font_set->fonts[i],FC_FILE,0,&glyphs);
     if (status != FcResultMatch)
       continue;
     *extension='\0';
-    GetPathComponent((const char *) file,ExtensionPath,extension);
+    GetPathComponent((const char *) glyphs,ExtensionPath,extension);
     if ((*extension != '\0') && (LocaleCompare(extension,"gz") == 0))
       continue;
     type_info=(TypeInfo *) AcquireMagickMemory(sizeof(*type_info));
@@ -875,9 +1272,16 @@ MagickExport MagickBooleanType LoadFontConfigFonts(SplayTreeInfo *type_cache,
       type_info->weight=800;
     if (weight >= FC_WEIGHT_BLACK)
       type_info->weight=900;
-    type_info->glyphs=ConstantString((const char *) file);
+    type_info->glyphs=ConstantString((const char *) glyphs);
+    if (file != (FILE *) NULL)
+      WriteFontConfigSnapshot(file,type_info);
     (void) AddValueToSplayTree(type_cache,type_info->name,type_info);
   }
+  if (file != (FILE *) NULL)
+    {
+      if ((fclose(file) != 0) || (rename_utf8(path,snapshot) != 0))
+        (void) remove_utf8(path);
+    }
   FcFontSetDestroy(font_set);
   FcConfigDestroy(font_config);
   return(MagickTrue);
@@ -89,7 +89,9 @@ struct _XMLTreeInfo
     *next,
     *sibling,
     *ordered,
-    *child;
+    *child,
+    *ordered_tail,
+    *next_tail;
 
   MagickBooleanType
     debug;
@@ -1123,9 +1125,12 @@ MagickPrivate XMLTreeInfo *InsertTagIntoXMLTree(XMLTreeInfo *xml_info,
   child->next=(XMLTreeInfo *) NULL;
   child->offset=offset;
   child->parent=xml_info;
+  child->ordered_tail=(XMLTreeInfo *) NULL;
+  child->next_tail=(XMLTreeInfo *) NULL;
   if (xml_info->child == (XMLTreeInfo *) NULL)
     {
       xml_info->child=child;
+      xml_info->ordered_tail=child;
       return(child);
     }
   head=xml_info->child;
@@ -1136,12 +1141,20 @@ MagickPrivate XMLTreeInfo *InsertTagIntoXMLTree(XMLTreeInfo *xml_info,
     }
   else
     {
+      /*
+        Tags are usually appended in document order: start from the tail.
+      */
       node=head;
+      if ((xml_info->ordered_tail != (XMLTreeInfo *) NULL) &&
+          (xml_info->ordered_tail->offset <= offset))
+        node=xml_info->ordered_tail;
       while ((node->ordered != (XMLTreeInfo *) NULL) &&
              (node->ordered->offset <= offset))
         node=node->ordered;
       child->ordered=node->ordered;
       node->ordered=child;
+      if (child->ordered == (XMLTreeInfo *) NULL)
+        xml_info->ordered_tail=child;
     }
   previous=(XMLTreeInfo *) NULL;
   node=head;
@@ -1152,11 +1165,20 @@ MagickPrivate XMLTreeInfo *InsertTagIntoXMLTree(XMLTreeInfo *xml_info,
   }
   if ((node != (XMLTreeInfo *) NULL) && (node->offset <= offset))
     {
+      XMLTreeInfo
+        *first;
+
+      first=node;
+      if ((first->next_tail != (XMLTreeInfo *) NULL) &&
+          (first->next_tail->offset <= offset))
+        node=first->next_tail;
       while ((node->next != (XMLTreeInfo *) NULL) &&
              (node->next->offset <= offset))
         node=node->next;
       child->next=node->next;
       node->next=child;
+      if (child->next == (XMLTreeInfo *) NULL)
+        first->next_tail=child;
     }
   else
     {
@@ -2331,6 +2353,15 @@ MagickPrivate XMLTreeInfo *PruneTagFromXMLTree(XMLTreeInfo *xml_info)
     xml_info->next->sibling=xml_info->sibling;
   if (xml_info->parent != (XMLTreeInfo *) NULL)
     {
+      /*
+        Forget the insertion hints of the parent.
+      */
+      xml_info->parent->ordered_tail=(XMLTreeInfo *) NULL;
+      for (node=xml_info->parent->child; node != (XMLTreeInfo *) NULL; )
+      {
+        node->next_tail=(XMLTreeInfo *) NULL;
+        node=node->sibling;
+      }
       node=xml_info->parent->child;
       if (node == xml_info)
         xml_info->parent->child=xml_info->ordered;
@@ -59,6 +59,16 @@
 #include "MagickCore/utility-private.h"
 #include "MagickCore/exception-private.h"
 #include "MagickCore/version.h"
+#if defined(MAGICKCORE_HAVE_SOCKET) && defined(MAGICKCORE_HAVE_POLL) && \
+    defined(MAGICKCORE_THREAD_SUPPORT) && !defined(MAGICKCORE_WINDOWS_SUPPORT)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#define MAGICKCORE_HAVE_CLI_SERVER 1
+#ifndef MSG_NOSIGNAL
+#  define MSG_NOSIGNAL 0
+#endif
+#endif
 
 /* verbose debugging,
       0 - no debug lines
@@ -1138,6 +1148,11 @@ static MagickBooleanType MagickCommandUsage(void)
   (void) FormatLocaleFile(stdout,
     "       %s [ {option} | {image} ... ] -script {filename} [ {script_args} ...]\n",
     GetClientName());
+  (void) FormatLocaleFile(stdout,
+    "       %s -batch {jobs} [ {results} ]\n",GetClientName());
+  (void) FormatLocaleFile(stdout,
+    "       %s -server {socket} | -client {socket} [ {option} | {image} ... ]\n",
+    GetClientName());
   (void) FormatLocaleFile(stdout,"\nImage Settings:\n");
   (void) FormatLocaleFile(stdout,"%s\n",settings);
   (void) FormatLocaleFile(stdout,"\nImage Operators:\n");
@@ -1201,11 +1216,17 @@ static void MagickUsage(MagickBooleanType verbose)
     (void) FormatLocaleFile(stdout,
        "       %s [ {option} | {image} ... ] -script {filename} [ {script_args} ...]\n",
        name);
+    (void) FormatLocaleFile(stdout,
+       "       %s -batch {jobs} [ {results} ]\n",name);
+    (void) FormatLocaleFile(stdout,
+       "       %s -server {socket} | -client {socket} [ {option} | {image} ... ]\n",
+       name);
   }
   (void) FormatLocaleFile(stdout,
     "       %s -help | -version | -usage | -list {option}\n\n",name);
 
-  (void) FormatLocaleFile(stdout,"%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s\n",
+  (void) FormatLocaleFile(stdout,
+    "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s\n",
     "All options are performed in a strict 'as you see them' order\n",
     "You must read-in images before you can operate on them.\n",
     "\n",
@@ -1220,6 +1241,14 @@ static void MagickUsage(MagickBooleanType verbose)
     "The latter two forms do not require the path to the command hard coded.\n",
     "Note: \"magick-script\" needs to be linked to the \"magick\" command.\n",
     "\n",
+    "A batch file ('-' for standard input) holds one command line per line,\n",
+    "which are run concurrently within this process.  The exit status and\n",
+    "elapsed time of each job are written to the results file (default\n",
+    "standard error).  Set MAGICK_BATCH_JOBS to the number of concurrent\n",
+    "jobs; the thread limit is shared between them.  A server runs that\n",
+    "many jobs at once for the clients of its Unix domain socket; a client\n",
+    "passes its standard input, output, and error as \"fd:0\" to \"fd:2\".\n",
+    "\n",
     "For more information on usage, options, examples, and techniques\n",
     "see the ImageMagick website at    ", MagickAuthoritativeURL);
 
@@ -1281,6 +1310,796 @@ static MagickBooleanType ConcatenateImages(int argc,char **argv,
   return(status);
 }
 
+/*
+   Helpers shared by the batch and server modes, which run many independent
+   magick command lines as jobs within this one process.
+*/
+static char **AcquireJobArguments(const char *command,int *argc)
+{
+  char
+    **argv;
+
+  argv=StringToArgv(command,argc);
+  if ((argv != (char **) NULL) && (*argc > 1) &&
+      (LocaleCompare(argv[1],"magick") == 0))
+    {
+      argv[1]=DestroyString(argv[1]);
+      (void) memmove(argv+1,argv+2,(size_t) (*argc-1)*sizeof(*argv));
+      (*argc)--;
+    }
+  return(argv);
+}
+
+static char **DestroyJobArguments(char **argv,const int argc)
+{
+  int
+    i;
+
+  for (i=0; i < argc; i++)
+    argv[i]=DestroyString(argv[i]);
+  return((char **) RelinquishMagickMemory(argv));
+}
+
+static MagickBooleanType ExecuteMagickJob(const ImageInfo *image_info,
+  int argc,char **argv,ExceptionInfo *exception)
+{
+  ImageInfo
+    *job_info;
+
+  int
+    i;
+
+  MagickBooleanType
+    regard_warnings,
+    status;
+
+  regard_warnings=MagickFalse;
+  for (i=1; i < argc; i++)
+    if (LocaleCompare("-regard-warnings",argv[i]) == 0)
+      regard_warnings=MagickTrue;
+  job_info=CloneImageInfo(image_info);
+  status=MagickImageCommand(job_info,argc,argv,(char **) NULL,exception);
+  job_info=DestroyImageInfo(job_info);
+  if ((exception->severity > ErrorException) ||
+      ((exception->severity != UndefinedException) &&
+       (regard_warnings != MagickFalse)))
+    status=MagickFalse;
+  return(status);
+}
+
+static size_t SetJobConcurrency(const size_t number_jobs)
+{
+  char
+    *value;
+
+  MagickSizeType
+    number_threads;
+
+  size_t
+    number_concurrent;
+
+  /*
+    Every job is named "magick" by StringToArgv(): set the client name once,
+    before the jobs run, so MagickImageCommand() need not set it again.
+  */
+  (void) SetClientName("magick");
+  /*
+    Split the thread limit evenly between the concurrent jobs.
+  */
+  number_threads=GetMagickResourceLimit(ThreadResource);
+  number_concurrent=(size_t) number_threads;
+  value=GetEnvironmentValue("MAGICK_BATCH_JOBS");
+  if (value != (char *) NULL)
+    {
+      number_concurrent=StringToSizeType(value,100.0);
+      value=DestroyString(value);
+    }
+  number_concurrent=MagickMax(MagickMin(number_concurrent,number_jobs),1);
+  (void) SetMagickResourceLimit(ThreadResource,MagickMax(number_threads/
+    number_concurrent,1));
+  if (number_concurrent > 1)
+    SetOpenMPNested(1);
+  return(number_concurrent);
+}
+
+/*
+   Run the command lines of a batch file as independent jobs in this process.
+
+      magick -batch jobs.txt [results.txt]
+
+   Each non-blank line that does not start with '#' is a magick command line
+   (optionally preceded by "magick").  The jobs share the configuration,
+   module, and font caches of this process.  MAGICK_BATCH_JOBS sets how many
+   jobs run at once (default the thread limit) and the thread limit is split
+   evenly between them for the operators each job runs.  For every job its
+   line number, exit status, elapsed seconds, and command line are written,
+   tab separated and in completion order, to the results file (default
+   standard error).
+*/
+static MagickBooleanType ProcessBatchJobs(ImageInfo *image_info,int argc,
+  char **argv,ExceptionInfo *exception)
+{
+  char
+    **jobs,
+    *p,
+    *text;
+
+  FILE
+    *results;
+
+  MagickBooleanType
+    status;
+
+  MagickSizeType
+    number_threads;
+
+  size_t
+    *lines,
+    line,
+    number_concurrent,
+    number_jobs;
+
+  ssize_t
+    i;
+
+  text=FileToString(argv[2],~0UL,exception);
+  if (text == (char *) NULL)
+    return(MagickFalse);
+  results=stderr;
+  if (argc > 3)
+    {
+      results=fopen_utf8(argv[3],"w");
+      if (results == (FILE *) NULL)
+        {
+          ThrowFileException(exception,FileOpenError,"UnableToOpenFile",
+            argv[3]);
+          text=DestroyString(text);
+          return(MagickFalse);
+        }
+    }
+  /*
+    Split the batch file into jobs, one per line.
+  */
+  number_jobs=1;
+  for (p=text; *p != '\0'; p++)
+    if (*p == '\n')
+      number_jobs++;
+  jobs=(char **) AcquireQuantumMemory(number_jobs,sizeof(*jobs));
+  lines=(size_t *) AcquireQuantumMemory(number_jobs,sizeof(*lines));
+  if ((jobs == (char **) NULL) || (lines == (size_t *) NULL))
+    {
+      if (jobs != (char **) NULL)
+        jobs=(char **) RelinquishMagickMemory(jobs);
+      if (lines != (size_t *) NULL)
+        lines=(size_t *) RelinquishMagickMemory(lines);
+      if (results != stderr)
+        (void) fclose(results);
+      text=DestroyString(text);
+      ThrowWandFatalException(ResourceLimitFatalError,
+        "MemoryAllocationFailed",argv[2]);
+    }
+  number_jobs=0;
+  line=0;
+  for (p=text; p != (char *) NULL; )
+  {
+    char
+      *q,
+      *r;
+
+    line++;
+    q=strchr(p,'\n');
+    if (q != (char *) NULL)
+      *q++='\0';
+    while (isspace((int) ((unsigned char) *p)) != 0)
+      p++;
+    r=p+strlen(p);
+    while ((r > p) && (isspace((int) ((unsigned char) *(r-1))) != 0))
+      r--;
+    *r='\0';
+    if ((*p != '\0') && (*p != '#'))
+      {
+        lines[number_jobs]=line;
+        jobs[number_jobs++]=p;
+      }
+    p=q;
+  }
+  number_threads=GetMagickResourceLimit(ThreadResource);
+  number_concurrent=SetJobConcurrency(number_jobs);
+  status=MagickTrue;
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(dynamic,1) shared(status) \
+    num_threads((int) number_concurrent)
+#else
+  (void) number_concurrent;
+#endif
+  for (i=0; i < (ssize_t) number_jobs; i++)
+  {
+    char
+      **job_argv;
+
+    double
+      elapsed_time;
+
+    ExceptionInfo
+      *job_exception;
+
+    int
+      job_argc;
+
+    MagickBooleanType
+      job_status;
+
+    TimerInfo
+      *timer;
+
+    timer=AcquireTimerInfo();
+    job_argv=AcquireJobArguments(jobs[i],&job_argc);
+    job_exception=AcquireExceptionInfo();
+    job_status=ExecuteMagickJob(image_info,job_argc,job_argv,job_exception);
+    elapsed_time=GetElapsedTime(timer);
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+    #pragma omp critical (MagickWand_ProcessBatchJobs)
+#endif
+    {
+      if (job_exception->severity != UndefinedException)
+        CatchException(job_exception);
+      if (job_status == MagickFalse)
+        status=MagickFalse;
+      (void) FormatLocaleFile(results,"%.20g\t%d\t%.6f\t%s\n",(double)
+        lines[i],job_status != MagickFalse ? 0 : 1,elapsed_time,jobs[i]);
+      (void) fflush(results);
+    }
+    job_exception=DestroyExceptionInfo(job_exception);
+    job_argv=DestroyJobArguments(job_argv,job_argc);
+    timer=DestroyTimerInfo(timer);
+  }
+  (void) SetMagickResourceLimit(ThreadResource,number_threads);
+  if (results != stderr)
+    (void) fclose(results);
+  lines=(size_t *) RelinquishMagickMemory(lines);
+  jobs=(char **) RelinquishMagickMemory(jobs);
+  text=DestroyString(text);
+  if (status == MagickFalse)
+    (void) ThrowMagickException(exception,GetMagickModule(),OptionError,
+      "BatchJobFailed","`%s'",argv[2]);
+  return(status);
+}
+
+#if defined(MAGICKCORE_HAVE_CLI_SERVER)
+/*
+   Serve magick command lines over a Unix domain socket.
+
+      magick -server /path/to/socket
+      magick -client /path/to/socket {command line ...}
+
+   A client connects, passes up to MagickServerDescriptors open file
+   descriptors (SCM_RIGHTS, e.g. files, pipes, or memfd shared memory
+   buffers), and sends one command line terminated by a newline.  In the
+   command, "fd:N" names the N-th passed descriptor, and "-" names the first
+   (input) or, as the final argument, the second (output) one.  The server
+   answers with one line: the exit status, the elapsed seconds, and any
+   exception message, tab separated, then closes the connection.  Relative
+   filenames are resolved in the working directory of the server.
+
+   Requests run on a fixed pool of MAGICK_BATCH_JOBS worker threads (default
+   the thread limit) that share the thread limit as -batch does.  Resource
+   limits are process wide, so the server's limits (policy, environment, or
+   options given before -server) apply to each request.  A request may not
+   use options that change process state (-limit, -debug, -seed, ...) and a
+   "fd:N" or "-" without a matching passed descriptor fails the request.
+   SIGINT, SIGTERM, or SIGHUP stops the server once the requests in progress
+   are answered, and removes the socket.
+*/
+#define MagickServerDescriptors  8
+#define MagickServerPendingConnections  64
+#define MagickServerRequestExtent  65536
+
+typedef struct _ServerInfo
+{
+  const ImageInfo
+    *image_info;
+
+  int
+    socket,
+    stop;
+} ServerInfo;
+
+static MagickBooleanType IsServerOptionAuthorized(const char *option)
+{
+  const OptionInfo
+    *option_info;
+
+  /*
+    Requests share this process: refuse options that change its global state
+    (debug, seed, limits, ...), print to its terminal, or read more options.
+  */
+  if ((*option != '-') && (*option != '+'))
+    return(MagickTrue);
+  if ((LocaleCompare(option+1,"batch") == 0) ||
+      (LocaleCompare(option+1,"client") == 0) ||
+      (LocaleCompare(option+1,"distribute-cache") == 0) ||
+      (LocaleCompare(option+1,"list") == 0) ||
+      (LocaleCompare(option+1,"precision") == 0) ||
+      (LocaleCompare(option+1,"script") == 0) ||
+      (LocaleCompare(option+1,"server") == 0) ||
+      (LocaleCompare(option+1,"version") == 0))
+    return(MagickFalse);
+  option_info=GetCommandOptionInfo(option);
+  if ((option_info->flags & (GlobalOptionFlag | GenesisOptionFlag)) != 0)
+    return(MagickFalse);
+  return(MagickTrue);
+}
+
+static MagickBooleanType SubstituteServerDescriptor(char **argument,
+  const int *descriptors,const size_t number_descriptors,
+  const MagickBooleanType output)
+{
+  char
+    *p,
+    substitute[MagickPathExtent];
+
+  size_t
+    extent,
+    offset;
+
+  /*
+    Map "fd:N" and "-" to the descriptors passed by the client; any other
+    descriptor would be one of the server's own.
+  */
+  p=(*argument);
+  extent=strlen(p);
+  if ((extent > 0) && (p[extent-1] == '-') && ((extent == 1) ||
+      (p[extent-2] == ':')))
+    {
+      offset=output != MagickFalse ? 1 : 0;
+      if (offset >= number_descriptors)
+        return(MagickFalse);
+      (void) FormatLocaleString(substitute,MagickPathExtent,"%.*sfd:%d",
+        (int) (extent-1),p,descriptors[offset]);
+      (void) CloneString(argument,substitute);
+      return(MagickTrue);
+    }
+  for (p=strstr(p,"fd:"); p != (char *) NULL; p=strstr(p+1,"fd:"))
+  {
+    char
+      *q;
+
+    if ((p != *argument) && (*(p-1) != ':'))
+      continue;
+    offset=(size_t) strtoul(p+3,&q,10);
+    if ((q == (p+3)) || (*q != '\0') || (offset >= number_descriptors))
+      return(MagickFalse);
+    (void) FormatLocaleString(substitute,MagickPathExtent,"%.*sfd:%d",
+      (int) (p-(*argument)),*argument,descriptors[offset]);
+    (void) CloneString(argument,substitute);
+    return(MagickTrue);
+  }
+  return(MagickTrue);
+}
+
+static void ServeMagickRequest(const ImageInfo *image_info,const int client)
+{
+  char
+    **argv,
+    control[CMSG_SPACE(MagickServerDescriptors*sizeof(int))],
+    reply[MagickPathExtent],
+    *request;
+
+  double
+    elapsed_time;
+
+  ExceptionInfo
+    *exception;
+
+  int
+    argc,
+    descriptors[MagickServerDescriptors],
+    i;
+
+  MagickBooleanType
+    status;
+
+  size_t
+    length,
+    number_descriptors;
+
+  ssize_t
+    count;
+
+  struct cmsghdr
+    *header;
+
+  struct iovec
+    vector;
+
+  struct msghdr
+    message;
+
+  TimerInfo
+    *timer;
+
+  request=(char *) AcquireQuantumMemory(MagickServerRequestExtent,
+    sizeof(*request));
+  if (request == (char *) NULL)
+    return;
+  timer=AcquireTimerInfo();
+  /*
+    Receive the command line and the client's file descriptors.
+  */
+  (void) memset(&message,0,sizeof(message));
+  vector.iov_base=request;
+  vector.iov_len=MagickServerRequestExtent-1;
+  message.msg_iov=(&vector);
+  message.msg_iovlen=1;
+  message.msg_control=control;
+  message.msg_controllen=sizeof(control);
+  count=recvmsg(client,&message,0);
+  number_descriptors=0;
+  for (header=CMSG_FIRSTHDR(&message); header != (struct cmsghdr *) NULL;
+       header=CMSG_NXTHDR(&message,header))
+    if ((header->cmsg_level == SOL_SOCKET) &&
+        (header->cmsg_type == SCM_RIGHTS))
+      {
+        size_t
+          number_passed;
+
+        number_passed=(header->cmsg_len-CMSG_LEN(0))/sizeof(int);
+        for (i=0; i < (int) number_passed; i++)
+        {
+          int
+            file;
+
+          (void) memcpy(&file,CMSG_DATA(header)+i*sizeof(int),sizeof(file));
+          if (number_descriptors < MagickServerDescriptors)
+            descriptors[number_descriptors++]=file;
+          else
+            (void) close(file);
+        }
+      }
+  length=count > 0 ? (size_t) count : 0;
+  request[length]='\0';
+  while ((count > 0) && (strchr(request,'\n') == (char *) NULL) &&
+         (length < (MagickServerRequestExtent-1)))
+  {
+    count=read(client,request+length,MagickServerRequestExtent-length-1);
+    if ((count < 0) && (errno == EINTR))
+      continue;
+    if (count > 0)
+      length+=(size_t) count;
+    request[length]='\0';
+  }
+  if (strchr(request,'\n') != (char *) NULL)
+    *strchr(request,'\n')='\0';
+  /*
+    Run the request.
+  */
+  exception=AcquireExceptionInfo();
+  argv=AcquireJobArguments(request,&argc);
+  status=MagickFalse;
+  if (argc < 3)
+    (void) ThrowMagickException(exception,GetMagickModule(),OptionError,
+      "InvalidArgument","`%s'",request);
+  else
+    {
+      status=MagickTrue;
+      for (i=1; i < argc; i++)
+      {
+        if (IsServerOptionAuthorized(argv[i]) == MagickFalse)
+          {
+            (void) ThrowMagickException(exception,GetMagickModule(),
+              PolicyError,"NotAuthorized","`%s'",argv[i]);
+            status=MagickFalse;
+            break;
+          }
+        if (SubstituteServerDescriptor(&argv[i],descriptors,
+              number_descriptors,i == (argc-1) ? MagickTrue : MagickFalse) ==
+            MagickFalse)
+          {
+            (void) ThrowMagickException(exception,GetMagickModule(),
+              OptionError,"InvalidArgument","`%s'",argv[i]);
+            status=MagickFalse;
+            break;
+          }
+      }
+      if (status != MagickFalse)
+        status=ExecuteMagickJob(image_info,argc,argv,exception);
+    }
+  argv=DestroyJobArguments(argv,argc);
+  for (i=0; i < (int) number_descriptors; i++)
+    (void) close(descriptors[i]);
+  elapsed_time=GetElapsedTime(timer);
+  /*
+    Reply with the exit status, timing, and any exception.
+  */
+  (void) FormatLocaleString(reply,MagickPathExtent,"%d\t%.6f\t%s%s%s%s\n",
+    status != MagickFalse ? 0 : 1,elapsed_time,exception->reason != (char *)
+    NULL ? exception->reason : "",exception->description != (char *) NULL ?
+    " (" : "",exception->description != (char *) NULL ?
+    exception->description : "",exception->description != (char *) NULL ?
+    ")" : "");
+  (void) send(client,reply,strlen(reply),MSG_NOSIGNAL);
+  (void) FormatLocaleFile(stderr,"%d\t%.6f\t%s\n",status != MagickFalse ? 0 :
+    1,elapsed_time,request);
+  exception=DestroyExceptionInfo(exception);
+  timer=DestroyTimerInfo(timer);
+  request=DestroyString(request);
+}
+
+static void *ServeMagickClients(void *context)
+{
+  ServerInfo
+    *server_info;
+
+  server_info=(ServerInfo *) context;
+  for ( ; ; )
+  {
+    int
+      client;
+
+    struct pollfd
+      events[2];
+
+    /*
+      Wait for a connection or for the stop pipe to become readable.  The
+      socket does not block, so a worker that loses the race for a
+      connection goes back to waiting.
+    */
+    events[0].fd=server_info->socket;
+    events[0].events=POLLIN;
+    events[0].revents=0;
+    events[1].fd=server_info->stop;
+    events[1].events=POLLIN;
+    events[1].revents=0;
+    if (poll(events,2,-1) == -1)
+      {
+        if (errno == EINTR)
+          continue;
+        break;
+      }
+    if ((events[1].revents != 0) || ((events[0].revents & POLLIN) == 0))
+      break;
+    client=accept(server_info->socket,(struct sockaddr *) NULL,
+      (socklen_t *) NULL);
+    if (client == -1)
+      {
+        if ((errno == EINTR) || (errno == ECONNABORTED) ||
+            (errno == EAGAIN) || (errno == EWOULDBLOCK))
+          continue;
+        break;
+      }
+    (void) fcntl(client,F_SETFL,fcntl(client,F_GETFL) & ~O_NONBLOCK);
+    ServeMagickRequest(server_info->image_info,client);
+    (void) close(client);
+  }
+  return((void *) NULL);
+}
+
+static MagickBooleanType SetServerAddress(const char *path,
+  struct sockaddr_un *address,ExceptionInfo *exception)
+{
+  (void) memset(address,0,sizeof(*address));
+  address->sun_family=AF_UNIX;
+  if (CopyMagickString(address->sun_path,path,sizeof(address->sun_path)) >=
+      sizeof(address->sun_path))
+    {
+      (void) ThrowMagickException(exception,GetMagickModule(),OptionError,
+        "InvalidArgument","`%s'",path);
+      return(MagickFalse);
+    }
+  return(MagickTrue);
+}
+
+static MagickBooleanType ProcessServerRequests(const ImageInfo *image_info,
+  const char *path,ExceptionInfo *exception)
+{
+  int
+    signal_number,
+    stop[2];
+
+  pthread_t
+    *threads;
+
+  ServerInfo
+    server_info;
+
+  sigset_t
+    mask,
+    previous_mask;
+
+  size_t
+    number_workers;
+
+  ssize_t
+    i;
+
+  struct sockaddr_un
+    address;
+
+  struct stat
+    attributes;
+
+  if (SetServerAddress(path,&address,exception) == MagickFalse)
+    return(MagickFalse);
+  if ((GetPathAttributes(path,&attributes) != MagickFalse) &&
+      (S_ISSOCK(attributes.st_mode) != 0))
+    (void) remove_utf8(path);
+  server_info.image_info=image_info;
+  server_info.socket=socket(AF_UNIX,SOCK_STREAM,0);
+  if (server_info.socket == -1)
+    {
+      ThrowFileException(exception,FileOpenError,"UnableToOpenFile",path);
+      return(MagickFalse);
+    }
+  if ((bind(server_info.socket,(struct sockaddr *) &address,
+       sizeof(address)) == -1) || (chmod(path,S_IRUSR | S_IWUSR) == -1) ||
+      (listen(server_info.socket,MagickServerPendingConnections) == -1) ||
+      (fcntl(server_info.socket,F_SETFL,fcntl(server_info.socket,F_GETFL) |
+       O_NONBLOCK) == -1) || (pipe(stop) == -1))
+    {
+      ThrowFileException(exception,FileOpenError,"UnableToOpenFile",path);
+      (void) close(server_info.socket);
+      return(MagickFalse);
+    }
+  server_info.stop=stop[0];
+  (void) signal(SIGPIPE,SIG_IGN);
+  number_workers=SetJobConcurrency((size_t) MagickResourceInfinity);
+  threads=(pthread_t *) AcquireQuantumMemory(number_workers,sizeof(*threads));
+  if (threads == (pthread_t *) NULL)
+    {
+      (void) close(stop[0]);
+      (void) close(stop[1]);
+      (void) close(server_info.socket);
+      ThrowWandFatalException(ResourceLimitFatalError,
+        "MemoryAllocationFailed",path);
+    }
+  /*
+    The workers inherit a mask that blocks the termination signals, so only
+    the sigwait() below sees them.  On SIGINT, SIGTERM, or SIGHUP a byte
+    written to the stop pipe wakes every idle worker from poll(); a worker
+    running a request finishes it and its reply first.
+  */
+  (void) sigemptyset(&mask);
+  (void) sigaddset(&mask,SIGHUP);
+  (void) sigaddset(&mask,SIGINT);
+  (void) sigaddset(&mask,SIGTERM);
+  (void) pthread_sigmask(SIG_BLOCK,&mask,&previous_mask);
+  for (i=0; i < (ssize_t) number_workers; i++)
+    if (pthread_create(&threads[i],(pthread_attr_t *) NULL,ServeMagickClients,
+        &server_info) != 0)
+      break;
+  number_workers=(size_t) i;
+  if (number_workers != 0)
+    while (sigwait(&mask,&signal_number) != 0) ;
+  while ((write(stop[1],"",1) == -1) && (errno == EINTR)) ;
+  for (i=0; i < (ssize_t) number_workers; i++)
+    (void) pthread_join(threads[i],(void **) NULL);
+  (void) close(stop[0]);
+  (void) close(stop[1]);
+  (void) pthread_sigmask(SIG_SETMASK,&previous_mask,(sigset_t *) NULL);
+  threads=(pthread_t *) RelinquishMagickMemory(threads);
+  (void) close(server_info.socket);
+  (void) remove_utf8(path);
+  return(MagickTrue);
+}
+
+static MagickBooleanType ProcessClientRequest(int argc,char **argv,
+  ExceptionInfo *exception)
+{
+  char
+    control[CMSG_SPACE(3*sizeof(int))],
+    reply[MagickPathExtent],
+    *request;
+
+  int
+    client,
+    descriptors[3] = { 0, 1, 2 },
+    exit_status;
+
+  size_t
+    length;
+
+  ssize_t
+    count,
+    i;
+
+  struct cmsghdr
+    *header;
+
+  struct iovec
+    vector;
+
+  struct msghdr
+    message;
+
+  struct sockaddr_un
+    address;
+
+  if (SetServerAddress(argv[2],&address,exception) == MagickFalse)
+    return(MagickFalse);
+  /*
+    Quote the command line, passing standard input, output, and error.
+  */
+  request=AcquireString("");
+  for (i=3; i < (ssize_t) argc; i++)
+  {
+    const char
+      *quote;
+
+    quote=strchr(argv[i],'"') != (char *) NULL ? "'" : "\"";
+    if (i > 3)
+      (void) ConcatenateString(&request," ");
+    (void) ConcatenateString(&request,quote);
+    (void) ConcatenateString(&request,argv[i]);
+    (void) ConcatenateString(&request,quote);
+  }
+  (void) ConcatenateString(&request,"\n");
+  client=socket(AF_UNIX,SOCK_STREAM,0);
+  if ((client == -1) || (connect(client,(struct sockaddr *) &address,
+       sizeof(address)) == -1))
+    {
+      ThrowFileException(exception,FileOpenError,"UnableToOpenFile",argv[2]);
+      if (client != -1)
+        (void) close(client);
+      request=DestroyString(request);
+      return(MagickFalse);
+    }
+  (void) memset(&message,0,sizeof(message));
+  (void) memset(control,0,sizeof(control));
+  vector.iov_base=request;
+  vector.iov_len=strlen(request);
+  message.msg_iov=(&vector);
+  message.msg_iovlen=1;
+  message.msg_control=control;
+  message.msg_controllen=sizeof(control);
+  header=CMSG_FIRSTHDR(&message);
+  header->cmsg_level=SOL_SOCKET;
+  header->cmsg_type=SCM_RIGHTS;
+  header->cmsg_len=CMSG_LEN(sizeof(descriptors));
+  (void) memcpy(CMSG_DATA(header),descriptors,sizeof(descriptors));
+  count=sendmsg(client,&message,MSG_NOSIGNAL);
+  for (length=count > 0 ? (size_t) count : 0; (count > 0) &&
+       (length < strlen(request)); length+=(size_t) count)
+    count=send(client,request+length,strlen(request)-length,MSG_NOSIGNAL);
+  request=DestroyString(request);
+  /*
+    Wait for the reply.
+  */
+  length=0;
+  do
+  {
+    count=read(client,reply+length,MagickPathExtent-length-1);
+    if ((count < 0) && (errno == EINTR))
+      continue;
+    if (count > 0)
+      length+=(size_t) count;
+  } while ((count > 0) && (length < (MagickPathExtent-1)));
+  (void) close(client);
+  reply[length]='\0';
+  if (length == 0)
+    {
+      ThrowFileException(exception,FileOpenError,"UnableToReadBlob",argv[2]);
+      return(MagickFalse);
+    }
+  if (strchr(reply,'\n') != (char *) NULL)
+    *strchr(reply,'\n')='\0';
+  exit_status=(int) strtol(reply,(char **) NULL,10);
+  if (exit_status != 0)
+    {
+      const char
+        *reason;
+
+      reason=strchr(reply,'\t');
+      if (reason != (const char *) NULL)
+        reason=strchr(reason+1,'\t');
+      (void) ThrowMagickException(exception,GetMagickModule(),OptionError,
+        "ServerRequestFailed","`%s'",reason != (const char *) NULL ?
+        reason+1 : reply);
+      return(MagickFalse);
+    }
+  return(MagickTrue);
+}
+#endif
+
 WandExport MagickBooleanType MagickImageCommand(ImageInfo *image_info,int argc,
   char **argv,char **metadata,ExceptionInfo *exception)
 {
@@ -1307,7 +2126,8 @@ WandExport MagickBooleanType MagickImageCommand(ImageInfo *image_info,int argc,
 
 
   GetPathComponent(argv[0],TailPath,cli_wand->wand.name);
-  (void) SetClientName(cli_wand->wand.name);
+  if (strcmp(GetClientName(),cli_wand->wand.name) != 0)
+    (void) SetClientName(cli_wand->wand.name);
   (void) ConcatenateMagickString(cli_wand->wand.name,"-CLI",MagickPathExtent);
 
   len=strlen(argv[0]);  /* precaution */
@@ -1370,6 +2190,34 @@ WandExport MagickBooleanType MagickImageCommand(ImageInfo *image_info,int argc,
     goto Magick_Command_Exit;
   }
 
+  /* Special "batch" option to run many independent command lines */
+  if (LocaleCompare("-batch",argv[1]) == 0) {
+    if (cli_wand->wand.debug != MagickFalse)
+        (void) CLILogEvent(cli_wand,CommandEvent,GetMagickModule(),
+            "- Special Option \"%s\"", argv[1]);
+    (void) ProcessBatchJobs(image_info,argc,argv,exception);
+    goto Magick_Command_Exit;
+  }
+
+  /* Special "server" and "client" options to run command lines remotely */
+  if ((LocaleCompare("-server",argv[1]) == 0) ||
+      (LocaleCompare("-client",argv[1]) == 0)) {
+    if (cli_wand->wand.debug != MagickFalse)
+        (void) CLILogEvent(cli_wand,CommandEvent,GetMagickModule(),
+            "- Special Option \"%s\"", argv[1]);
+#if defined(MAGICKCORE_HAVE_CLI_SERVER)
+    if (LocaleCompare("-server",argv[1]) == 0)
+      (void) ProcessServerRequests(image_info,argv[2],exception);
+    else
+      (void) ProcessClientRequest(argc,argv,exception);
+#else
+    (void) ThrowMagickException(exception,GetMagickModule(),
+      MissingDelegateError,"DelegateLibrarySupportNotBuiltIn","`%s' (sockets)",
+      argv[1]);
+#endif
+    goto Magick_Command_Exit;
+  }
+
   /* List Information and Abort */
   if (argc == 3 && LocaleCompare("-list",argv[1]) == 0) {
     CLIOption(cli_wand, argv[1], argv[2]);
@@ -3810,6 +3810,163 @@ static MagickBooleanType CLISimpleOperatorImages(MagickCLI *cli_wand,
 %                                                                             %
 %                                                                             %
 %                                                                             %
++     C L I P o i n t O p e r a t o r s                                       %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  CLIQueuePointOperator() defers a point operator (one whose result for a
+%  pixel depends only on that pixel) when the "cli:pipeline" define is set,
+%  returning MagickTrue if the operator was queued.  CLIApplyPointOperators()
+%  then applies the whole run of queued operators to each image in a single
+%  pass, rather than one pass over every image per operator.  The result is
+%  identical to applying the operators one at a time.
+%
+%  Only -evaluate (with a non-random operator) and -gamma are queued, and only
+%  when their arguments carry no percent escapes.  Any other option applies
+%  the queue before it is processed, so settings such as -channel and -define
+%  always see the images as if every operator had run in turn.
+%
+%  The format of the CLIQueuePointOperator method is:
+%
+%    MagickBooleanType CLIQueuePointOperator(MagickCLI *cli_wand,
+%      const char *option,const char *arg1,const char *arg2)
+%    void CLIApplyPointOperators(MagickCLI *cli_wand)
+%
+%  A description of each parameter follows:
+%
+%    o cli_wand: structure holding settings to be applied
+%
+%    o option:  The option string for the operation
+%
+%    o arg1, arg2: optional argument strings to the operation
+%
+*/
+
+static void CLIApplyPointOperators(MagickCLI *cli_wand)
+{
+  CLIPointOperators
+    *point_operators;
+
+  Image
+    *image;
+
+  ssize_t
+    i;
+
+  point_operators=(&cli_wand->point_operators);
+  if (point_operators->number_operators == 0)
+    return;
+  if (cli_wand->wand.debug != MagickFalse)
+    (void) CLILogEvent(cli_wand,CommandEvent,GetMagickModule(),
+      "- Point Operators: %.20g fused",(double)
+      point_operators->number_operators);
+  /*
+    Sync settings as the unfused operators would, e.g. "evaluate:clamp".
+  */
+  (void) SyncImagesSettings(cli_wand->wand.image_info,cli_wand->wand.images,
+    cli_wand->wand.exception);
+  for (image=GetFirstImageInList(cli_wand->wand.images);
+       image != (Image *) NULL; image=GetNextImageInList(image))
+  {
+    (void) EvaluateImageOperators(image,point_operators->number_operators,
+      point_operators->operators,point_operators->values,
+      cli_wand->wand.exception);
+    for (i=0; i < (ssize_t) point_operators->number_operators; i++)
+      image->gamma*=point_operators->gamma[i];
+  }
+  point_operators->number_operators=0;
+}
+
+static inline MagickBooleanType IsPointOperatorArgument(const char *arg)
+{
+  const char
+    *p;
+
+  /*
+    A trailing percent is a value, any other is a percent escape.
+  */
+  if (IsGeometry(arg) == MagickFalse)
+    return(MagickFalse);
+  p=strchr(arg,'%');
+  if ((p != (const char *) NULL) && (*(p+1) != '\0'))
+    return(MagickFalse);
+  return(MagickTrue);
+}
+
+static MagickBooleanType CLIQueuePointOperator(MagickCLI *cli_wand,
+  const char *option,const char *arg1,const char *arg2)
+{
+  CLIPointOperators
+    *point_operators;
+
+  double
+    gamma,
+    value;
+
+  MagickEvaluateOperator
+    op;
+
+  ssize_t
+    parse;
+
+  if (cli_wand->wand.images == (Image *) NULL)
+    return(MagickFalse);
+  if (IsStringTrue(GetImageOption(cli_wand->wand.image_info,"cli:pipeline"))
+      == MagickFalse)
+    return(MagickFalse);
+  if (LocaleCompare("evaluate",option+1) == 0)
+    {
+      parse=ParseCommandOption(MagickEvaluateOptions,MagickFalse,arg1);
+      if (parse < 0)
+        return(MagickFalse);
+      op=(MagickEvaluateOperator) parse;
+      switch (op)
+      {
+        case GaussianNoiseEvaluateOperator:
+        case ImpulseNoiseEvaluateOperator:
+        case LaplacianNoiseEvaluateOperator:
+        case MultiplicativeNoiseEvaluateOperator:
+        case PoissonNoiseEvaluateOperator:
+        case UniformNoiseEvaluateOperator:
+          return(MagickFalse);
+        default:
+          break;
+      }
+      if (IsPointOperatorArgument(arg2) == MagickFalse)
+        return(MagickFalse);
+      value=StringToDoubleInterval(arg2,(double) QuantumRange+1.0);
+      gamma=1.0;
+    }
+  else
+    if (LocaleCompare("gamma",option+1) == 0)
+      {
+        if (IsPointOperatorArgument(arg1) == MagickFalse)
+          return(MagickFalse);
+        op=PowEvaluateOperator;
+        value=StringToDouble(arg1,(char **) NULL);
+        if (*option == '-')
+          value=PerceptibleReciprocal(value);
+        gamma=StringToDouble(arg1,(char **) NULL);
+      }
+    else
+      return(MagickFalse);
+  point_operators=(&cli_wand->point_operators);
+  if (point_operators->number_operators >= MaxCLIPointOperators)
+    CLIApplyPointOperators(cli_wand);
+  point_operators->operators[point_operators->number_operators]=op;
+  point_operators->values[point_operators->number_operators]=value;
+  point_operators->gamma[point_operators->number_operators]=gamma;
+  point_operators->number_operators++;
+  return(MagickTrue);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
 +     C L I L i s t O p e r a t o r I m a g e s                               %
 %                                                                             %
 %                                                                             %
@@ -5451,6 +5608,14 @@ WandExport void CLIOption(MagickCLI *cli_wand,const char *option,...)
 #endif
     }
 
+    /*
+      Defer point operators for a fused pass (see "cli:pipeline"), otherwise
+      apply any that are pending before this option is handled.
+    */
+    if (CLIQueuePointOperator(cli_wand,option,arg1,arg2) != MagickFalse)
+      break;
+    CLIApplyPointOperators(cli_wand);
+
     /*
       Call the appropriate option handler
     */
@@ -104,15 +104,19 @@ static MagickBooleanType StreamUsage(void)
       "  -density geometry    horizontal and vertical density of the image\n"
       "  -depth value         image depth\n"
       "  -extract geometry    extract area from image\n"
+      "  -gamma value         level of gamma correction\n"
       "  -identify            identify the format and characteristics of the image\n"
       "  -interlace type      type of image interlacing scheme\n"
       "  -interpolate method  pixel color interpolation method\n"
+      "  -level value         adjust the level of image contrast\n"
       "  -limit type value    pixel cache resource limit\n"
       "  -map components      one or more pixel components\n"
       "  -monitor             monitor progress\n"
+      "  -negate              replace every pixel with its complementary color\n"
       "  -quantize colorspace reduce colors in this colorspace\n"
       "  -quiet               suppress all warning messages\n"
       "  -regard-warnings     pay attention to warning messages\n"
+      "  -resize geometry     resize the image\n"
       "  -respect-parentheses settings remain in effect until parenthesis boundary\n"
       "  -sampling-factor geometry\n"
       "                       horizontal and vertical sampling factor\n"
@@ -278,6 +282,9 @@ WandExport MagickBooleanType StreamImageCommand(ImageInfo *image_info,
       }
     if (IsCommandOption(option) == MagickFalse)
       {
+        const char
+          *value;
+
         Image
           *images;
 
@@ -289,6 +296,19 @@ WandExport MagickBooleanType StreamImageCommand(ImageInfo *image_info,
         if ((LocaleCompare(filename,"--") == 0) && (i < (ssize_t) (argc-1)))
           filename=argv[++i];
         (void) CopyMagickString(image_info->filename,filename,MagickPathExtent);
+        value=GetImageOption(image_info,"stream:colorspace");
+        if (value != (const char *) NULL)
+          {
+            ssize_t
+              colorspace;
+
+            colorspace=ParseCommandOption(MagickColorspaceOptions,MagickFalse,
+              value);
+            if (colorspace < 0)
+              ThrowStreamException(OptionError,"UnrecognizedColorspace",
+                value);
+            SetStreamInfoColorspace(stream_info,(ColorspaceType) colorspace);
+          }
         images=StreamImage(image_info,stream_info,exception);
         status&=(MagickStatusType) (images != (Image *) NULL) &&
           (exception->severity < ErrorException);
@@ -465,6 +485,24 @@ WandExport MagickBooleanType StreamImageCommand(ImageInfo *image_info,
           }
         ThrowStreamException(OptionError,"UnrecognizedOption",option)
       }
+      case 'g':
+      {
+        if (LocaleCompare("gamma",option+1) == 0)
+          {
+            if (*option == '+')
+              ThrowStreamException(OptionError,"UnrecognizedOption",option);
+            i++;
+            if (i == (ssize_t) argc)
+              ThrowStreamException(OptionError,"MissingArgument",option);
+            if (IsGeometry(argv[i]) == MagickFalse)
+              ThrowStreamInvalidArgumentException(option,argv[i]);
+            if (SetStreamInfoLevel(stream_info,0.0,(double) QuantumRange,
+                 StringToDouble(argv[i],(char **) NULL)) == MagickFalse)
+              ThrowStreamInvalidArgumentException(option,argv[i]);
+            break;
+          }
+        ThrowStreamException(OptionError,"UnrecognizedOption",option)
+      }
       case 'h':
       {
         if ((LocaleCompare("help",option+1) == 0) ||
@@ -517,6 +555,46 @@ WandExport MagickBooleanType StreamImageCommand(ImageInfo *image_info,
       }
       case 'l':
       {
+        if (LocaleCompare("level",option+1) == 0)
+          {
+            double
+              black_point,
+              gamma,
+              white_point;
+
+            GeometryInfo
+              geometry_info;
+
+            MagickStatusType
+              flags;
+
+            if (*option == '+')
+              ThrowStreamException(OptionError,"UnrecognizedOption",option);
+            i++;
+            if (i == (ssize_t) argc)
+              ThrowStreamException(OptionError,"MissingArgument",option);
+            if (IsGeometry(argv[i]) == MagickFalse)
+              ThrowStreamInvalidArgumentException(option,argv[i]);
+            flags=ParseGeometry(argv[i],&geometry_info);
+            black_point=geometry_info.rho;
+            white_point=(double) QuantumRange;
+            if ((flags & SigmaValue) != 0)
+              white_point=geometry_info.sigma;
+            gamma=1.0;
+            if ((flags & XiValue) != 0)
+              gamma=geometry_info.xi;
+            if ((flags & PercentValue) != 0)
+              {
+                black_point*=(double) QuantumRange/100.0;
+                white_point*=(double) QuantumRange/100.0;
+              }
+            if ((flags & SigmaValue) == 0)
+              white_point=(double) QuantumRange-black_point;
+            if (SetStreamInfoLevel(stream_info,black_point,white_point,
+                 gamma) == MagickFalse)
+              ThrowStreamInvalidArgumentException(option,argv[i]);
+            break;
+          }
         if (LocaleCompare("limit",option+1) == 0)
           {
             char
@@ -591,6 +669,19 @@ WandExport MagickBooleanType StreamImageCommand(ImageInfo *image_info,
           break;
         ThrowStreamException(OptionError,"UnrecognizedOption",option)
       }
+      case 'n':
+      {
+        if (LocaleCompare("negate",option+1) == 0)
+          {
+            if (*option == '+')
+              ThrowStreamException(OptionError,"UnrecognizedOption",option);
+            if (SetStreamInfoLevel(stream_info,(double) QuantumRange,0.0,
+                 1.0) == MagickFalse)
+              ThrowStreamException(OptionError,"UnrecognizedOption",option);
+            break;
+          }
+        ThrowStreamException(OptionError,"UnrecognizedOption",option)
+      }
       case 'q':
       {
         if (LocaleCompare("quantize",option+1) == 0)
@@ -618,6 +709,18 @@ WandExport MagickBooleanType StreamImageCommand(ImageInfo *image_info,
       {
         if (LocaleCompare("regard-warnings",option+1) == 0)
           break;
+        if (LocaleCompare("resize",option+1) == 0)
+          {
+            if (*option == '+')
+              ThrowStreamException(OptionError,"UnrecognizedOption",option);
+            i++;
+            if (i == (ssize_t) argc)
+              ThrowStreamException(OptionError,"MissingArgument",option);
+            if (IsGeometry(argv[i]) == MagickFalse)
+              ThrowStreamInvalidArgumentException(option,argv[i]);
+            SetStreamInfoResize(stream_info,argv[i]);
+            break;
+          }
         if (LocaleNCompare("respect-parentheses",option+1,17) == 0)
           {
             respect_parentheses=(*option == '-') ? MagickTrue : MagickFalse;
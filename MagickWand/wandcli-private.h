@@ -93,6 +93,26 @@ typedef struct _CLIStack
   void           *data;
 } CLIStack;
 
+/* Point operators deferred by the opt-in "cli:pipeline" define.  Runs of
+   these are applied to each image in a single fused pass when the next
+   operator that is not a point operator (or a setting, read or write) is
+   reached.
+*/
+#define MaxCLIPointOperators  32
+
+typedef struct _CLIPointOperators
+{
+  size_t
+    number_operators;
+
+  MagickEvaluateOperator
+    operators[MaxCLIPointOperators];
+
+  double
+    values[MaxCLIPointOperators],
+    gamma[MaxCLIPointOperators];  /* image gamma scaling, 1.0 if none */
+} CLIPointOperators;
+
 /* Note this defines an extension to the normal MagickWand
    Which adds extra elements specific to the Shell API interface
    while still allowing the Wand to be passed to MagickWand API
@@ -119,6 +139,9 @@ struct _MagickCLI       /* CLI interface version of MagickWand */
     *image_list_stack,  /* Stacks of Image Lists and Image Info settings */
     *image_info_stack;
 
+  CLIPointOperators
+    point_operators;    /* Deferred point operators awaiting a fused pass */
+
   const char            /* Location of option being processed for exception */
     *location,          /* location format string for exception reports */
     *filename;          /* "CLI", "unknown", or the script filename */
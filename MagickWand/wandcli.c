@@ -100,6 +100,7 @@ WandExport MagickCLI *AcquireMagickCLI(ImageInfo *image_info,
   cli_wand->command=(const OptionInfo *) NULL;     /* no option at this time */
   cli_wand->image_list_stack=(CLIStack *) NULL;
   cli_wand->image_info_stack=(CLIStack *) NULL;
+  cli_wand->point_operators.number_operators=0;
 
   /* default exception location...
      EG: sprintf(location, filename, line, column);
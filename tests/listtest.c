@@ -0,0 +1,452 @@
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%                         L      IIIII  SSSSS  TTTTT                          %
+%                         L        I    SS       T                            %
+%                         L        I     SSS     T                            %
+%                         L        I       SS    T                            %
+%                         LLLLL  IIIII  SSSSS    T                            %
+%                                                                             %
+%                         TTTTT  EEEEE  SSSSS  TTTTT                          %
+%                           T    E      SS       T                            %
+%                           T    EEE     SSS     T                            %
+%                           T    E         SS    T                            %
+%                           T    EEEEE  SSSSS    T                            %
+%                                                                             %
+%                                                                             %
+%                       MagickCore Image List Tests                           %
+%                                                                             %
+%                              Software Design                                %
+%                                   Cristy                                    %
+%                                October 2026                                 %
+%                                                                             %
+%                                                                             %
+%  Copyright 1999 ImageMagick Studio LLC, a non-profit organization           %
+%  dedicated to making software imaging solutions freely available.           %
+%                                                                             %
+%  You may not use this file except in compliance with the License.  You may  %
+%  obtain a copy of the License at                                            %
+%                                                                             %
+%    https://imagemagick.org/script/license.php                               %
+%                                                                             %
+%  Unless required by applicable law or agreed to in writing, software        %
+%  distributed under the License is distributed on an "AS IS" BASIS,          %
+%  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   %
+%  See the License for the specific language governing permissions and        %
+%  limitations under the License.                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  Long image lists answer index and length queries from a position index.
+%  Each test below changes a list with one of the list methods, mirroring the
+%  expected scene order in an array, and checks every accessor against it.
+%
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MagickCore/MagickCore.h>
+
+#define MaxListLength  1024
+
+typedef struct _ListInfo
+{
+  ssize_t
+    scenes[MaxListLength];
+
+  size_t
+    length;
+} ListInfo;
+
+static Image *NewListImage(const ImageInfo *image_info,const size_t scene,
+  ExceptionInfo *exception)
+{
+  Image
+    *image;
+
+  image=AcquireImage(image_info,exception);
+  image->scene=scene;
+  return(image);
+}
+
+static Image *NewImageSequence(const ImageInfo *image_info,ListInfo *list,
+  const size_t first,const size_t length,ExceptionInfo *exception)
+{
+  Image
+    *images;
+
+  size_t
+    i;
+
+  images=NewImageList();
+  list->length=0;
+  for (i=0; i < length; i++)
+  {
+    AppendImageToList(&images,NewListImage(image_info,first+i,exception));
+    list->scenes[list->length++]=(ssize_t) (first+i);
+  }
+  return(images);
+}
+
+static void DeleteScenes(ListInfo *list,const size_t offset,
+  const size_t length)
+{
+  (void) memmove(list->scenes+offset,list->scenes+offset+length,
+    (list->length-offset-length)*sizeof(*list->scenes));
+  list->length-=length;
+}
+
+static void InsertScenes(ListInfo *list,const size_t offset,
+  const ListInfo *insert)
+{
+  (void) memmove(list->scenes+offset+insert->length,list->scenes+offset,
+    (list->length-offset)*sizeof(*list->scenes));
+  (void) memcpy(list->scenes+offset,insert->scenes,insert->length*
+    sizeof(*list->scenes));
+  list->length+=insert->length;
+}
+
+static MagickBooleanType ValidateImageList(const char *operation,
+  const Image *images,const ListInfo *list)
+{
+  const Image
+    *head,
+    *p,
+    *tail;
+
+  size_t
+    i,
+    length;
+
+  /*
+    Walk the links for the truth, then check every accessor against it.
+  */
+  if (images == (const Image *) NULL)
+    return(list->length == 0 ? MagickTrue : MagickFalse);
+  for (head=images; head->previous != (Image *) NULL; head=head->previous) ;
+  length=0;
+  for (tail=head; tail->next != (Image *) NULL; tail=tail->next)
+    length++;
+  length++;
+  if (length != list->length)
+    {
+      (void) fprintf(stderr,"%s: list has %g images, expected %g\n",
+        operation,(double) length,(double) list->length);
+      return(MagickFalse);
+    }
+  for (i=0, p=head; p != (const Image *) NULL; i++, p=p->next)
+  {
+    if (((ssize_t) p->scene != list->scenes[i]) ||
+        (GetImageIndexInList(p) != (ssize_t) i) ||
+        (GetImageListLength(p) != length) ||
+        (GetImageFromList(images,(ssize_t) i) != p) ||
+        (GetImageFromList(p,(ssize_t) i-(ssize_t) length) != p) ||
+        (GetFirstImageInList(p) != head) || (GetLastImageInList(p) != tail))
+      {
+        (void) fprintf(stderr,"%s: image %g (scene %g) disagrees: index %g, "
+          "length %g\n",operation,(double) i,(double) p->scene,(double)
+          GetImageIndexInList(p),(double) GetImageListLength(p));
+        return(MagickFalse);
+      }
+  }
+  if ((GetImageFromList(images,(ssize_t) length) != (Image *) NULL) ||
+      (GetImageFromList(images,-(ssize_t) length-1) != (Image *) NULL))
+    {
+      (void) fprintf(stderr,"%s: index past the list returns an image\n",
+        operation);
+      return(MagickFalse);
+    }
+  return(MagickTrue);
+}
+
+static MagickBooleanType TestAppend(const ImageInfo *image_info,
+  ExceptionInfo *exception)
+{
+  Image
+    *images,
+    *p;
+
+  ListInfo
+    list;
+
+  MagickBooleanType
+    status;
+
+  size_t
+    i;
+
+  /*
+    Grow the list one image at a time, through the list methods and by
+    linking behind the tail directly as AcquireNextImage does.
+  */
+  images=NewImageList();
+  list.length=0;
+  status=MagickTrue;
+  for (i=0; (i < 300) && (status != MagickFalse); i++)
+  {
+    if ((i % 3) == 2)
+      {
+        p=GetLastImageInList(images);
+        AcquireNextImage(image_info,p,exception);
+        p->next->scene=i;
+      }
+    else
+      if ((i % 3) == 1)
+        PrependImageToList(&images,NewListImage(image_info,i,exception));
+      else
+        AppendImageToList(&images,NewListImage(image_info,i,exception));
+    if ((i % 3) == 1)
+      {
+        (void) memmove(list.scenes+1,list.scenes,list.length*
+          sizeof(*list.scenes));
+        list.scenes[0]=(ssize_t) i;
+        list.length++;
+        images=GetFirstImageInList(images);
+      }
+    else
+      list.scenes[list.length++]=(ssize_t) i;
+    status=ValidateImageList("append",images,&list);
+  }
+  images=DestroyImageList(images);
+  return(status);
+}
+
+static MagickBooleanType TestInsert(const ImageInfo *image_info,
+  ExceptionInfo *exception)
+{
+  Image
+    *images,
+    *insert,
+    *p;
+
+  ListInfo
+    list,
+    sublist;
+
+  MagickBooleanType
+    status;
+
+  images=NewImageSequence(image_info,&list,0,100,exception);
+  status=ValidateImageList("insert",images,&list);
+  /*
+    Insert one image, then a list, behind an image in the middle.
+  */
+  p=GetImageFromList(images,40);
+  InsertImageInList(&p,NewListImage(image_info,1000,exception));
+  sublist.scenes[0]=1000;
+  sublist.length=1;
+  InsertScenes(&list,41,&sublist);
+  if (status != MagickFalse)
+    status=ValidateImageList("insert",images,&list);
+  insert=NewImageSequence(image_info,&sublist,2000,50,exception);
+  p=GetImageFromList(images,-1);
+  InsertImageInList(&p,insert);
+  InsertScenes(&list,list.length,&sublist);
+  if (status != MagickFalse)
+    status=ValidateImageList("insert",images,&list);
+  insert=NewImageSequence(image_info,&sublist,3000,40,exception);
+  p=GetImageFromList(images,0);
+  InsertImageInList(&p,insert);
+  InsertScenes(&list,1,&sublist);
+  if (status != MagickFalse)
+    status=ValidateImageList("insert",images,&list);
+  images=DestroyImageList(images);
+  return(status);
+}
+
+static MagickBooleanType TestDelete(const ImageInfo *image_info,
+  ExceptionInfo *exception)
+{
+  Image
+    *images,
+    *p;
+
+  ListInfo
+    list;
+
+  MagickBooleanType
+    status;
+
+  images=NewImageSequence(image_info,&list,0,200,exception);
+  status=ValidateImageList("delete",images,&list);
+  /*
+    Delete from the middle and from either end, then a range of scenes.
+  */
+  p=GetImageFromList(images,100);
+  DeleteImageFromList(&p);
+  DeleteScenes(&list,100,1);
+  if (status != MagickFalse)
+    status=ValidateImageList("delete",p,&list);
+  p=RemoveFirstImageFromList(&images);
+  p=DestroyImage(p);
+  DeleteScenes(&list,0,1);
+  if (status != MagickFalse)
+    status=ValidateImageList("delete",images,&list);
+  p=RemoveLastImageFromList(&images);
+  p=DestroyImage(p);
+  DeleteScenes(&list,list.length-1,1);
+  if (status != MagickFalse)
+    status=ValidateImageList("delete",images,&list);
+  DeleteImages(&images,"10-19",exception);
+  DeleteScenes(&list,10,10);
+  if (status != MagickFalse)
+    status=ValidateImageList("delete",images,&list);
+  /*
+    Drain the list from the head, as DestroyImageList does.
+  */
+  while ((status != MagickFalse) && (list.length > 1))
+  {
+    DeleteImageFromList(&images);
+    DeleteScenes(&list,0,1);
+    status=ValidateImageList("delete",images,&list);
+  }
+  images=DestroyImageList(images);
+  return(status);
+}
+
+static MagickBooleanType TestSplice(const ImageInfo *image_info,
+  ExceptionInfo *exception)
+{
+  Image
+    *images,
+    *p,
+    *splice,
+    *spliced;
+
+  ListInfo
+    list,
+    removed,
+    sublist;
+
+  MagickBooleanType
+    status;
+
+  size_t
+    i;
+
+  images=NewImageSequence(image_info,&list,0,120,exception);
+  status=ValidateImageList("splice",images,&list);
+  /*
+    Replace the five images behind image 30 with ten new ones.
+  */
+  splice=NewImageSequence(image_info,&sublist,1000,10,exception);
+  p=GetImageFromList(images,30);
+  spliced=SpliceImageIntoList(&p,5,splice);
+  removed.length=5;
+  for (i=0; i < removed.length; i++)
+    removed.scenes[i]=list.scenes[31+i];
+  DeleteScenes(&list,31,5);
+  InsertScenes(&list,31,&sublist);
+  if (status != MagickFalse)
+    status=ValidateImageList("splice",images,&list);
+  if (status != MagickFalse)
+    status=ValidateImageList("splice",spliced,&removed);
+  spliced=DestroyImageList(spliced);
+  /*
+    Split the list in two and splice the halves back together.
+  */
+  p=GetImageFromList(images,59);
+  splice=SplitImageList(p);
+  sublist.length=list.length-60;
+  (void) memcpy(sublist.scenes,list.scenes+60,sublist.length*
+    sizeof(*sublist.scenes));
+  list.length=60;
+  if (status != MagickFalse)
+    status=ValidateImageList("splice",images,&list);
+  if (status != MagickFalse)
+    status=ValidateImageList("splice",splice,&sublist);
+  AppendImageToList(&images,splice);
+  InsertScenes(&list,list.length,&sublist);
+  if (status != MagickFalse)
+    status=ValidateImageList("splice",images,&list);
+  images=DestroyImageList(images);
+  return(status);
+}
+
+static MagickBooleanType TestReverse(const ImageInfo *image_info,
+  ExceptionInfo *exception)
+{
+  Image
+    *images,
+    *p;
+
+  ListInfo
+    list;
+
+  MagickBooleanType
+    status;
+
+  size_t
+    i;
+
+  ssize_t
+    scene;
+
+  images=NewImageSequence(image_info,&list,0,150,exception);
+  status=ValidateImageList("reverse",images,&list);
+  ReverseImageList(&images);
+  for (i=0; i < (list.length/2); i++)
+  {
+    scene=list.scenes[i];
+    list.scenes[i]=list.scenes[list.length-i-1];
+    list.scenes[list.length-i-1]=scene;
+  }
+  if (status != MagickFalse)
+    status=ValidateImageList("reverse",images,&list);
+  /*
+    Replace an image in the reversed list, then the head.
+  */
+  p=GetImageFromList(images,75);
+  ReplaceImageInList(&p,NewListImage(image_info,1000,exception));
+  list.scenes[75]=1000;
+  if (status != MagickFalse)
+    status=ValidateImageList("reverse",images,&list);
+  ReplaceImageInList(&images,NewListImage(image_info,2000,exception));
+  list.scenes[0]=2000;
+  if (status != MagickFalse)
+    status=ValidateImageList("reverse",images,&list);
+  images=DestroyImageList(images);
+  return(status);
+}
+
+int main(int argc,char **argv)
+{
+  ExceptionInfo
+    *exception;
+
+  ImageInfo
+    *image_info;
+
+  MagickBooleanType
+    status;
+
+  if (argc != 2)
+    {
+      (void) printf("Usage: %s append|insert|delete|splice|reverse\n",
+        argv[0]);
+      exit(1);
+    }
+  MagickCoreGenesis(*argv,MagickTrue);
+  exception=AcquireExceptionInfo();
+  image_info=AcquireImageInfo();
+  status=MagickFalse;
+  if (LocaleCompare(argv[1],"append") == 0)
+    status=TestAppend(image_info,exception);
+  else if (LocaleCompare(argv[1],"insert") == 0)
+    status=TestInsert(image_info,exception);
+  else if (LocaleCompare(argv[1],"delete") == 0)
+    status=TestDelete(image_info,exception);
+  else if (LocaleCompare(argv[1],"splice") == 0)
+    status=TestSplice(image_info,exception);
+  else if (LocaleCompare(argv[1],"reverse") == 0)
+    status=TestReverse(image_info,exception);
+  else
+    (void) fprintf(stderr,"unknown test: %s\n",argv[1]);
+  image_info=DestroyImageInfo(image_info);
+  exception=DestroyExceptionInfo(exception);
+  MagickCoreTerminus();
+  return(status != MagickFalse ? 0 : 1);
+}
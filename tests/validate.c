@@ -1714,6 +1714,187 @@ static size_t ValidateImportExportPixels(ImageInfo *image_info,
   return(test);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   V a l i d a t e M a g i c D e t e c t i o n                               %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ValidateMagicDetection() validates that image formats are identified by
+%  their magic bytes and returns the number of validation tests that passed
+%  and failed.  When more than one iteration is requested, the detection rate
+%  is also reported.
+%
+%  The format of the ValidateMagicDetection method is:
+%
+%      size_t ValidateMagicDetection(ImageInfo *image_info,
+%        const char *reference_filename,const size_t iterations,
+%        size_t *fails,ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image_info: the image info.
+%
+%    o reference_filename: the reference image filename.
+%
+%    o iterations: the number of benchmark iterations.
+%
+%    o fail: return the number of validation tests that pass.
+%
+%    o exception: return any errors or warnings in this structure.
+%
+*/
+static size_t ValidateMagicDetection(ImageInfo *image_info,
+  const char *reference_filename,const size_t iterations,size_t *fails,
+  ExceptionInfo *exception)
+{
+  static const char
+    *magic_formats[] =
+    {
+      "BMP", "GIF", "JPEG", "MIFF", "PCX", "PNG", "PPM", "PSD", "SGI", "TIFF",
+      "WEBP", (const char *) NULL
+    };
+
+  const char
+    *names[sizeof(magic_formats)/sizeof(*magic_formats)];
+
+  const MagickInfo
+    *magick_info;
+
+  double
+    elapsed_time;
+
+  Image
+    *reference_image;
+
+  MagickBooleanType
+    status;
+
+  size_t
+    fail,
+    lookups,
+    lengths[sizeof(magic_formats)/sizeof(*magic_formats)],
+    number_blobs,
+    test;
+
+  ssize_t
+    i;
+
+  TimerInfo
+    *timer;
+
+  unsigned char
+    *blobs[sizeof(magic_formats)/sizeof(*magic_formats)];
+
+  fail=0;
+  test=0;
+  (void) FormatLocaleFile(stdout,"validate magic detection:\n");
+  (void) CopyMagickString(image_info->filename,reference_filename,
+    MagickPathExtent);
+  reference_image=ReadImage(image_info,exception);
+  if (reference_image == (Image *) NULL)
+    {
+      (void) FormatLocaleFile(stdout,"... fail @ %s/%s/%lu.\n",
+        GetMagickModule());
+      *fails+=1;
+      return(1);
+    }
+  number_blobs=0;
+  for (i=0; magic_formats[i] != (const char *) NULL; i++)
+  {
+    const MagicInfo
+      *magic_info;
+
+    magick_info=GetMagickInfo(magic_formats[i],exception);
+    if ((magick_info == (const MagickInfo *) NULL) ||
+        (magick_info->encoder == (EncodeImageHandler *) NULL))
+      continue;
+    CatchException(exception);
+    (void) FormatLocaleFile(stdout,"  test %.20g: %s",(double) (test++),
+      magic_formats[i]);
+    (void) CopyMagickString(image_info->magick,magic_formats[i],
+      MagickPathExtent);
+    (void) CopyMagickString(reference_image->magick,magic_formats[i],
+      MagickPathExtent);
+    blobs[number_blobs]=(unsigned char *) ImageToBlob(image_info,
+      reference_image,&lengths[number_blobs],exception);
+    if (blobs[number_blobs] == (unsigned char *) NULL)
+      {
+        (void) FormatLocaleFile(stdout,"... fail @ %s/%s/%lu.\n",
+          GetMagickModule());
+        fail++;
+        continue;
+      }
+    magic_info=GetMagicInfo(blobs[number_blobs],lengths[number_blobs],
+      exception);
+    if ((magic_info == (const MagicInfo *) NULL) ||
+        (LocaleCompare(GetMagicName(magic_info),magic_formats[i]) != 0))
+      {
+        (void) FormatLocaleFile(stdout,"... fail @ %s/%s/%lu.\n",
+          GetMagickModule());
+        blobs[number_blobs]=(unsigned char *) RelinquishMagickMemory(
+          blobs[number_blobs]);
+        fail++;
+        continue;
+      }
+    names[number_blobs++]=magic_formats[i];
+    (void) FormatLocaleFile(stdout,"... pass.\n");
+  }
+  reference_image=DestroyImage(reference_image);
+  /*
+    Detect the formats concurrently and confirm the result is stable.
+  */
+  (void) FormatLocaleFile(stdout,"  test %.20g: concurrent detection",
+    (double) (test++));
+  lookups=1000*number_blobs;
+  if (iterations > 1)
+    lookups*=iterations;
+  status=MagickTrue;
+  timer=AcquireTimerInfo();
+#if defined(MAGICKCORE_OPENMP_SUPPORT)
+  #pragma omp parallel for schedule(static) shared(status)
+#endif
+  for (i=0; i < (ssize_t) lookups; i++)
+  {
+    const MagicInfo
+      *magic_info;
+
+    size_t
+      j;
+
+    j=(size_t) i % number_blobs;
+    magic_info=GetMagicInfo(blobs[j],lengths[j],exception);
+    if ((magic_info == (const MagicInfo *) NULL) ||
+        (LocaleCompare(GetMagicName(magic_info),names[j]) != 0))
+      status=MagickFalse;
+  }
+  elapsed_time=GetElapsedTime(timer);
+  timer=DestroyTimerInfo(timer);
+  if (status == MagickFalse)
+    {
+      (void) FormatLocaleFile(stdout,"... fail @ %s/%s/%lu.\n",
+        GetMagickModule());
+      fail++;
+    }
+  else
+    (void) FormatLocaleFile(stdout,"... pass.\n");
+  if ((iterations > 1) && (elapsed_time > 0.0))
+    (void) FormatLocaleFile(stderr,"Magic detection: %.20g lookups %.3f/s\n",
+      (double) lookups,(double) lookups/elapsed_time);
+  for (i=0; i < (ssize_t) number_blobs; i++)
+    blobs[i]=(unsigned char *) RelinquishMagickMemory(blobs[i]);
+  (void) FormatLocaleFile(stdout,
+    "  summary: %.20g subtests; %.20g passed; %.20g failed.\n",(double) test,
+    (double) (test-fail),(double) fail);
+  *fails+=fail;
+  return(test);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -2290,6 +2471,9 @@ int main(int argc,char **argv)
           if ((type & ImportExportValidate) != 0)
             tests+=ValidateImportExportPixels(image_info,reference_filename,
               output_filename,&fail,exception);
+          if ((type & MagicValidate) != 0)
+            tests+=ValidateMagicDetection(image_info,reference_filename,
+              iterations,&fail,exception);
           if ((type & MagickValidate) != 0)
             tests+=ValidateMagickCommand(image_info,reference_filename,
               output_filename,&fail,exception);
@@ -5500,6 +5500,71 @@ int main(int argc,char **argv)
       exit(1);
     }
   profile=(unsigned char *) MagickRelinquishMemory(profile);
+  (void) FormatLocaleFile(stdout,
+    "Excerpt a region, then modify the source and the excerpt...\n");
+  {
+    double
+      distortion;
+
+    ExceptionInfo
+      *exception;
+
+    Image
+      *excerpt,
+      *reference,
+      *source;
+
+    RectangleInfo
+      region;
+
+    exception=AcquireExceptionInfo();
+    source=CloneImage(GetImageFromMagickWand(magick_wand),0,0,MagickTrue,
+      exception);
+    if (source == (Image *) NULL)
+      {
+        CatchException(exception);
+        exit(1);
+      }
+    (void) ResetImagePage(source,"0x0+0+0");
+    region.width=source->columns/2;
+    region.height=source->rows/2;
+    region.x=(ssize_t) source->columns/4;
+    region.y=(ssize_t) source->rows/4;
+    excerpt=ExcerptImage(source,&region,exception);
+    reference=CropImage(source,&region,exception);
+    if ((excerpt == (Image *) NULL) || (reference == (Image *) NULL))
+      {
+        CatchException(exception);
+        exit(1);
+      }
+    (void) NegateImage(source,MagickFalse,exception);
+    (void) GetImageDistortion(excerpt,reference,AbsoluteErrorMetric,
+      &distortion,exception);
+    if (distortion != 0.0)
+      {
+        (void) FormatLocaleFile(stderr,"Excerpt changed with its source\n");
+        exit(1);
+      }
+    (void) NegateImage(excerpt,MagickFalse,exception);
+    reference=DestroyImage(reference);
+    reference=CropImage(source,&region,exception);
+    if (reference == (Image *) NULL)
+      {
+        CatchException(exception);
+        exit(1);
+      }
+    (void) GetImageDistortion(excerpt,reference,AbsoluteErrorMetric,
+      &distortion,exception);
+    if (distortion != 0.0)
+      {
+        (void) FormatLocaleFile(stderr,"Excerpt does not match its source\n");
+        exit(1);
+      }
+    reference=DestroyImage(reference);
+    excerpt=DestroyImage(excerpt);
+    source=DestroyImage(source);
+    exception=DestroyExceptionInfo(exception);
+  }
   magick_wand=DestroyMagickWand(magick_wand);
   (void) FormatLocaleFile(stdout,"Wand tests pass.\n");
   MagickWandTerminus();